@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_encoder.dir/bench/bench_encoder.cpp.o"
+  "CMakeFiles/bench_encoder.dir/bench/bench_encoder.cpp.o.d"
+  "bench_encoder"
+  "bench_encoder.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_encoder.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_framer.dir/bench/bench_framer.cpp.o"
+  "CMakeFiles/bench_framer.dir/bench/bench_framer.cpp.o.d"
+  "bench_framer"
+  "bench_framer.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_framer.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,21 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/host/bench/bench_rx_task.cpp" "CMakeFiles/bench_rx_task.dir/bench/bench_rx_task.cpp.o" "gcc" "CMakeFiles/bench_rx_task.dir/bench/bench_rx_task.cpp.o.d"
+  "/root/repo/host/emulator/ac_emulator.cpp" "CMakeFiles/bench_rx_task.dir/emulator/ac_emulator.cpp.o" "gcc" "CMakeFiles/bench_rx_task.dir/emulator/ac_emulator.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_build_a/CMakeFiles/tcl_ac.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_rx_task.dir/bench/bench_rx_task.cpp.o"
+  "CMakeFiles/bench_rx_task.dir/bench/bench_rx_task.cpp.o.d"
+  "CMakeFiles/bench_rx_task.dir/emulator/ac_emulator.cpp.o"
+  "CMakeFiles/bench_rx_task.dir/emulator/ac_emulator.cpp.o.d"
+  "bench_rx_task"
+  "bench_rx_task.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_rx_task.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,25 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/components/tcl_ac/ac_link.cpp" "CMakeFiles/tcl_ac.dir/root/repo/components/tcl_ac/ac_link.cpp.o" "gcc" "CMakeFiles/tcl_ac.dir/root/repo/components/tcl_ac/ac_link.cpp.o.d"
+  "/root/repo/components/tcl_ac/command_tracker.cpp" "CMakeFiles/tcl_ac.dir/root/repo/components/tcl_ac/command_tracker.cpp.o" "gcc" "CMakeFiles/tcl_ac.dir/root/repo/components/tcl_ac/command_tracker.cpp.o.d"
+  "/root/repo/components/tcl_ac/frame_capture.cpp" "CMakeFiles/tcl_ac.dir/root/repo/components/tcl_ac/frame_capture.cpp.o" "gcc" "CMakeFiles/tcl_ac.dir/root/repo/components/tcl_ac/frame_capture.cpp.o.d"
+  "/root/repo/components/tcl_ac/rx_task.cpp" "CMakeFiles/tcl_ac.dir/root/repo/components/tcl_ac/rx_task.cpp.o" "gcc" "CMakeFiles/tcl_ac.dir/root/repo/components/tcl_ac/rx_task.cpp.o.d"
+  "/root/repo/components/tcl_ac/tcl_ac.cpp" "CMakeFiles/tcl_ac.dir/root/repo/components/tcl_ac/tcl_ac.cpp.o" "gcc" "CMakeFiles/tcl_ac.dir/root/repo/components/tcl_ac/tcl_ac.cpp.o.d"
+  "/root/repo/components/tcl_ac/tcl_ac_codec.cpp" "CMakeFiles/tcl_ac.dir/root/repo/components/tcl_ac/tcl_ac_codec.cpp.o" "gcc" "CMakeFiles/tcl_ac.dir/root/repo/components/tcl_ac/tcl_ac_codec.cpp.o.d"
+  "/root/repo/host/stubs/esphome_host.cpp" "CMakeFiles/tcl_ac.dir/stubs/esphome_host.cpp.o" "gcc" "CMakeFiles/tcl_ac.dir/stubs/esphome_host.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,23 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/tcl_ac.dir/root/repo/components/tcl_ac/ac_link.cpp.o"
+  "CMakeFiles/tcl_ac.dir/root/repo/components/tcl_ac/ac_link.cpp.o.d"
+  "CMakeFiles/tcl_ac.dir/root/repo/components/tcl_ac/command_tracker.cpp.o"
+  "CMakeFiles/tcl_ac.dir/root/repo/components/tcl_ac/command_tracker.cpp.o.d"
+  "CMakeFiles/tcl_ac.dir/root/repo/components/tcl_ac/frame_capture.cpp.o"
+  "CMakeFiles/tcl_ac.dir/root/repo/components/tcl_ac/frame_capture.cpp.o.d"
+  "CMakeFiles/tcl_ac.dir/root/repo/components/tcl_ac/rx_task.cpp.o"
+  "CMakeFiles/tcl_ac.dir/root/repo/components/tcl_ac/rx_task.cpp.o.d"
+  "CMakeFiles/tcl_ac.dir/root/repo/components/tcl_ac/tcl_ac.cpp.o"
+  "CMakeFiles/tcl_ac.dir/root/repo/components/tcl_ac/tcl_ac.cpp.o.d"
+  "CMakeFiles/tcl_ac.dir/root/repo/components/tcl_ac/tcl_ac_codec.cpp.o"
+  "CMakeFiles/tcl_ac.dir/root/repo/components/tcl_ac/tcl_ac_codec.cpp.o.d"
+  "CMakeFiles/tcl_ac.dir/stubs/esphome_host.cpp.o"
+  "CMakeFiles/tcl_ac.dir/stubs/esphome_host.cpp.o.d"
+  "libtcl_ac.a"
+  "libtcl_ac.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/tcl_ac.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
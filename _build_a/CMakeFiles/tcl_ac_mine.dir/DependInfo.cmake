@@ -0,0 +1,21 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/host/tools/capture_reader.cpp" "CMakeFiles/tcl_ac_mine.dir/tools/capture_reader.cpp.o" "gcc" "CMakeFiles/tcl_ac_mine.dir/tools/capture_reader.cpp.o.d"
+  "/root/repo/host/tools/mine.cpp" "CMakeFiles/tcl_ac_mine.dir/tools/mine.cpp.o" "gcc" "CMakeFiles/tcl_ac_mine.dir/tools/mine.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_build_a/CMakeFiles/tcl_ac.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
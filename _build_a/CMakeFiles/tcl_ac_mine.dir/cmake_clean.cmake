@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/tcl_ac_mine.dir/tools/capture_reader.cpp.o"
+  "CMakeFiles/tcl_ac_mine.dir/tools/capture_reader.cpp.o.d"
+  "CMakeFiles/tcl_ac_mine.dir/tools/mine.cpp.o"
+  "CMakeFiles/tcl_ac_mine.dir/tools/mine.cpp.o.d"
+  "tcl_ac_mine"
+  "tcl_ac_mine.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/tcl_ac_mine.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
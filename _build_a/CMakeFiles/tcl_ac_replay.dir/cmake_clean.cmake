@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/tcl_ac_replay.dir/tools/capture_reader.cpp.o"
+  "CMakeFiles/tcl_ac_replay.dir/tools/capture_reader.cpp.o.d"
+  "CMakeFiles/tcl_ac_replay.dir/tools/replay.cpp.o"
+  "CMakeFiles/tcl_ac_replay.dir/tools/replay.cpp.o.d"
+  "tcl_ac_replay"
+  "tcl_ac_replay.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/tcl_ac_replay.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,15 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_status.dir/bench/bench_status.cpp.o"
+  "CMakeFiles/bench_status.dir/bench/bench_status.cpp.o.d"
+  "CMakeFiles/bench_status.dir/emulator/ac_emulator.cpp.o"
+  "CMakeFiles/bench_status.dir/emulator/ac_emulator.cpp.o.d"
+  "CMakeFiles/bench_status.dir/emulator/loopback_uart.cpp.o"
+  "CMakeFiles/bench_status.dir/emulator/loopback_uart.cpp.o.d"
+  "bench_status"
+  "bench_status.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_status.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,3 @@
+file(REMOVE_RECURSE
+  "libtcl_ac.a"
+)
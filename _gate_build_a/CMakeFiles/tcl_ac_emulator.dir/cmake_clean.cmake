@@ -0,0 +1,15 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/tcl_ac_emulator.dir/emulator/ac_emulator.cpp.o"
+  "CMakeFiles/tcl_ac_emulator.dir/emulator/ac_emulator.cpp.o.d"
+  "CMakeFiles/tcl_ac_emulator.dir/emulator/loopback_uart.cpp.o"
+  "CMakeFiles/tcl_ac_emulator.dir/emulator/loopback_uart.cpp.o.d"
+  "CMakeFiles/tcl_ac_emulator.dir/emulator/main.cpp.o"
+  "CMakeFiles/tcl_ac_emulator.dir/emulator/main.cpp.o.d"
+  "tcl_ac_emulator"
+  "tcl_ac_emulator.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/tcl_ac_emulator.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -13,7 +13,25 @@ tcl_ac_ns = cg.esphome_ns.namespace("tcl_ac")
 TclAcClimate = tcl_ac_ns.class_("TclAcClimate", climate.Climate, cg.Component, uart.UARTDevice)
 
 # Configuration keys (exported for climate.py)
+CONF_MODEL = "model"
 CONF_BEEPER = "beeper"
 CONF_DISPLAY = "display"
 CONF_VERTICAL_DIRECTION = "vertical_direction"
 CONF_HORIZONTAL_DIRECTION = "horizontal_direction"
+CONF_COALESCE_WINDOW = "coalesce_window"
+CONF_FORCE_MODE = "force_mode"
+CONF_TEMPERATURE_DEADBAND = "temperature_deadband"
+CONF_MIN_PUBLISH_INTERVAL = "min_publish_interval"
+CONF_POLL_INTERVAL = "poll_interval"
+CONF_IDLE_POLL_INTERVAL = "idle_poll_interval"
+CONF_FAST_POLL_INTERVAL = "fast_poll_interval"
+CONF_FAST_POLL_COUNT = "fast_poll_count"
+CONF_COMMAND_TIMEOUT = "command_timeout"
+CONF_COMMAND_RETRIES = "command_retries"
+CONF_RX_BUDGET_BYTES = "rx_budget_bytes"
+CONF_RX_BUDGET_TIME = "rx_budget_time"
+CONF_RX_TASK = "rx_task"
+CONF_RX_TASK_CORE = "rx_task_core"
+CONF_IDLE_CHECK_INTERVAL = "idle_check_interval"
+CONF_CAPTURE_FRAMES = "capture_frames"
+CONF_CHECK_FRAME_LENGTHS = "check_frame_lengths"
@@ -0,0 +1,304 @@
+#include "ac_link.h"
+#include "tcl_ac_codec.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace esphome {
+namespace tcl_ac {
+
+static const char *const TAG = "tcl_ac";
+
+void AcLink::loop() {
+  this->receive_();
+  this->schedule_poll_();
+  this->transmit_();
+}
+
+void AcLink::schedule_poll_() {
+  uint32_t now = this->transport_->now_ms();
+  
+  // Waiting for the AC to confirm a SET
+  if (this->fast_polls_left_ > 0) {
+    if ((int32_t) (now - this->next_fast_poll_) < 0)
+      return;
+    if (this->send_poll()) {
+      this->polls_sent_++;
+      this->last_poll_ = now;
+    }
+    this->fast_polls_left_--;
+    this->next_fast_poll_ = now + this->fast_poll_interval_;
+    return;
+  }
+  
+  if (now - this->last_poll_ < this->current_poll_interval_)
+    return;
+  this->last_poll_ = now;
+  
+  // The AC pushes status about every 1.3 s on its own; poll only when it has not
+  if (this->has_status_ && now - this->last_status_ < this->poll_interval_) {
+    this->polls_suppressed_++;
+    ESP_LOGV(TAG, "Poll suppressed, status is %u ms old", (unsigned) (now - this->last_status_));
+    return;
+  }
+  if (this->send_poll())
+    this->polls_sent_++;
+  
+  // Back off until the next poll reports a change
+  this->current_poll_interval_ = std::min(this->current_poll_interval_ * 2, this->idle_poll_interval_);
+  this->current_poll_interval_ = std::max(this->current_poll_interval_, this->poll_interval_);
+}
+
+uint32_t AcLink::idle_for(uint32_t now_ms) {
+  if (this->tx_count_ > 0)
+    return 0;
+#ifdef TCL_AC_RX_TASK
+  if (!this->rx_task_.queue().empty())
+    return 0;
+  bool task = this->rx_task_.running();
+#else
+  bool task = false;
+#endif
+  // The task has the UART and the framer while it runs
+  if (!task && (this->reader_.pending() > 0 || this->transport_->rx_available() > 0))
+    return 0;
+  
+  uint32_t due = this->fast_polls_left_ > 0 ? this->next_fast_poll_ : this->last_poll_ + this->current_poll_interval_;
+  return (int32_t) (due - now_ms) > 0 ? due - now_ms : 0;
+}
+
+void AcLink::on_status_(const Frame &frame) {
+  this->last_status_ = this->transport_->now_ms();
+  this->has_status_ = true;
+  this->fast_polls_left_ = 0;  // A SET is confirmed by the next status after it
+  
+  size_t length = std::min<size_t>(frame.length, STATUS_DATA_SIZE);
+  if (memcmp(this->status_, frame.payload, length) != 0) {
+    memcpy(this->status_, frame.payload, length);
+    this->current_poll_interval_ = this->poll_interval_;
+  }
+}
+
+void AcLink::note_status() {
+  this->last_status_ = this->transport_->now_ms();
+  this->has_status_ = true;
+}
+
+void AcLink::receive_() {
+#ifdef TCL_AC_RX_TASK
+  // Until the queue is empty as well: frames queued before the task stopped
+  if (this->rx_task_.running() || !this->rx_task_.queue().empty()) {
+    this->receive_queued_();
+    return;
+  }
+#endif
+  uint32_t start = this->transport_->now_us();
+  // Frames a previous call had no budget left for go first
+  if (!this->dispatch_frames_(start)) {
+    this->rx_budget_hits_++;
+    return;
+  }
+  
+  // Read incoming UART data: as much as the framer has room for per call,
+  // so a burst of frames costs one UART read and one framing pass. What is
+  // over the byte budget stays in the UART buffer for the next loop().
+  size_t budget = this->rx_budget_bytes_ != 0 ? this->rx_budget_bytes_ : SIZE_MAX;
+  bool received = false;
+  size_t available;
+  while ((available = this->transport_->rx_available()) > 0) {
+    if (budget == 0) {
+      this->rx_budget_hits_++;
+      break;
+    }
+    uint8_t *window;
+    size_t room = this->reader_.write_window(&window);
+    if (room == 0) {
+      this->reader_.abandon();  // Unreachable: a full buffer always holds a complete frame
+      continue;
+    }
+    size_t length = std::min({available, room, budget});
+    if (!this->transport_->rx_read_array(window, length))
+      break;
+    this->reader_.commit(length);
+    budget -= length;
+    received = true;
+    if (!this->dispatch_frames_(start)) {
+      this->rx_budget_hits_++;
+      break;
+    }
+  }
+  
+  int32_t warning = this->reader_.take_length_warning();
+  if (warning >= 0)
+    this->warn_length_(warning);
+  
+  uint32_t now = this->transport_->now_us();
+  if (received) {
+    this->last_rx_us_ = now;
+    return;
+  }
+  if (this->reader_.pending() == 0 || this->rx_gap_timeout_ == 0 || now - this->last_rx_us_ < this->rx_gap_timeout_)
+    return;
+  
+  // The line went quiet mid-frame. Every candidate still pending is as
+  // stale as the first, so keep abandoning until the framer is empty.
+  this->rx_gap_timeouts_++;
+  ESP_LOGV(TAG, "Incomplete frame after %u us of silence, resyncing (%u pending bytes)",
+           (unsigned) (now - this->last_rx_us_), (unsigned) this->reader_.pending());
+  while (this->reader_.pending() > 0) {
+    this->reader_.abandon();
+    if (!this->dispatch_frames_(start)) {
+      this->rx_budget_hits_++;
+      return;
+    }
+  }
+}
+
+void AcLink::warn_length_(int32_t warning) {
+  uint8_t command = warning & 0xFF;
+  PayloadLength expected = expected_payload_length(true, command);
+  ESP_LOGW(TAG, "Most 0x%02X frames announce %u data bytes where %u-%u are expected and are dropped; if this unit "
+           "sends them that way, set check_frame_lengths: false", command, (unsigned) (warning >> 8),
+           expected.min, expected.max);
+}
+
+bool AcLink::dispatch_frames_(uint32_t start_us) {
+  Frame frame;
+  while (this->reader_.next(&frame)) {
+    this->dispatch_frame_(frame);
+    // At least one frame per call, so a slow handler cannot stall the link
+    if (this->rx_budget_us_ != 0 && this->transport_->now_us() - start_us >= this->rx_budget_us_)
+      return false;
+  }
+  return true;
+}
+
+void AcLink::dispatch_frame_(const Frame &frame) {
+  if (this->capture_.enabled())
+    this->capture_.record(frame.checksum_ok() ? CAPTURE_CHECKSUM_OK : 0, frame.raw, frame.size(), this->transport_->now_us());
+  if (frame.checksum_ok() && (frame.command == CMD_SET_PARAMS || frame.command == CMD_POLL ||
+                              frame.command == CMD_STATUS_ECHO))
+    this->on_status_(frame);
+  if (this->frame_callback_)
+    this->frame_callback_(frame);
+}
+
+#ifdef TCL_AC_RX_TASK
+bool AcLink::start_rx_task(uint8_t core) {
+  return this->rx_task_.start(this->transport_, &this->reader_, this->rx_gap_timeout_, core);
+}
+
+void AcLink::receive_queued_() {
+  // The task does not log; report what it dropped since the last call. Bad
+  // checksums are queued and reported as they are handled.
+  int32_t warning = this->rx_task_.take_length_warning();
+  if (warning >= 0)
+    this->warn_length_(warning);
+  uint32_t overflows = this->rx_task_.get_overflows();
+  if (overflows != this->rx_task_overflows_) {
+    ESP_LOGW(TAG, "RX queue full, %u frame(s) lost", (unsigned) (overflows - this->rx_task_overflows_));
+    this->rx_task_overflows_ = overflows;
+  }
+  
+  uint32_t start = this->transport_->now_us();
+  size_t bytes = 0;
+  Frame frame;
+  while (this->rx_task_.queue().front(&frame)) {
+    // At least one frame per call, as in dispatch_frames_()
+    if (bytes > 0 && ((this->rx_budget_bytes_ != 0 && bytes >= this->rx_budget_bytes_) ||
+                      (this->rx_budget_us_ != 0 && this->transport_->now_us() - start >= this->rx_budget_us_))) {
+      this->rx_budget_hits_++;
+      return;
+    }
+    this->dispatch_frame_(frame);
+    bytes += frame.size();
+    this->rx_task_.queue().pop();
+  }
+}
+#endif
+
+bool AcLink::send(const uint8_t *packet, size_t length) {
+  if (length > SET_PACKET_SIZE) {
+    ESP_LOGW(TAG, "Packet too long for transmit queue: %u bytes", (unsigned) length);
+    return false;
+  }
+  
+  TxFrame *slot;
+  if (this->tx_count_ < TX_QUEUE_SIZE) {
+    slot = &this->tx_queue_[(this->tx_head_ + this->tx_count_) % TX_QUEUE_SIZE];
+    this->tx_count_++;
+  } else {
+    // Queue full. A SET carries the complete state, so a newer one may replace
+    // a queued SET that has not started on the wire; anything else is dropped.
+    slot = &this->tx_queue_[(this->tx_head_ + this->tx_count_ - 1) % TX_QUEUE_SIZE];
+    if (slot->written != 0 || slot->data[3] != CMD_SET_PARAMS || packet[3] != CMD_SET_PARAMS) {
+      this->tx_dropped_++;
+      ESP_LOGW(TAG, "Transmit queue full, dropping packet (cmd 0x%02X)", packet[3]);
+      return false;
+    }
+    ESP_LOGD(TAG, "Transmit queue full, replacing queued SET packet");
+  }
+  
+  ESP_LOGV(TAG, "Queueing packet: %s", format_hex_pretty(packet, length).c_str());
+  
+  memcpy(slot->data, packet, length);
+  slot->length = length;
+  slot->written = 0;
+  
+  // Start right away if the line has room, without waiting for the next loop()
+  this->transmit_();
+  return true;
+}
+
+void AcLink::transmit_() {
+  if (this->tx_count_ == 0)
+    return;
+  
+  // Bytes still in the UART FIFO, from the time the line needs to send them
+  uint32_t now = this->transport_->now_us();
+  size_t in_flight = 0;
+  if ((int32_t) (this->tx_busy_until_us_ - now) > 0) {
+    in_flight = (this->tx_busy_until_us_ - now + UART_BYTE_TIME_US - 1) / UART_BYTE_TIME_US;
+  } else {
+    this->tx_busy_until_us_ = now;
+  }
+  size_t room = in_flight < UART_TX_FIFO_SIZE ? UART_TX_FIFO_SIZE - in_flight : 0;
+  
+  while (this->tx_count_ > 0 && room > 0) {
+    TxFrame &frame = this->tx_queue_[this->tx_head_];
+    size_t n = std::min<size_t>(room, frame.length - frame.written);
+    this->transport_->tx_write(frame.data + frame.written, n);
+    frame.written += n;
+    room -= n;
+    this->tx_busy_until_us_ += n * UART_BYTE_TIME_US;
+    if (frame.written < frame.length)
+      break;
+    
+    uint32_t done = this->transport_->now_ms() + (this->tx_busy_until_us_ - now) / 1000;
+    if (this->capture_.enabled())
+      this->capture_.record(CAPTURE_TX | CAPTURE_CHECKSUM_OK, frame.data, frame.length, this->tx_busy_until_us_);
+    this->last_transmit_ = done;
+    if (frame.data[3] == CMD_SET_PARAMS) {
+      // New state: poll fast until the AC reports it, then start over from the base interval
+      this->fast_polls_left_ = this->fast_poll_count_;
+      this->next_fast_poll_ = done + this->fast_poll_interval_;
+      this->current_poll_interval_ = this->poll_interval_;
+    }
+    if (this->sent_callback_)
+      this->sent_callback_(frame.data[3], done);
+    this->tx_head_ = (this->tx_head_ + 1) % TX_QUEUE_SIZE;
+    this->tx_count_--;
+  }
+}
+
+bool AcLink::send_poll() {
+  uint8_t packet[POLL_PACKET_SIZE];
+  encode_poll_packet(packet);
+  ESP_LOGV(TAG, "Queueing POLL packet");
+  return this->send(packet, POLL_PACKET_SIZE);
+}
+
+}  // namespace tcl_ac
+}  // namespace esphome
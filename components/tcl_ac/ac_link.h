@@ -0,0 +1,202 @@
+#pragma once
+
+#include <functional>
+
+#include "frame_capture.h"
+#include "frame_reader.h"
+#include "rx_task.h"
+#include "tcl_ac_protocol.h"
+
+namespace esphome {
+namespace tcl_ac {
+
+// The UART bus and clock the protocol link runs on. TclAcClimate binds this
+// to its ESPHome UART device; host tools bind it to an emulator or a capture.
+class AcTransport {
+ public:
+  virtual ~AcTransport() = default;
+  virtual size_t rx_available() = 0;
+  // Exactly `length` bytes, at most rx_available()
+  virtual bool rx_read_array(uint8_t *data, size_t length) = 0;
+  // Must not block for up to UART_TX_FIFO_SIZE bytes once the line is idle
+  virtual void tx_write(const uint8_t *data, size_t length) = 0;
+  virtual uint32_t now_ms() = 0;
+  virtual uint32_t now_us() = 0;
+};
+
+// Protocol link to the AC: receive framing, packet transmission and poll
+// scheduling. Knows nothing about climate state.
+//
+// Polls are only sent when the AC has not reported its status on its own.
+// Status frames (0x03/0x04/0x06) arriving within the poll interval make the
+// next poll unnecessary, so it is counted as suppressed instead. Without
+// unsolicited traffic, every poll that returns an unchanged status doubles
+// the interval up to the idle interval. A SET resets the interval and starts
+// a fast-poll burst that ends as soon as the AC reports status after it.
+//
+// Transmission never waits on the line. Frames go into a small queue and are
+// written to the UART only as far as the hardware FIFO has room, judged from
+// the 9600 8E1 byte time, so write_array() never blocks and flush() is never
+// needed. Each frame's completion (last stop bit on the wire) is reported
+// through the sent callback.
+//
+// Frames of a known command announcing a length outside the table are
+// dropped at their header. When that keeps happening to a command, it is
+// logged once: the unit likely sends it with another length.
+//
+// A frame still incomplete after RX_GAP_TIMEOUT_US without a received byte
+// is abandoned and the framer resyncs at the next header, so a corrupted
+// length byte costs milliseconds instead of holding up the frames behind it.
+//
+// Receiving is bounded per loop() by a byte and a time budget. Bytes over
+// the budget wait in the UART buffer, frames already framed wait in the
+// framer; both are taken up first on the next call.
+//
+// With a capture allocated, every frame loop() handles and every frame it
+// sends is also recorded there, bad checksums included.
+//
+// With TCL_AC_RX_TASK, start_rx_task() moves reading and framing to an
+// RxTask; loop() then takes the frames off its queue, within the same
+// budgets, and handles them as if it had framed them itself.
+class AcLink {
+ public:
+  explicit AcLink(AcTransport *transport) : transport_(transport) {}
+
+  void set_frame_callback(std::function<void(const Frame &)> &&callback) { this->frame_callback_ = std::move(callback); }
+  void set_poll_interval(uint32_t interval_ms) {
+    this->poll_interval_ = interval_ms;
+    this->current_poll_interval_ = interval_ms;
+  }
+  void set_idle_poll_interval(uint32_t interval_ms) { this->idle_poll_interval_ = interval_ms; }
+  void set_fast_poll_interval(uint32_t interval_ms) { this->fast_poll_interval_ = interval_ms; }
+  void set_fast_poll_count(uint8_t count) { this->fast_poll_count_ = count; }
+  // 0 = wait for incomplete frames indefinitely
+  void set_rx_gap_timeout(uint32_t timeout_us) { this->rx_gap_timeout_ = timeout_us; }
+  // Off: frames of known commands may announce any length (units whose
+  // frames differ from the table in frame_reader.h). Call before start_rx_task().
+  void set_check_lengths(bool check) { this->reader_.set_check_lengths(check); }
+  // Most bytes read and longest time spent handling frames per loop(); 0 = no limit
+  void set_rx_budget_bytes(size_t bytes) { this->rx_budget_bytes_ = bytes; }
+  void set_rx_budget_time(uint32_t time_us) { this->rx_budget_us_ = time_us; }
+  // Called when the last byte of a frame is handed to the UART, with the
+  // command and the time (ms) that byte will have left the wire
+  void set_sent_callback(std::function<void(uint8_t, uint32_t)> &&callback) { this->sent_callback_ = std::move(callback); }
+
+  // Drain received bytes through the framer, queue a poll when one is due and
+  // move queued frames into the UART FIFO. Call once per component loop().
+  // Received bytes are read in bulk, straight into the framer's buffer.
+  void loop();
+
+  // Queue a frame for transmission. Returns false if it had to be dropped.
+  bool send(const uint8_t *packet, size_t length);
+  bool send_poll();
+  bool tx_idle() const { return this->tx_count_ == 0; }
+  // How long loop() has nothing to do: 0 while bytes are waiting, a frame is
+  // half received or a frame is being sent, otherwise until the next poll
+  uint32_t idle_for(uint32_t now_ms);
+  // Status received in a frame the link does not decode itself (a trusted
+  // short status): makes the next poll unnecessary like a status frame does
+  void note_status();
+
+  uint32_t get_poll_interval() const { return this->poll_interval_; }
+  bool get_check_lengths() const { return this->reader_.get_check_lengths(); }
+  uint32_t get_idle_poll_interval() const { return this->idle_poll_interval_; }
+  uint32_t get_fast_poll_interval() const { return this->fast_poll_interval_; }
+  uint8_t get_fast_poll_count() const { return this->fast_poll_count_; }
+  uint32_t get_polls_sent() const { return this->polls_sent_; }
+  uint32_t get_polls_suppressed() const { return this->polls_suppressed_; }
+  uint32_t get_last_transmit() const { return this->last_transmit_; }
+  uint32_t get_tx_dropped() const { return this->tx_dropped_; }
+  uint32_t get_rx_gap_timeouts() const {
+#ifdef TCL_AC_RX_TASK
+    return this->rx_gap_timeouts_ + this->rx_task_.get_gap_timeouts();
+#else
+    return this->rx_gap_timeouts_;
+#endif
+  }
+  size_t get_rx_budget_bytes() const { return this->rx_budget_bytes_; }
+  uint32_t get_rx_budget_time() const { return this->rx_budget_us_; }
+  // loop() calls that left received data for the next one
+  uint32_t get_rx_budget_hits() const { return this->rx_budget_hits_; }
+  const FrameReader<RX_BUFFER_SIZE> &get_reader() const { return this->reader_; }
+  // Raw frames in both directions; off until init() allocates it
+  FrameCapture &get_capture() { return this->capture_; }
+
+  bool rx_task_running() const {
+#ifdef TCL_AC_RX_TASK
+    return this->rx_task_.running();
+#else
+    return false;
+#endif
+  }
+#ifdef TCL_AC_RX_TASK
+  // Call after the framer settings. False if the task could not be created;
+  // loop() keeps receiving itself then.
+  bool start_rx_task(uint8_t core);
+  void stop_rx_task() { this->rx_task_.stop(); }
+  // Called from the RX task whenever it has queued frames
+  void set_rx_task_wake_callback(std::function<void()> &&callback) { this->rx_task_.set_wake_callback(std::move(callback)); }
+  const RxTask &get_rx_task() const { return this->rx_task_; }
+#endif
+
+ protected:
+  struct TxFrame {
+    uint8_t data[SET_PACKET_SIZE];
+    uint8_t length;
+    uint8_t written;  // Bytes already handed to the UART
+  };
+
+  void receive_();
+  bool dispatch_frames_(uint32_t start_us);
+  void dispatch_frame_(const Frame &frame);
+  // FrameReader::take_length_warning() result
+  void warn_length_(int32_t warning);
+  void transmit_();
+  void schedule_poll_();
+  void on_status_(const Frame &frame);
+
+  AcTransport *transport_;
+  FrameReader<RX_BUFFER_SIZE> reader_;
+  FrameCapture capture_;
+  std::function<void(const Frame &)> frame_callback_;
+  std::function<void(uint8_t, uint32_t)> sent_callback_;
+  uint32_t rx_gap_timeout_{RX_GAP_TIMEOUT_US};
+  uint32_t last_rx_us_{0};  // When bytes were last read
+  uint32_t rx_gap_timeouts_{0};
+  size_t rx_budget_bytes_{256};   // One ESPHome UART receive buffer
+  uint32_t rx_budget_us_{10000};
+  uint32_t rx_budget_hits_{0};
+#ifdef TCL_AC_RX_TASK
+  void receive_queued_();
+  RxTask rx_task_;
+  uint32_t rx_task_overflows_{0};  // Task counter already reported
+#endif
+
+  // Transmit queue (ring of whole frames)
+  TxFrame tx_queue_[TX_QUEUE_SIZE];
+  size_t tx_head_{0};
+  size_t tx_count_{0};
+  uint32_t tx_busy_until_us_{0};  // When the last byte handed to the UART leaves the wire
+  uint32_t tx_dropped_{0};
+
+  // Timing
+  uint32_t last_transmit_{0};  // Completion time of the last frame sent
+  
+  // Poll scheduling
+  uint32_t poll_interval_{5000};        // Base interval, and how long a status counts as fresh
+  uint32_t idle_poll_interval_{60000};  // Backoff ceiling while nothing changes
+  uint32_t fast_poll_interval_{250};    // Poll spacing while waiting for a SET to be confirmed
+  uint8_t fast_poll_count_{4};
+  uint32_t current_poll_interval_{5000};
+  uint32_t last_poll_{0};
+  uint32_t last_status_{0};
+  bool has_status_{false};
+  uint8_t fast_polls_left_{0};
+  uint32_t next_fast_poll_{0};
+  uint8_t status_[STATUS_DATA_SIZE]{};  // Last status payload, to tell an idle unit from a changing one
+  uint32_t polls_sent_{0};
+  uint32_t polls_suppressed_{0};
+};
+
+}  // namespace tcl_ac
+}  // namespace esphome
@@ -4,17 +4,79 @@ import esphome.codegen as cg
 import esphome.config_validation as cv
 from esphome.components import climate, uart
 from esphome.const import CONF_ID
+from esphome.core import CORE
 
 CODEOWNERS = ["@Kannix2005"]
 DEPENDENCIES = ["uart"]
 
 # Import from parent component
-from . import tcl_ac_ns, TclAcClimate, CONF_BEEPER, CONF_DISPLAY, CONF_VERTICAL_DIRECTION, CONF_HORIZONTAL_DIRECTION
+from . import (
+    tcl_ac_ns,
+    TclAcClimate,
+    CONF_MODEL,
+    CONF_BEEPER,
+    CONF_DISPLAY,
+    CONF_VERTICAL_DIRECTION,
+    CONF_HORIZONTAL_DIRECTION,
+    CONF_COALESCE_WINDOW,
+    CONF_FORCE_MODE,
+    CONF_TEMPERATURE_DEADBAND,
+    CONF_MIN_PUBLISH_INTERVAL,
+    CONF_POLL_INTERVAL,
+    CONF_IDLE_POLL_INTERVAL,
+    CONF_FAST_POLL_INTERVAL,
+    CONF_FAST_POLL_COUNT,
+    CONF_COMMAND_TIMEOUT,
+    CONF_COMMAND_RETRIES,
+    CONF_RX_BUDGET_BYTES,
+    CONF_RX_BUDGET_TIME,
+    CONF_RX_TASK,
+    CONF_RX_TASK_CORE,
+    CONF_IDLE_CHECK_INTERVAL,
+    CONF_CAPTURE_FRAMES,
+    CONF_CHECK_FRAME_LENGTHS,
+)
+
+
+def _validate_rx_task(config):
+    if not config[CONF_RX_TASK]:
+        return config
+    if not CORE.is_esp32:
+        raise cv.Invalid(f"{CONF_RX_TASK} needs an ESP32 (FreeRTOS)")
+    from esphome.components.esp32 import get_esp32_variant
+    from esphome.components.esp32.const import (
+        VARIANT_ESP32C2,
+        VARIANT_ESP32C3,
+        VARIANT_ESP32C6,
+        VARIANT_ESP32H2,
+        VARIANT_ESP32S2,
+    )
+
+    single_core = (VARIANT_ESP32C2, VARIANT_ESP32C3, VARIANT_ESP32C6, VARIANT_ESP32H2, VARIANT_ESP32S2)
+    if config[CONF_RX_TASK_CORE] != 0 and get_esp32_variant() in single_core:
+        raise cv.Invalid(f"{CONF_RX_TASK_CORE} must be 0 on a single-core {get_esp32_variant()}")
+    return config
+
+
+# Most capture_frames per platform, 72 bytes of RAM each. The Arduino web
+# servers buffer a whole download besides, ESP-IDF sends it in chunks.
+def _validate_capture_frames(config):
+    if CORE.is_esp32:
+        limit = 1024 if CORE.using_esp_idf else 512
+    elif CORE.is_esp8266:
+        limit = 128
+    else:
+        limit = 256
+    if config[CONF_CAPTURE_FRAMES] > limit:
+        raise cv.Invalid(f"{CONF_CAPTURE_FRAMES} is at most {limit} on this platform")
+    return config
+
 
 # Climate platform schema
-CONFIG_SCHEMA = climate._CLIMATE_SCHEMA.extend(
+CONFIG_SCHEMA = cv.All(climate._CLIMATE_SCHEMA.extend(
     {
         cv.GenerateID(): cv.declare_id(TclAcClimate),
+        cv.Optional(CONF_MODEL, default="B"): cv.one_of("A", "B", upper=True),
         cv.Optional(CONF_BEEPER, default=True): cv.boolean,
         cv.Optional(CONF_DISPLAY, default=False): cv.boolean,
         cv.Optional(CONF_VERTICAL_DIRECTION, default="max_down"): cv.one_of(
@@ -23,8 +85,25 @@ CONFIG_SCHEMA = climate._CLIMATE_SCHEMA.extend(
         cv.Optional(CONF_HORIZONTAL_DIRECTION, default="max_right"): cv.one_of(
             "max_left", "left", "center", "right", "max_right", "swing", lower=True
         ),
+        cv.Optional(CONF_COALESCE_WINDOW, default="50ms"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_FORCE_MODE, default=False): cv.boolean,
+        cv.Optional(CONF_TEMPERATURE_DEADBAND, default=0.2): cv.positive_float,
+        cv.Optional(CONF_MIN_PUBLISH_INTERVAL, default="1s"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_POLL_INTERVAL, default="5s"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_IDLE_POLL_INTERVAL, default="60s"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_FAST_POLL_INTERVAL, default="250ms"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_FAST_POLL_COUNT, default=4): cv.int_range(min=0, max=20),
+        cv.Optional(CONF_COMMAND_TIMEOUT, default="1s"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_COMMAND_RETRIES, default=3): cv.int_range(min=0, max=8),
+        cv.Optional(CONF_RX_BUDGET_BYTES, default=256): cv.int_range(min=0, max=4096),
+        cv.Optional(CONF_RX_BUDGET_TIME, default="10ms"): cv.positive_time_period_microseconds,
+        cv.Optional(CONF_RX_TASK, default=False): cv.boolean,
+        cv.Optional(CONF_RX_TASK_CORE, default=0): cv.int_range(min=0, max=1),
+        cv.Optional(CONF_IDLE_CHECK_INTERVAL, default="100ms"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_CAPTURE_FRAMES, default=0): cv.int_range(min=0, max=1024),
+        cv.Optional(CONF_CHECK_FRAME_LENGTHS, default=True): cv.boolean,
     }
-).extend(cv.COMPONENT_SCHEMA).extend(uart.UART_DEVICE_SCHEMA)
+).extend(cv.COMPONENT_SCHEMA).extend(uart.UART_DEVICE_SCHEMA), _validate_rx_task, _validate_capture_frames)
 
 
 async def to_code(config):
@@ -34,6 +113,11 @@ async def to_code(config):
     await climate.register_climate(var, config)
     await uart.register_uart_device(var, config)
 
+    # Protocol variant (PROTOCOL.md): only the selected profile's encoder
+    # is compiled into the firmware
+    if config[CONF_MODEL] == "A":
+        cg.add_build_flag("-DTCL_AC_MODEL_A")
+
     # Set configuration options
     cg.add(var.set_beeper_enabled(config[CONF_BEEPER]))
     cg.add(var.set_display_enabled(config[CONF_DISPLAY]))
@@ -59,3 +143,49 @@ async def to_code(config):
         "swing": 255,
     }
     cg.add(var.set_horizontal_direction(horizontal_map[config[CONF_HORIZONTAL_DIRECTION]]))
+
+    # Changes arriving within this window are sent as a single SET packet
+    cg.add(var.set_coalesce_window(config[CONF_COALESCE_WINDOW]))
+
+    # A SET equal to the last one the AC confirmed is skipped unless forced
+    cg.add(var.set_force_mode(config[CONF_FORCE_MODE]))
+
+    # AC reports are published only when they change the state (room
+    # temperature by at least the deadband), and at most once per interval
+    cg.add(var.set_temperature_deadband(config[CONF_TEMPERATURE_DEADBAND]))
+    cg.add(var.set_min_publish_interval(config[CONF_MIN_PUBLISH_INTERVAL]))
+
+    # Polling: skipped while the AC reports on its own, backs off while idle,
+    # and runs fast after a command until the AC confirms it
+    cg.add(var.set_poll_interval(config[CONF_POLL_INTERVAL]))
+    cg.add(var.set_idle_poll_interval(config[CONF_IDLE_POLL_INTERVAL]))
+    cg.add(var.set_fast_poll_interval(config[CONF_FAST_POLL_INTERVAL]))
+    cg.add(var.set_fast_poll_count(config[CONF_FAST_POLL_COUNT]))
+
+    # A SET not confirmed by a status frame within the timeout is sent again,
+    # with the timeout doubling each time
+    cg.add(var.set_command_timeout(config[CONF_COMMAND_TIMEOUT]))
+    cg.add(var.set_command_retries(config[CONF_COMMAND_RETRIES]))
+
+    # Receive work per loop() (0 = unlimited); the rest waits for the next one
+    cg.add(var.set_rx_budget_bytes(config[CONF_RX_BUDGET_BYTES]))
+    cg.add(var.set_rx_budget_time(config[CONF_RX_BUDGET_TIME]))
+
+    # Idle: loop() disabled between deadlines, waking at least this often to
+    # read the UART (0 = every main loop pass)
+    cg.add(var.set_idle_check_interval(config[CONF_IDLE_CHECK_INTERVAL]))
+
+    # Debugging: the last N frames in both directions, 72 bytes each, kept in
+    # RAM instead of logged (0 = off)
+    cg.add(var.set_capture_size(config[CONF_CAPTURE_FRAMES]))
+
+    # Frames of known commands announcing a length outside the documented
+    # range are dropped at their header; off for units that send other sizes
+    cg.add(var.set_check_frame_lengths(config[CONF_CHECK_FRAME_LENGTHS]))
+
+    # ESP32: UART reading, framing and checksums on a task of their own,
+    # handing the frames to loop() through a lock-free queue. Core 0
+    # keeps it off the core the ESPHome loop runs on.
+    if config[CONF_RX_TASK]:
+        cg.add_build_flag("-DTCL_AC_RX_TASK")
+        cg.add(var.set_rx_task_core(config[CONF_RX_TASK_CORE]))
@@ -0,0 +1,124 @@
+#include "command_tracker.h"
+#include "frame_reader.h"
+#include "esphome/core/log.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace esphome {
+namespace tcl_ac {
+
+static const char *const TAG = "tcl_ac";
+
+constexpr uint32_t RttHistogram::BUCKET_MS[];
+
+void RttHistogram::add(uint32_t rtt_ms) {
+  size_t bucket = 0;
+  while (bucket < BUCKETS - 1 && rtt_ms > BUCKET_MS[bucket])
+    bucket++;
+  this->counts_[bucket]++;
+  this->total_++;
+}
+
+float RttHistogram::percentile(float p) const {
+  if (this->total_ == 0)
+    return NAN;
+  float rank = p * this->total_;
+  uint32_t below = 0;
+  for (size_t bucket = 0; bucket < BUCKETS; bucket++) {
+    uint32_t count = this->counts_[bucket];
+    if (count == 0 || below + count < rank) {
+      below += count;
+      continue;
+    }
+    float lower = bucket == 0 ? 0.0f : BUCKET_MS[bucket - 1];
+    if (bucket == BUCKETS - 1)
+      return lower;  // Open-ended: all we know is that it is slower
+    return lower + (BUCKET_MS[bucket] - lower) * (rank - below) / count;
+  }
+  return BUCKET_MS[BUCKETS - 2];
+}
+
+void CommandTracker::start(const uint8_t *packet, uint32_t now_ms) {
+  memcpy(this->packet_, packet, SET_PACKET_SIZE);
+  this->requested_ = AcSettings();
+  decode_settings(packet + FRAME_HEADER_SIZE, SET_PACKET_SIZE - FRAME_OVERHEAD, &this->requested_);
+  this->power_off_ = this->requested_.mode == climate::CLIMATE_MODE_OFF;
+  this->replaced_ = this->pending_;
+  if (!this->pending_)
+    this->unconfirmed_ = now_ms;
+  this->pending_ = true;
+  this->retries_ = 0;
+  // Until it is on the wire; a frame the link had to drop still times out
+  this->sent_ = now_ms;
+  this->deadline_ = now_ms + this->timeout_;
+}
+
+void CommandTracker::on_sent(uint32_t done_ms) {
+  if (!this->pending_)
+    return;
+  this->sent_ = done_ms;
+  this->deadline_ = done_ms + (this->timeout_ << this->retries_);
+}
+
+CommandTracker::Event CommandTracker::on_status(const uint8_t *payload, size_t length, uint32_t now_ms) {
+  if (!this->pending_)
+    return Event::NONE;
+
+  // Decoded the same way as the request, so both are in canonical form
+  AcSettings reported = this->requested_;
+  if (!decode_settings(payload, length, &reported))
+    return Event::NONE;
+  // A power-off frame only clears the power bit; the unit keeps the rest
+  bool match = this->power_off_ ? reported.mode == climate::CLIMATE_MODE_OFF
+                                : settings_match(this->requested_, reported);
+  if (!match)
+    return Event::NONE;
+
+  this->pending_ = false;
+  this->confirmed_++;
+  if (this->retries_ == 0 && (int32_t) (now_ms - this->sent_) >= 0) {
+    this->last_rtt_ = now_ms - this->sent_;
+    this->rtt_.add(this->last_rtt_);
+  }
+  return Event::CONFIRMED;
+}
+
+uint32_t CommandTracker::next_check(uint32_t now_ms) const {
+  if (!this->pending_)
+    return UINT32_MAX;
+  uint32_t due = this->deadline_;
+  if (this->replaced_ && (int32_t) (this->unconfirmed_ + this->budget_() - due) < 0)
+    due = this->unconfirmed_ + this->budget_();
+  return (int32_t) (due - now_ms) > 0 ? due - now_ms : 0;
+}
+
+CommandTracker::Event CommandTracker::check(uint32_t now_ms) {
+  if (!this->pending_)
+    return Event::NONE;
+  uint32_t budget = this->budget_();
+  if (this->replaced_ && now_ms - this->unconfirmed_ >= budget) {
+    ESP_LOGW(TAG, "AC confirmed none of the SETs sent in the last %u ms, giving up", (unsigned) budget);
+    this->pending_ = false;
+    this->failures_++;
+    return Event::FAILED;
+  }
+  if ((int32_t) (now_ms - this->deadline_) < 0)
+    return Event::NONE;
+
+  if (this->retries_ >= this->max_retries_) {
+    ESP_LOGW(TAG, "AC did not confirm SET after %u retransmission(s), giving up", (unsigned) this->retries_);
+    this->pending_ = false;
+    this->failures_++;
+    return Event::FAILED;
+  }
+  this->retries_++;
+  this->retransmits_++;
+  this->deadline_ = now_ms + (this->timeout_ << this->retries_);  // Until on_sent() has the wire time
+  ESP_LOGW(TAG, "No confirmation for SET after %u ms, retransmitting (%u/%u)",
+           (unsigned) (now_ms - this->sent_), (unsigned) this->retries_, (unsigned) this->max_retries_);
+  return Event::RETRANSMIT;
+}
+
+}  // namespace tcl_ac
+}  // namespace esphome
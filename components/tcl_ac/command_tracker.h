@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "tcl_ac_codec.h"
+#include "tcl_ac_protocol.h"
+
+namespace esphome {
+namespace tcl_ac {
+
+// Command round-trip times in fixed buckets. BUCKET_MS are the upper bounds;
+// the last bucket collects everything slower.
+class RttHistogram {
+ public:
+  static constexpr uint32_t BUCKET_MS[] = {50, 100, 150, 200, 300, 500, 1000, 2000};
+  static const size_t BUCKETS = sizeof(BUCKET_MS) / sizeof(BUCKET_MS[0]) + 1;
+
+  void add(uint32_t rtt_ms);
+  // Interpolated within the bucket, like a Prometheus histogram_quantile();
+  // NAN while empty
+  float percentile(float p) const;
+  uint32_t get_count(size_t bucket) const { return this->counts_[bucket]; }
+  uint32_t get_total() const { return this->total_; }
+
+ protected:
+  uint32_t counts_[BUCKETS]{};
+  uint32_t total_{0};
+};
+
+// Tracks the SET frame in flight until a status frame from the AC shows the
+// settings it carries. Without confirmation the frame is due again after the
+// timeout, which doubles with every retransmission, until max_retries are
+// used up. Round-trip time is measured from the frame leaving the wire to
+// the confirming status; retransmitted commands are not sampled, since the
+// reply could belong to either copy (Karn's algorithm).
+//
+// A new command replacing an unconfirmed one does not restart the clock: if
+// the AC has shown none of them for as long as one command may take with
+// all its retries, the last one fails as well. A field the unit will not
+// take therefore cannot keep every later command unconfirmed.
+//
+// Knows nothing about the UART or ESPHome: TclAcClimate feeds it frames and
+// the time, and sends whatever it asks for.
+class CommandTracker {
+ public:
+  enum class Event : uint8_t {
+    NONE,
+    CONFIRMED,   // A status frame shows the requested settings
+    RETRANSMIT,  // Confirmation overdue: send packet() again
+    FAILED,      // Retries used up; the command is dropped
+  };
+
+  void set_timeout(uint32_t timeout_ms) { this->timeout_ = timeout_ms; }
+  void set_max_retries(uint8_t retries) { this->max_retries_ = retries; }
+
+  // A SET (or power-off) frame handed to the link. Replaces any command still
+  // in flight: every SET carries the full state.
+  void start(const uint8_t *packet, uint32_t now_ms);
+  // The frame, or its retransmission, left the wire at `done_ms`
+  void on_sent(uint32_t done_ms);
+  // A 0x03/0x04/0x06 status payload
+  Event on_status(const uint8_t *payload, size_t length, uint32_t now_ms);
+  // Call from loop()
+  Event check(uint32_t now_ms);
+  // Time until check() may retransmit or give up; 0 if it may now
+  uint32_t next_check(uint32_t now_ms) const;
+
+  bool pending() const { return this->pending_; }
+  const uint8_t *packet() const { return this->packet_; }
+  // The settings packet() asks for
+  const AcSettings &get_requested() const { return this->requested_; }
+  uint32_t get_timeout() const { return this->timeout_; }
+  uint8_t get_max_retries() const { return this->max_retries_; }
+
+  const RttHistogram &get_rtt() const { return this->rtt_; }
+  uint32_t get_last_rtt() const { return this->last_rtt_; }
+  uint32_t get_confirmed() const { return this->confirmed_; }
+  uint32_t get_retransmits() const { return this->retransmits_; }
+  uint32_t get_failures() const { return this->failures_; }
+
+ protected:
+  // The time a single command gets: the timeout and every doubled one after it
+  uint32_t budget_() const { return this->timeout_ * ((2u << this->max_retries_) - 1); }
+
+  uint8_t packet_[SET_PACKET_SIZE]{};
+  AcSettings requested_;  // packet_ decoded, to compare status frames against
+  bool power_off_{false};
+  bool pending_{false};
+  uint8_t retries_{0};
+  uint32_t sent_{0};      // When the last copy left the wire
+  uint32_t deadline_{0};
+  bool replaced_{false};      // Started while an earlier command was unconfirmed
+  uint32_t unconfirmed_{0};  // When the first of those commands was started
+
+  uint32_t timeout_{1000};
+  uint8_t max_retries_{3};
+
+  RttHistogram rtt_;
+  uint32_t last_rtt_{0};
+  uint32_t confirmed_{0};
+  uint32_t retransmits_{0};
+  uint32_t failures_{0};
+};
+
+}  // namespace tcl_ac
+}  // namespace esphome
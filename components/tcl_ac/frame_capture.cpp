@@ -0,0 +1,71 @@
+#include "frame_capture.h"
+#include "esphome/core/hal.h"
+
+#include <algorithm>
+#include <new>
+
+namespace esphome {
+namespace tcl_ac {
+
+// record() holds the ring for a copy at most. Waiting is a sleep of at least
+// one FreeRTOS tick (10 ms at 100 Hz), so a lower priority holder gets the
+// core back; after the last attempt the ring is taken to be exported.
+static const uint8_t CAPTURE_LOCK_ATTEMPTS = 5;
+static const uint32_t CAPTURE_LOCK_WAIT_MS = 10;
+
+bool FrameCapture::init(size_t records) {
+  if (this->capacity_ != 0 || records == 0)
+    return true;
+  this->records_.reset(new (std::nothrow) CaptureRecord[records]());
+  if (!this->records_)
+    return false;
+  this->capacity_ = records;
+  return true;
+}
+
+bool FrameCapture::lock_() {
+  for (uint8_t attempt = 1;; attempt++) {
+    if (!this->busy_.exchange(true, std::memory_order_acquire))
+      return true;
+    if (attempt == CAPTURE_LOCK_ATTEMPTS)
+      return false;
+    delay(CAPTURE_LOCK_WAIT_MS);
+  }
+}
+
+bool FrameCapture::clear() {
+  if (!this->lock_())
+    return false;
+  this->next_ = 0;
+  this->count_ = 0;
+  this->overwritten_.store(0, std::memory_order_relaxed);
+  this->busy_.store(false, std::memory_order_release);
+  return true;
+}
+
+bool FrameCapture::export_to(const std::function<void(const uint8_t *, size_t)> &write) {
+  if (!this->lock_())
+    return false;
+  CaptureHeader header{};
+  memcpy(header.magic, "TCLC", 4);
+  header.version = CAPTURE_VERSION;
+  header.record_size = sizeof(CaptureRecord);
+  header.records = this->count_;
+  header.overwritten = this->overwritten_.load(std::memory_order_relaxed);
+  write(reinterpret_cast<const uint8_t *>(&header), sizeof(header));
+  
+  // The ring is at most two runs of records, each written in chunks
+  size_t slot = (this->next_ + this->capacity_ - this->count_) % this->capacity_;
+  size_t left = this->count_;
+  while (left > 0) {
+    size_t chunk = std::min({left, this->capacity_ - slot, CAPTURE_EXPORT_CHUNK});
+    write(reinterpret_cast<const uint8_t *>(&this->records_[slot]), chunk * sizeof(CaptureRecord));
+    slot = slot + chunk == this->capacity_ ? 0 : slot + chunk;
+    left -= chunk;
+  }
+  this->busy_.store(false, std::memory_order_release);
+  return true;
+}
+
+}  // namespace tcl_ac
+}  // namespace esphome
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+
+namespace esphome {
+namespace tcl_ac {
+
+// Frame bytes kept per record: the longest frame the AC sends (61-byte
+// status) with room to spare. Longer frames are cut and flagged.
+static const size_t CAPTURE_FRAME_BYTES = 66;
+
+// Record flags
+static const uint8_t CAPTURE_TX = 0x01;           // Sent to the AC; received otherwise
+static const uint8_t CAPTURE_CHECKSUM_OK = 0x02;
+static const uint8_t CAPTURE_TRUNCATED = 0x04;    // Frame longer than CAPTURE_FRAME_BYTES
+
+// One captured frame. Stored and exported as is: little-endian, 72 bytes.
+struct CaptureRecord {
+  uint32_t time_us;  // micros() when the frame ended: taken off the UART, or its last byte on the wire
+  uint8_t flags;
+  uint8_t size;      // Frame length on the wire
+  uint8_t data[CAPTURE_FRAME_BYTES];  // Bytes past `size` are left from an older record
+};
+static_assert(sizeof(CaptureRecord) == 72, "CaptureRecord is part of the export format");
+
+// Export header, followed by the records oldest first
+struct CaptureHeader {
+  char magic[4];        // "TCLC"
+  uint8_t version;      // CAPTURE_VERSION
+  uint8_t record_size;  // sizeof(CaptureRecord)
+  uint16_t reserved;
+  uint32_t records;
+  uint32_t overwritten;  // Records lost to the ring wrapping, plus those skipped during an export
+};
+static_assert(sizeof(CaptureHeader) == 16, "CaptureHeader is part of the export format");
+
+static const uint8_t CAPTURE_VERSION = 1;
+
+// Most records per write() of an export (1152 bytes)
+static const size_t CAPTURE_EXPORT_CHUNK = 16;
+
+// In-RAM ring of the last N frames on the line, for debugging without
+// VERBOSE logging. Recording is a copy of at most 66 bytes and no logging;
+// with no records allocated it is a single branch.
+//
+// export_to() may run on another task (the ESP32 web server) while loop()
+// records. loop() never waits for it: a frame that ends during an export is
+// not recorded and counts as overwritten. clear() and export_to() do wait
+// for record(), but by sleeping between a few attempts rather than spinning:
+// on a single core the task they wait for may have a lower priority.
+class FrameCapture {
+ public:
+  // Allocates room for `records` frames, once; 0 keeps capture off. False
+  // if the memory is not there.
+  bool init(size_t records);
+  bool enabled() const { return this->capacity_ != 0; }
+  size_t capacity() const { return this->capacity_; }
+  size_t size() const { return this->count_; }
+  uint32_t get_overwritten() const { return this->overwritten_.load(std::memory_order_relaxed); }
+
+  void record(uint8_t flags, const uint8_t *frame, size_t size, uint32_t time_us) {
+    if (this->busy_.exchange(true, std::memory_order_acquire)) {
+      this->overwritten_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    CaptureRecord &record = this->records_[this->next_];
+    record.time_us = time_us;
+    record.flags = size > CAPTURE_FRAME_BYTES ? flags | CAPTURE_TRUNCATED : flags;
+    record.size = size > 255 ? 255 : static_cast<uint8_t>(size);
+    memcpy(record.data, frame, size > CAPTURE_FRAME_BYTES ? CAPTURE_FRAME_BYTES : size);
+    this->next_ = this->next_ + 1 == this->capacity_ ? 0 : this->next_ + 1;
+    if (this->count_ < this->capacity_) {
+      this->count_++;
+    } else {
+      this->overwritten_.fetch_add(1, std::memory_order_relaxed);
+    }
+    this->busy_.store(false, std::memory_order_release);
+  }
+
+  // Record i, oldest first; only while nothing records (loop() itself)
+  const CaptureRecord &at(size_t i) const {
+    size_t first = this->next_ + this->capacity_ - this->count_;
+    return this->records_[(first + i) % this->capacity_];
+  }
+  // False if the ring stayed busy (being exported)
+  bool clear();
+
+  // Header and records, oldest first, in pieces of at most
+  // CAPTURE_EXPORT_CHUNK records. False, with nothing written, if the ring
+  // stayed busy.
+  bool export_to(const std::function<void(const uint8_t *, size_t)> &write);
+  size_t export_size() const { return sizeof(CaptureHeader) + this->count_ * sizeof(CaptureRecord); }
+
+ protected:
+  bool lock_();
+
+  std::unique_ptr<CaptureRecord[]> records_;
+  size_t capacity_{0};
+  size_t next_{0};   // Slot the next record goes into
+  size_t count_{0};
+  std::atomic<uint32_t> overwritten_{0};
+  std::atomic<bool> busy_{false};
+};
+
+}  // namespace tcl_ac
+}  // namespace esphome
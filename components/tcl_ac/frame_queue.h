@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "frame_reader.h"
+#include "tcl_ac_protocol.h"
+
+namespace esphome {
+namespace tcl_ac {
+
+// Lock-free single-producer/single-consumer queue of whole frames: the RX
+// task pushes, loop() pops. Each side writes only its own index. The release
+// store that publishes an index pairs with the acquire load on the other
+// side, so a slot's bytes are complete before the consumer can see it and
+// are no longer read once the producer may reuse it.
+//
+// Frames are copied in, since the framer reuses its buffer; the consumer
+// gets a Frame view straight into the slot.
+template<size_t N, size_t MAX_SIZE> class FrameQueue {
+  static_assert(N > 0 && (N & (N - 1)) == 0, "FrameQueue size must be a power of two");
+  static_assert(MAX_SIZE > FRAME_OVERHEAD && MAX_SIZE <= 256, "FrameQueue slots must fit a frame");
+
+ public:
+  // Producer side. False if the queue is full (or the frame too large); the
+  // frame is not queued then.
+  bool push(const Frame &frame) {
+    size_t size = frame.size();
+    uint32_t tail = this->tail_.load(std::memory_order_relaxed);
+    if (size > MAX_SIZE || tail - this->head_.load(std::memory_order_acquire) == N)
+      return false;
+    Slot &slot = this->slots_[tail & (N - 1)];
+    memcpy(slot.data, frame.raw, size);
+    slot.size = size;
+    slot.calculated = frame.calculated;
+    this->tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side: the oldest frame, valid until pop()
+  bool front(Frame *frame) const {
+    uint32_t head = this->head_.load(std::memory_order_relaxed);
+    if (head == this->tail_.load(std::memory_order_acquire))
+      return false;
+    const Slot &slot = this->slots_[head & (N - 1)];
+    frame->raw = slot.data;
+    frame->command = slot.data[3];
+    frame->length = slot.data[4];
+    frame->payload = slot.data + FRAME_HEADER_SIZE;
+    frame->checksum = slot.data[slot.size - 1];
+    frame->calculated = slot.calculated;
+    return true;
+  }
+  void pop() { this->head_.store(this->head_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+  bool empty() const {
+    return this->head_.load(std::memory_order_acquire) == this->tail_.load(std::memory_order_acquire);
+  }
+
+ protected:
+  struct Slot {
+    uint8_t data[MAX_SIZE];
+    uint16_t size;
+    uint8_t calculated;
+  };
+
+  Slot slots_[N];
+  std::atomic<uint32_t> head_{0};  // Next slot to read; written by the consumer only
+  std::atomic<uint32_t> tail_{0};  // Next slot to write; written by the producer only
+};
+
+}  // namespace tcl_ac
+}  // namespace esphome
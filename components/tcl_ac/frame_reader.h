@@ -0,0 +1,338 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "tcl_ac_protocol.h"
+
+namespace esphome {
+namespace tcl_ac {
+
+// Frame layout (both directions): header(3) + cmd(1) + len(1) + data(len) + checksum(1)
+static const uint8_t FRAME_HEADER_SIZE = 5;
+static const uint8_t FRAME_OVERHEAD = FRAME_HEADER_SIZE + 1;
+
+// Payload lengths a command's frames may announce, as far as PROTOCOL.md and
+// the decoders pin them down. A known command announcing a length outside
+// its range has a corrupted length byte and is not waited for. Commands
+// documented as variable (short status, power, time) are only bounded by the
+// receive buffer.
+struct PayloadLength {
+  uint8_t min;
+  uint8_t max;  // 0 = not checked
+};
+
+inline PayloadLength expected_payload_length(bool from_ac, uint8_t command) {
+  if (from_ac) {
+    switch (command) {
+      case CMD_SET_PARAMS:
+      case CMD_POLL:
+      case CMD_STATUS_ECHO:
+        return {STATUS_MIN_DATA_SIZE, STATUS_DATA_SIZE};
+      case CMD_TEMP_RESPONSE:
+        return {TEMP_MIN_DATA_SIZE, TEMP_DATA_SIZE};
+      default:
+        return {0, 0};
+    }
+  }
+  switch (command) {
+    case CMD_SET_PARAMS:
+      return {SET_PACKET_SIZE - FRAME_OVERHEAD, SET_PACKET_SIZE - FRAME_OVERHEAD};
+    case CMD_POLL:
+      return {POLL_PACKET_SIZE - FRAME_OVERHEAD, POLL_PACKET_SIZE - FRAME_OVERHEAD};
+    default:
+      return {0, 0};
+  }
+}
+
+// Every command with a length range is below this
+static const uint8_t LENGTH_CHECKED_COMMANDS = 16;
+// A command whose frames are dropped for their length byte this often, and
+// more often than they are taken, is reported once: the unit's frames most
+// likely differ from the table rather than being corrupted
+static const uint32_t LENGTH_WARNING_ERRORS = 8;
+
+// A received frame. `payload` points into the reader's ring buffer and stays
+// valid until the next call to FrameReader::push().
+struct Frame {
+  uint8_t command;
+  uint8_t length;
+  const uint8_t *payload;
+  const uint8_t *raw;        // Whole frame starting at the 0xBB header byte
+  uint8_t checksum;          // Checksum byte as received
+  uint8_t calculated;        // XOR of header + cmd + len + data
+  bool checksum_ok() const { return this->checksum == this->calculated; }
+  size_t size() const { return FRAME_OVERHEAD + this->length; }
+};
+
+// Statically sized ring-buffer framer. Defaults to AC → MCU traffic (header
+// BB 01 00); host tools instantiate it with BB 00 01 to follow MCU → AC.
+//
+// Every byte is stored twice (at i and i + CAPACITY) so any window of up to
+// CAPACITY bytes starting at the read position is contiguous in memory. This
+// lets the parsers receive the payload in place without copying. A running
+// XOR prefix is kept per slot, so validating a candidate frame is O(1) and a
+// failed candidate only costs advancing the read position by one byte.
+//
+// Bytes can be pushed one at a time or read straight into the buffer in
+// bulk (write_window() + commit()). Garbage before a header is skipped a
+// word at a time (find_start_()), not byte by byte.
+//
+// The length byte is only trusted as far as it can be checked: a known
+// command must announce a length within expected_payload_length(), and no
+// frame may exceed the buffer. The reader has no clock; once the line has gone quiet
+// with a frame still incomplete, the caller abandon()s it.
+//
+// Usage:
+//   reader.push(byte);  // or: n = uart_read(window, reader.write_window(&window)); reader.commit(n);
+//   Frame frame;
+//   while (reader.next(&frame)) { ... }
+template<size_t CAPACITY, uint8_t HEADER_1 = HEADER_AC_TO_MCU_1, uint8_t HEADER_2 = HEADER_AC_TO_MCU_2>
+class FrameReader {
+  static_assert(CAPACITY > FRAME_OVERHEAD && CAPACITY <= 256, "FrameReader capacity must fit a frame");
+
+ public:
+  // Largest frame accepted. Candidates announcing more data are dropped as
+  // garbage instead of stalling the receiver until the bogus length is filled.
+  static const size_t MAX_FRAME_SIZE = CAPACITY - 1;
+  static const bool FROM_AC = HEADER_1 == HEADER_AC_TO_MCU_1;
+
+  // Off: accept any length up to MAX_FRAME_SIZE (for units whose frames are
+  // not in the table)
+  void set_check_lengths(bool check) { this->check_lengths_ = check; }
+  bool get_check_lengths() const { return this->check_lengths_; }
+
+  void push(uint8_t byte) {
+    if (this->count_ == CAPACITY)
+      this->discard_(1);
+    size_t slot = this->head_ + this->count_;
+    if (slot >= CAPACITY)
+      slot -= CAPACITY;
+    this->buffer_[slot] = byte;
+    this->buffer_[slot + CAPACITY] = byte;
+    this->prefix_[slot] = this->tail_xor_ ^ byte;
+    this->tail_xor_ = this->prefix_[slot];
+    this->count_++;
+  }
+
+  // Contiguous free space for up to the returned number of bytes. Bytes
+  // written there become pending with commit(); reading more than fits means
+  // taking the frames out with next() first. Nothing may be pushed in between.
+  size_t write_window(uint8_t **window) {
+    *window = &this->buffer_[this->head_ + this->count_];
+    return CAPACITY - this->count_;
+  }
+
+  void commit(size_t length) {
+    // The window starts in either copy of the ring; mirror each byte into
+    // the other copy and extend the XOR prefix
+    size_t at = this->head_ + this->count_;
+    uint8_t x = this->tail_xor_;
+    for (size_t i = 0; i < length; i++, at++) {
+      size_t slot = at >= CAPACITY ? at - CAPACITY : at;
+      uint8_t byte = this->buffer_[at];
+      this->buffer_[at >= CAPACITY ? slot : slot + CAPACITY] = byte;
+      x ^= byte;
+      this->prefix_[slot] = x;
+    }
+    this->tail_xor_ = x;
+    this->count_ += length;
+  }
+
+  // Bulk push() for callers that already hold the bytes elsewhere
+  void push(const uint8_t *data, size_t length) {
+    while (length > 0) {
+      if (this->count_ == CAPACITY)
+        this->discard_(1);
+      uint8_t *window;
+      size_t n = std::min(length, this->write_window(&window));
+      memcpy(window, data, n);
+      this->commit(n);
+      data += n;
+      length -= n;
+    }
+  }
+
+  // Extract the next complete frame. Frames with a bad checksum are returned
+  // too (check Frame::checksum_ok()); the reader then resyncs one byte past
+  // their header so that a valid frame hidden inside is not lost.
+  bool next(Frame *frame) {
+    if (this->count_ < this->need_)
+      return false;
+    while (this->count_ > 0) {
+      const uint8_t *p = &this->buffer_[this->head_];
+      if (p[0] != HEADER_AC_TO_MCU_0) {
+        this->discard_(find_start_(p, this->count_));
+        continue;
+      }
+      if (this->count_ < 2)
+        return false;
+      if (p[1] != HEADER_1) {
+        this->discard_(1);
+        continue;
+      }
+      if (this->count_ < 3)
+        return false;
+      if (p[2] != HEADER_2) {
+        this->discard_(1);
+        continue;
+      }
+      if (this->count_ < FRAME_HEADER_SIZE)
+        return false;
+      size_t size = FRAME_OVERHEAD + p[4];
+      if (size > MAX_FRAME_SIZE) {
+        this->overlong_++;
+        this->discard_(1);
+        continue;
+      }
+      if (this->check_lengths_) {
+        PayloadLength expected = expected_payload_length(FROM_AC, p[3]);
+        if (expected.max != 0 && (p[4] < expected.min || p[4] > expected.max)) {
+          this->length_error_(p[3], p[4]);
+          this->discard_(1);
+          continue;
+        }
+      }
+      if (this->count_ < size) {
+        this->need_ = size;  // Header is good, nothing to do until the frame is complete
+        return false;
+      }
+
+      frame->command = p[3];
+      frame->length = p[4];
+      frame->payload = p + FRAME_HEADER_SIZE;
+      frame->raw = p;
+      frame->checksum = p[size - 1];
+      frame->calculated = this->xor_range_(size - 1);
+      if (p[3] < LENGTH_CHECKED_COMMANDS)
+        this->command_frames_[p[3]]++;
+      if (frame->checksum_ok()) {
+        this->drop_(size);
+      } else {
+        this->checksum_errors_++;
+        this->discard_(1);
+      }
+      return true;
+    }
+    return false;
+  }
+
+  // The rest of the pending frame is not coming: give up on its header and
+  // rescan from the byte after it, where a complete frame may be waiting
+  void abandon() {
+    if (this->count_ == 0)
+      return;
+    this->abandoned_++;
+    this->discard_(1);
+  }
+
+  void clear() {
+    this->head_ = 0;
+    this->count_ = 0;
+    this->need_ = 0;
+    this->base_xor_ = 0;
+    this->tail_xor_ = 0;
+  }
+
+  size_t pending() const { return this->count_; }
+  uint32_t get_dropped_bytes() const { return this->dropped_; }
+  uint32_t get_checksum_errors() const { return this->checksum_errors_; }
+  uint32_t get_overlong_frames() const { return this->overlong_; }
+  uint32_t get_length_errors() const { return this->length_errors_; }
+  uint32_t get_abandoned() const { return this->abandoned_; }
+  // A command whose frames keep being dropped for their length byte (see
+  // LENGTH_WARNING_ERRORS), once per command, as command | announced
+  // length << 8; -1 if there is none
+  int32_t take_length_warning() {
+    int32_t warning = this->length_warning_;
+    this->length_warning_ = -1;
+    return warning;
+  }
+
+ protected:
+  // XOR of the first `length` pending bytes
+  uint8_t xor_range_(size_t length) const {
+    size_t last = this->head_ + length - 1;
+    if (last >= CAPACITY)
+      last -= CAPACITY;
+    return this->prefix_[last] ^ this->base_xor_;
+  }
+
+  void drop_(size_t n) {
+    size_t last = this->head_ + n - 1;
+    if (last >= CAPACITY)
+      last -= CAPACITY;
+    this->base_xor_ = this->prefix_[last];
+    this->head_ = last + 1 == CAPACITY ? 0 : last + 1;
+    this->count_ -= n;
+    this->need_ = 0;
+  }
+
+  void length_error_(uint8_t command, uint8_t length) {
+    this->length_errors_++;
+    if (command >= LENGTH_CHECKED_COMMANDS)
+      return;
+    uint32_t errors = ++this->command_length_errors_[command];
+    // Held back while an earlier warning has not been taken yet
+    if (errors >= LENGTH_WARNING_ERRORS && errors > this->command_frames_[command] &&
+        !(this->length_warned_ & (1u << command)) && this->length_warning_ < 0) {
+      this->length_warned_ |= 1u << command;
+      this->length_warning_ = command | length << 8;
+    }
+  }
+
+  // Bytes that are not part of a frame
+  void discard_(size_t n) {
+    this->drop_(n);
+    this->dropped_ += n;
+  }
+
+  // Offset of the first 0xBB in p[0, n), or n. Checks four bytes per step:
+  // a byte of `word ^ 0xBBBBBBBB` is zero exactly where the word holds 0xBB,
+  // and (x - 0x01010101) & ~x & 0x80808080 is non-zero iff x has a zero byte.
+  static size_t find_start_(const uint8_t *p, size_t n) {
+    static const uint32_t ONES = 0x01010101u;
+    static const uint32_t HIGHS = 0x80808080u;
+    static const uint32_t PATTERN = ONES * HEADER_AC_TO_MCU_0;
+    size_t i = 0;
+    // Byte by byte up to a word boundary: Xtensa has no unaligned loads
+    for (; i < n && (reinterpret_cast<uintptr_t>(p + i) & 3) != 0; i++) {
+      if (p[i] == HEADER_AC_TO_MCU_0)
+        return i;
+    }
+    for (; i + 4 <= n; i += 4) {
+      uint32_t word;
+      memcpy(&word, __builtin_assume_aligned(p + i, 4), 4);
+      uint32_t x = word ^ PATTERN;
+      if (((x - ONES) & ~x & HIGHS) != 0)
+        break;
+    }
+    while (i < n && p[i] != HEADER_AC_TO_MCU_0)
+      i++;
+    return i;
+  }
+
+  uint8_t buffer_[2 * CAPACITY];
+  uint8_t prefix_[CAPACITY];  // XOR of the stream up to and including each slot
+  size_t head_{0};
+  size_t count_{0};
+  size_t need_{0};  // Pending bytes required before the head candidate can be re-examined
+  uint8_t base_xor_{0};  // Stream XOR just before head_
+  uint8_t tail_xor_{0};  // Stream XOR up to the last pushed byte
+  uint32_t dropped_{0};
+  uint32_t checksum_errors_{0};
+  uint32_t overlong_{0};
+  uint32_t length_errors_{0};
+  uint32_t abandoned_{0};
+  bool check_lengths_{true};
+  // Per command below LENGTH_CHECKED_COMMANDS: frames taken, and dropped for their length byte
+  uint32_t command_frames_[LENGTH_CHECKED_COMMANDS]{};
+  uint32_t command_length_errors_[LENGTH_CHECKED_COMMANDS]{};
+  uint16_t length_warned_{0};
+  int32_t length_warning_{-1};
+};
+
+}  // namespace tcl_ac
+}  // namespace esphome
@@ -0,0 +1,137 @@
+#include "rx_task.h"
+
+#ifdef TCL_AC_RX_TASK
+
+#include "ac_link.h"
+
+#include <algorithm>
+#ifndef USE_ESP32
+#include <chrono>
+#endif
+
+namespace esphome {
+namespace tcl_ac {
+
+#ifdef USE_ESP32
+// Above the ESPHome loop task (1), below WiFi and lwIP
+static const UBaseType_t RX_TASK_PRIORITY = 5;
+static const uint32_t RX_TASK_STACK_SIZE = 3072;
+#endif
+
+bool RxTask::start(AcTransport *transport, FrameReader<RX_BUFFER_SIZE> *reader, uint32_t gap_timeout_us,
+                   uint8_t core) {
+  if (this->running())
+    return true;
+  this->transport_ = transport;
+  this->reader_ = reader;
+  this->gap_timeout_us_ = gap_timeout_us;
+  this->last_rx_us_ = transport->now_us();
+  this->stop_.store(false, std::memory_order_relaxed);
+  this->running_.store(true, std::memory_order_release);
+#ifdef USE_ESP32
+  BaseType_t created = xTaskCreatePinnedToCore(
+      [](void *arg) {
+        static_cast<RxTask *>(arg)->run_();
+        vTaskDelete(nullptr);
+      },
+      "tcl_ac_rx", RX_TASK_STACK_SIZE, this, RX_TASK_PRIORITY, &this->handle_, core);
+  if (created != pdPASS) {
+    this->running_.store(false, std::memory_order_release);
+    return false;
+  }
+#else
+  (void) core;
+  this->thread_ = std::thread([this] { this->run_(); });
+#endif
+  return true;
+}
+
+void RxTask::stop() {
+  this->stop_.store(true, std::memory_order_relaxed);
+#ifdef USE_ESP32
+  while (this->running())
+    vTaskDelay(1);
+#else
+  if (this->thread_.joinable())
+    this->thread_.join();
+#endif
+}
+
+void RxTask::run_() {
+  while (!this->stop_.load(std::memory_order_relaxed)) {
+    if (this->poll_())
+      continue;
+#ifdef USE_ESP32
+    vTaskDelay(1);
+#else
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+#endif
+  }
+  this->running_.store(false, std::memory_order_release);
+}
+
+bool RxTask::poll_() {
+  bool received = false;
+  size_t available;
+  while ((available = this->transport_->rx_available()) > 0) {
+    uint8_t *window;
+    size_t room = this->reader_->write_window(&window);
+    if (room == 0) {
+      this->reader_->abandon();  // Unreachable: a full buffer always holds a complete frame
+      continue;
+    }
+    size_t length = std::min(available, room);
+    if (!this->transport_->rx_read_array(window, length))
+      break;
+    this->reader_->commit(length);
+    received = true;
+    this->queue_frames_();
+  }
+
+  // One at a time: the reader keeps the next until this one is taken
+  if (this->length_warning_.load(std::memory_order_relaxed) < 0) {
+    int32_t warning = this->reader_->take_length_warning();
+    if (warning >= 0)
+      this->length_warning_.store(warning, std::memory_order_relaxed);
+  }
+  
+  uint32_t now = this->transport_->now_us();
+  if (received) {
+    this->last_rx_us_ = now;
+    return true;
+  }
+  // As AcLink::receive_() does: an incomplete frame after the line went quiet
+  // is not coming
+  if (this->reader_->pending() == 0 || this->gap_timeout_us_ == 0 || now - this->last_rx_us_ < this->gap_timeout_us_)
+    return false;
+  this->gap_timeouts_.fetch_add(1, std::memory_order_relaxed);
+  while (this->reader_->pending() > 0) {
+    this->reader_->abandon();
+    this->queue_frames_();
+  }
+  return false;
+}
+
+void RxTask::queue_frames_() {
+  bool queued = false;
+  Frame frame;
+  while (this->reader_->next(&frame)) {
+    // Queued either way; the slot keeps the computed checksum for loop()
+    if (!frame.checksum_ok())
+      this->checksum_errors_.fetch_add(1, std::memory_order_relaxed);
+    if (this->queue_.push(frame)) {
+      if (frame.checksum_ok())
+        this->frames_.fetch_add(1, std::memory_order_relaxed);
+      queued = true;
+    } else {
+      this->overflows_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  if (queued && this->wake_callback_)
+    this->wake_callback_();
+}
+
+}  // namespace tcl_ac
+}  // namespace esphome
+
+#endif  // TCL_AC_RX_TASK
@@ -0,0 +1,95 @@
+#pragma once
+
+#ifdef TCL_AC_RX_TASK
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+#include "esphome/core/defines.h"
+#include "frame_queue.h"
+#include "frame_reader.h"
+#include "tcl_ac_protocol.h"
+
+#ifdef USE_ESP32
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#else
+#include <thread>
+#endif
+
+namespace esphome {
+namespace tcl_ac {
+
+class AcTransport;
+
+using RxFrameQueue = FrameQueue<RX_QUEUE_SIZE, FrameReader<RX_BUFFER_SIZE>::MAX_FRAME_SIZE>;
+
+// Receives on a task of its own: reads the UART, runs the framer and queues
+// the frames for loop(), those with a bad checksum too so loop() captures
+// and counts them as it does when it frames them itself. On
+// ESP32 this is a FreeRTOS task pinned to a core; elsewhere (the host build)
+// a std::thread.
+//
+// The task owns the rx side of the transport and the framer while it runs;
+// loop() keeps the tx side. ESPHome's ESP32 UART drivers serialise their own
+// calls, so reading here while loop() writes is safe. The task only sleeps a
+// tick when the UART is empty: at 9600 baud that is a few bytes, far below
+// the driver's buffer.
+//
+// Nothing is logged from the task. Its counters are atomics for loop() to
+// report.
+class RxTask {
+ public:
+  ~RxTask() { this->stop(); }
+
+  // Takes over `reader`, which nothing else may touch until stop()
+  bool start(AcTransport *transport, FrameReader<RX_BUFFER_SIZE> *reader, uint32_t gap_timeout_us, uint8_t core);
+  // Returns once the task has exited
+  void stop();
+  bool running() const { return this->running_.load(std::memory_order_acquire); }
+
+  RxFrameQueue &queue() { return this->queue_; }
+  // Called from the task after it queued frames; must be safe there
+  void set_wake_callback(std::function<void()> &&callback) { this->wake_callback_ = std::move(callback); }
+
+  // Frames queued with a good checksum
+  uint32_t get_frames() const { return this->frames_.load(std::memory_order_relaxed); }
+  uint32_t get_checksum_errors() const { return this->checksum_errors_.load(std::memory_order_relaxed); }
+  // Frames dropped because loop() had not taken the earlier ones yet
+  uint32_t get_overflows() const { return this->overflows_.load(std::memory_order_relaxed); }
+  uint32_t get_gap_timeouts() const { return this->gap_timeouts_.load(std::memory_order_relaxed); }
+  // The framer's take_length_warning(), handed over to loop()
+  int32_t take_length_warning() { return this->length_warning_.exchange(-1, std::memory_order_relaxed); }
+
+ protected:
+  void run_();
+  // Read what the UART holds and queue the frames in it; false if it was empty
+  bool poll_();
+  void queue_frames_();
+
+  AcTransport *transport_{nullptr};
+  FrameReader<RX_BUFFER_SIZE> *reader_{nullptr};
+  RxFrameQueue queue_;
+  uint32_t gap_timeout_us_{0};
+  uint32_t last_rx_us_{0};
+  std::atomic<bool> running_{false};
+  std::atomic<bool> stop_{false};
+  std::function<void()> wake_callback_;
+#ifdef USE_ESP32
+  TaskHandle_t handle_{nullptr};
+#else
+  std::thread thread_;
+#endif
+
+  std::atomic<uint32_t> frames_{0};
+  std::atomic<uint32_t> checksum_errors_{0};
+  std::atomic<uint32_t> overflows_{0};
+  std::atomic<uint32_t> gap_timeouts_{0};
+  std::atomic<int32_t> length_warning_{-1};
+};
+
+}  // namespace tcl_ac
+}  // namespace esphome
+
+#endif  // TCL_AC_RX_TASK
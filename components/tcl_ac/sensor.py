@@ -0,0 +1,83 @@
+"""Diagnostic sensors for TCL AC: SET confirmation round-trip time and retries, loop() time."""
+
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import sensor
+from esphome.const import (
+    ENTITY_CATEGORY_DIAGNOSTIC,
+    STATE_CLASS_MEASUREMENT,
+    STATE_CLASS_TOTAL_INCREASING,
+    UNIT_MILLISECOND,
+)
+
+CODEOWNERS = ["@Kannix2005"]
+
+from . import TclAcClimate
+
+CONF_TCL_AC_ID = "tcl_ac_id"
+CONF_COMMAND_RTT_MEDIAN = "command_rtt_median"
+CONF_COMMAND_RTT_P95 = "command_rtt_p95"
+CONF_COMMAND_RETRANSMITS = "command_retransmits"
+CONF_COMMAND_FAILURES = "command_failures"
+CONF_LOOP_TIME_MAX = "loop_time_max"
+CONF_RX_BUDGET_HITS = "rx_budget_hits"
+
+RTT_SCHEMA = sensor.sensor_schema(
+    unit_of_measurement=UNIT_MILLISECOND,
+    icon="mdi:timer-outline",
+    accuracy_decimals=0,
+    state_class=STATE_CLASS_MEASUREMENT,
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+)
+COUNT_SCHEMA = sensor.sensor_schema(
+    icon="mdi:counter",
+    accuracy_decimals=0,
+    state_class=STATE_CLASS_TOTAL_INCREASING,
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+)
+
+CONFIG_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(CONF_TCL_AC_ID): cv.use_id(TclAcClimate),
+        # Time from a SET leaving the wire to the status frame confirming it,
+        # from a fixed-bucket histogram over all confirmed commands
+        cv.Optional(CONF_COMMAND_RTT_MEDIAN): RTT_SCHEMA,
+        cv.Optional(CONF_COMMAND_RTT_P95): RTT_SCHEMA,
+        cv.Optional(CONF_COMMAND_RETRANSMITS): COUNT_SCHEMA,
+        cv.Optional(CONF_COMMAND_FAILURES): COUNT_SCHEMA,
+        # Longest loop() of the component per minute, and how often the
+        # receive budget left work for the next loop()
+        cv.Optional(CONF_LOOP_TIME_MAX): sensor.sensor_schema(
+            unit_of_measurement=UNIT_MILLISECOND,
+            icon="mdi:timer-outline",
+            accuracy_decimals=1,
+            state_class=STATE_CLASS_MEASUREMENT,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+        cv.Optional(CONF_RX_BUDGET_HITS): COUNT_SCHEMA,
+    }
+)
+
+
+async def to_code(config):
+    """Attach the configured diagnostic sensors to the climate component."""
+    parent = await cg.get_variable(config[CONF_TCL_AC_ID])
+
+    if CONF_COMMAND_RTT_MEDIAN in config:
+        sens = await sensor.new_sensor(config[CONF_COMMAND_RTT_MEDIAN])
+        cg.add(parent.set_command_rtt_median_sensor(sens))
+    if CONF_COMMAND_RTT_P95 in config:
+        sens = await sensor.new_sensor(config[CONF_COMMAND_RTT_P95])
+        cg.add(parent.set_command_rtt_p95_sensor(sens))
+    if CONF_COMMAND_RETRANSMITS in config:
+        sens = await sensor.new_sensor(config[CONF_COMMAND_RETRANSMITS])
+        cg.add(parent.set_command_retransmits_sensor(sens))
+    if CONF_COMMAND_FAILURES in config:
+        sens = await sensor.new_sensor(config[CONF_COMMAND_FAILURES])
+        cg.add(parent.set_command_failures_sensor(sens))
+    if CONF_LOOP_TIME_MAX in config:
+        sens = await sensor.new_sensor(config[CONF_LOOP_TIME_MAX])
+        cg.add(parent.set_loop_time_max_sensor(sens))
+    if CONF_RX_BUDGET_HITS in config:
+        sens = await sensor.new_sensor(config[CONF_RX_BUDGET_HITS])
+        cg.add(parent.set_rx_budget_hits_sensor(sens))
@@ -1,30 +1,88 @@
 #include "tcl_ac.h"
+#include "tcl_ac_schema.h"
 #include "esphome/core/log.h"
 #include "esphome/core/helpers.h"
+#ifdef USE_WEBSERVER
+#include "esphome/components/web_server_base/web_server_base.h"
+#ifdef USE_ESP_IDF
+#include <esp_http_server.h>
+#endif
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 
 namespace esphome {
 namespace tcl_ac {
 
 static const char *const TAG = "tcl_ac";
 
-// added void for switchable booleans in Home assistant for beeper and display
-void TclAcClimate::set_display_state(bool state) {
-  this->display_enabled_ = state;
-  if (this->force_mode_ && this->allow_send_) {
-    uint8_t packet[SET_PACKET_SIZE];
-    this->create_set_packet_(packet);
-    this->send_packet_(packet, SET_PACKET_SIZE);
-  }
-}
+// Upper bound on how long a continuous burst of changes can hold back its SET
+static const uint32_t COALESCE_MAX_WINDOWS = 4;
 
-void TclAcClimate::set_beeper_state(bool state) {
-  this->beeper_enabled_ = state;
-  if (this->force_mode_ && this->allow_send_) {
-    uint8_t packet[SET_PACKET_SIZE];
-    this->create_set_packet_(packet);
-    this->send_packet_(packet, SET_PACKET_SIZE);
+// Short status frames agreeing with full status before their mode is used
+static const uint8_t SHORT_STATUS_TRUST = 3;
+
+// Window over which the longest loop() is reported
+static const uint32_t LOOP_REPORT_MS = 60000;
+
+// Scheduler id of the timeout that wakes a parked loop()
+static const uint32_t IDLE_WAKE_TIMEOUT_ID = 0;
+
+#ifdef USE_WEBSERVER
+static const char *const CAPTURE_URL = "/tcl_ac/capture";
+
+// Serves the frame capture as a binary download, in the format of
+// frame_capture.h. Runs on the web server's task on ESP32. With ESP-IDF the
+// records go out chunk by chunk straight from the ring; the Arduino servers
+// buffer the whole file first (see the capture_frames limits in climate.py).
+class CaptureWebHandler : public AsyncWebHandler {
+ public:
+  explicit CaptureWebHandler(FrameCapture *capture) : capture_(capture) {}
+  bool canHandle(AsyncWebServerRequest *request) const override {
+    return request->method() == HTTP_GET && request->url() == CAPTURE_URL;
+  }
+  void handleRequest(AsyncWebServerRequest *request) override {
+#ifdef USE_ESP_IDF
+    httpd_req_t *req = *request;
+    bool started = false;
+    esp_err_t err = ESP_OK;
+    bool exported = this->capture_->export_to([req, &started, &err](const uint8_t *data, size_t length) {
+      // Headers only once the capture is ours, so a 503 goes out clean
+      if (!started) {
+        httpd_resp_set_type(req, "application/octet-stream");
+        httpd_resp_set_hdr(req, "Content-Disposition", "attachment; filename=\"tcl_ac_capture.bin\"");
+        started = true;
+      }
+      // Once the client is gone, the rest is not sent
+      if (err == ESP_OK)
+        err = httpd_resp_send_chunk(req, reinterpret_cast<const char *>(data), length);
+    });
+    if (exported) {
+      if (err == ESP_OK)
+        httpd_resp_send_chunk(req, nullptr, 0);
+      return;
+    }
+#else
+    AsyncResponseStream *stream = request->beginResponseStream("application/octet-stream");
+    stream->addHeader("Content-Disposition", "attachment; filename=\"tcl_ac_capture.bin\"");
+    bool exported = this->capture_->export_to(
+        [stream](const uint8_t *data, size_t length) { stream->write(data, length); });
+    if (exported) {
+      request->send(stream);
+      return;
+    }
+    delete stream;
+#endif
+    // Another download holds the capture
+    request->send(503, "text/plain", "Capture busy, try again");
   }
-}
+
+ protected:
+  FrameCapture *capture_;
+};
+#endif
 
 void TclAcClimate::setup() {
   // Initialize with defaults
@@ -35,104 +93,346 @@ void TclAcClimate::setup() {
   this->preset = climate::CLIMATE_PRESET_NONE;
   this->swing_mode = climate::CLIMATE_SWING_OFF;
   
+  // Runtime state starts from the YAML configuration
+  this->beeper_state_ = this->beeper_enabled_;
+  this->display_state_ = this->display_enabled_;
+  
+  this->link_.set_frame_callback([this](const Frame &frame) { this->handle_frame_(frame); });
+  this->link_.set_sent_callback([this](uint8_t command, uint32_t done_ms) {
+    if (command == CMD_SET_PARAMS) {
+      this->last_set_sent_ = done_ms;
+      this->has_sent_set_ = true;
+      this->tracker_.on_sent(done_ms);
+    }
+  });
+  
+  // Frame capture, allocated once and for good
+  FrameCapture &capture = this->link_.get_capture();
+  if (!capture.init(this->capture_size_))
+    ESP_LOGE(TAG, "Not enough memory for a %u frame capture", (unsigned) this->capture_size_);
+#ifdef USE_WEBSERVER
+  if (capture.enabled() && web_server_base::global_web_server_base != nullptr)
+    web_server_base::global_web_server_base->add_handler(new CaptureWebHandler(&capture));
+#endif
+  
+#ifdef TCL_AC_RX_TASK
+  // The task runs the framer, so only it knows when a frame has arrived
+  this->link_.set_rx_task_wake_callback([this]() { this->enable_loop_soon_any_context(); });
+  if (this->rx_task_core_ >= 0 && !this->link_.start_rx_task(this->rx_task_core_))
+    ESP_LOGE(TAG, "Could not start the RX task, receiving in loop()");
+#endif
+  
   ESP_LOGCONFIG(TAG, "TCL AC Climate component initialized");
 }
 
 void TclAcClimate::loop() {
-  // Read incoming UART data
-  while (this->available()) {
-    uint8_t byte;
-    this->read_byte(&byte);
-    this->rx_buffer_.push_back(byte);
-    
-    // Check if we have a complete packet (minimum 7 bytes)
-    if (this->rx_buffer_.size() >= 7) {
-      // Check for valid header (BB 01 00 = AC to MCU)
-      // Note: Packets FROM AC have header BB 01 00, TO AC have header BB 00 01
-      if (this->rx_buffer_[0] == 0xBB && this->rx_buffer_[1] == 0x01 && this->rx_buffer_[2] == 0x00) {
-        uint8_t cmd = this->rx_buffer_[3];
-        uint8_t length = this->rx_buffer_[4];
-        size_t expected_size = 5 + length + 1; // header(3) + cmd(1) + len(1) + data + checksum(1)
-        
-        if (this->rx_buffer_.size() >= expected_size) {
-          // Validate checksum
-          uint8_t calculated = this->calculate_checksum_(this->rx_buffer_.data(), expected_size - 1);
-          uint8_t received = this->rx_buffer_[expected_size - 1];
-          
-          ESP_LOGV(TAG, "Received packet: cmd=0x%02X, len=%d, checksum=0x%02X (calc=0x%02X)", 
-                   cmd, length, received, calculated);
-          
-          if (calculated == received) {
-            // Process packet based on command
-            if (cmd == CMD_POLL || cmd == CMD_SET_PARAMS) {
-              // Command 0x03 (SET response) and 0x04 (POLL response) have same 55-byte data format
-              ESP_LOGD(TAG, "Processing status packet (cmd 0x%02X)", cmd);
-              this->parse_status_packet_(this->rx_buffer_.data() + 5, length);
-            } else if (cmd == CMD_POWER) {
-              ESP_LOGD(TAG, "Processing power status (cmd 0x0A)");
-              this->parse_power_response_(this->rx_buffer_.data() + 5, length);
-            } else if (cmd == CMD_TEMP_RESPONSE) {
-              ESP_LOGD(TAG, "Processing temp response");
-              this->parse_temp_response_(this->rx_buffer_.data() + 5, length);
-            } else if (cmd == CMD_SHORT_STATUS) {
-              ESP_LOGV(TAG, "Received short status (0x09) - limited data, using regular status instead");
-              // SHORT_STATUS has only 45 bytes and minimal info, skip for now
-            } else if (cmd == CMD_STATUS_ECHO) {
-              ESP_LOGD(TAG, "Processing status echo (0x06)");
-              this->parse_status_packet_(this->rx_buffer_.data() + 5, length);
-            } else {
-              ESP_LOGW(TAG, "Unknown command: 0x%02X", cmd);
-            }
-          } else {
-            ESP_LOGW(TAG, "Checksum mismatch: expected 0x%02X, got 0x%02X", calculated, received);
-          }
-          
-          // Clear buffer after processing
-          this->rx_buffer_.clear();
-        }
-      } else {
-        // Invalid header, shift buffer
-        this->rx_buffer_.erase(this->rx_buffer_.begin());
-      }
+  uint32_t start = micros();
+  this->loop_parked_ = false;  // Woken by the RX task, the wake timer stays armed for the next park
+  this->link_.loop();
+  this->flush_set_();
+  this->check_command_();
+  
+  // A change held back by the rate limiter goes out once the interval has passed
+  if (this->publish_pending_ && millis() - this->last_publish_ >= this->min_publish_interval_)
+    this->publish_now_();
+  
+  uint32_t elapsed = micros() - start;
+  this->loop_max_us_ = std::max(this->loop_max_us_, elapsed);
+  this->loop_window_max_us_ = std::max(this->loop_window_max_us_, elapsed);
+  if (millis() - this->loop_window_start_ >= LOOP_REPORT_MS)
+    this->publish_loop_stats_();
+  
+  this->park_loop_();
+}
+
+void TclAcClimate::park_loop_() {
+  if (this->idle_check_interval_ == 0)
+    return;
+  uint32_t now = millis();
+  uint32_t wait = this->link_.idle_for(now);
+  
+  // A SET waiting for its confirmation keeps loop() running unless the RX
+  // task wakes it for the status frame: the round trip is measured when
+  // loop() handles that frame
+  bool task = this->link_.rx_task_running();
+  if (this->tracker_.pending()) {
+    if (!task)
+      return;
+    wait = std::min(wait, this->tracker_.next_check(now));
+  }
+  if (this->set_pending_changes_ > 0) {
+    uint32_t due = std::min(this->set_last_change_ + this->coalesce_window_,
+                            this->set_first_change_ + this->coalesce_window_ * COALESCE_MAX_WINDOWS);
+    wait = std::min(wait, (int32_t) (due - now) > 0 ? due - now : 0);
+  }
+  if (this->publish_pending_) {
+    uint32_t due = this->last_publish_ + this->min_publish_interval_;
+    wait = std::min(wait, (int32_t) (due - now) > 0 ? due - now : 0);
+  }
+  wait = std::min(wait, LOOP_REPORT_MS - std::min(LOOP_REPORT_MS, now - this->loop_window_start_));
+  // ESPHome's UART has no receive callback; without the task, check it
+  if (!task)
+    wait = std::min(wait, this->idle_check_interval_);
+  if (wait == 0)
+    return;
+  
+  // One wake timer stays armed across parks and is only re-armed for an
+  // earlier deadline; one that fires early just runs loop() once more
+  uint32_t wake_at = now + wait;
+  if (!this->idle_wake_armed_ || (int32_t) (wake_at - this->idle_wake_at_) < 0) {
+    this->set_timeout(IDLE_WAKE_TIMEOUT_ID, wait, [this]() {
+      this->idle_wake_armed_ = false;
+      this->wake_loop_();
+    });
+    this->idle_wake_armed_ = true;
+    this->idle_wake_at_ = wake_at;
+  }
+  this->loop_parked_ = true;
+  this->loop_parks_++;
+  this->disable_loop();
+}
+
+void TclAcClimate::wake_loop_() {
+  if (!this->loop_parked_)
+    return;
+  this->loop_parked_ = false;
+  this->enable_loop();
+}
+
+void TclAcClimate::publish_loop_stats_() {
+#ifdef USE_SENSOR
+  if (this->loop_time_max_sensor_ != nullptr)
+    this->loop_time_max_sensor_->publish_state(this->loop_window_max_us_ / 1000.0f);
+  if (this->rx_budget_hits_sensor_ != nullptr)
+    this->rx_budget_hits_sensor_->publish_state(this->link_.get_rx_budget_hits());
+#endif
+  this->loop_window_max_us_ = 0;
+  this->loop_window_start_ = millis();
+}
+
+bool TclAcClimate::state_changed_() const {
+  const PublishedState &last = this->published_;
+  if (this->mode != last.mode || this->target_temperature != last.target_temperature ||
+      this->fan_mode.value_or(climate::CLIMATE_FAN_AUTO) != last.fan_mode ||
+      this->preset.value_or(climate::CLIMATE_PRESET_NONE) != last.preset || this->swing_mode != last.swing_mode)
+    return true;
+  
+  // Room temperature jitters in the last digit; only a move past the deadband counts
+  if (std::isnan(this->current_temperature) || std::isnan(last.current_temperature))
+    return std::isnan(this->current_temperature) != std::isnan(last.current_temperature);
+  return std::fabs(this->current_temperature - last.current_temperature) >= this->temperature_deadband_;
+}
+
+void TclAcClimate::publish_if_changed_() {
+  if (!this->has_published_ || this->state_changed_()) {
+    if (this->has_published_ && millis() - this->last_publish_ < this->min_publish_interval_) {
+      this->publish_pending_ = true;  // Sent from loop() when the interval is up
+      this->wake_loop_();
+      return;
     }
+    this->publish_now_();
+    return;
   }
+  this->publish_suppressed_++;
+}
+
+void TclAcClimate::publish_now_() {
+  this->published_.mode = this->mode;
+  this->published_.target_temperature = this->target_temperature;
+  this->published_.current_temperature = this->current_temperature;
+  this->published_.fan_mode = this->fan_mode.value_or(climate::CLIMATE_FAN_AUTO);
+  this->published_.preset = this->preset.value_or(climate::CLIMATE_PRESET_NONE);
+  this->published_.swing_mode = this->swing_mode;
+  this->has_published_ = true;
+  this->publish_pending_ = false;
+  this->last_publish_ = millis();
+  this->publish_count_++;
+  this->publish_state();
+}
+
+void TclAcClimate::handle_frame_(const Frame &frame) {
+  // Note: Packets FROM AC have header BB 01 00, TO AC have header BB 00 01
+  ESP_LOGV(TAG, "Received packet: cmd=0x%02X, len=%d, checksum=0x%02X (calc=0x%02X)", 
+           frame.command, frame.length, frame.checksum, frame.calculated);
   
-  // Poll AC every 5 seconds for status updates (AC sends ~1.3s intervals)
-  uint32_t now = millis();
-  if (now - this->last_poll_ > 5000) {
-    this->send_poll_packet_();
-    this->last_poll_ = now;
+  if (!frame.checksum_ok()) {
+    ESP_LOGW(TAG, "Checksum mismatch: expected 0x%02X, got 0x%02X", frame.calculated, frame.checksum);
+    return;
+  }
+  
+  // The AC repeats the same payload most of the time; nothing to decode then
+  if (this->memoize_frames_ && this->is_repeated_frame_(frame)) {
+    this->frames_memoized_++;
+    return;
+  }
+  
+  // Process packet based on command
+  if (frame.command == CMD_POLL || frame.command == CMD_SET_PARAMS) {
+    // Command 0x03 (SET response) and 0x04 (POLL response) have same 55-byte data format
+    ESP_LOGD(TAG, "Processing status packet (cmd 0x%02X)", frame.command);
+    this->parse_status_packet_(frame.payload, frame.length);
+  } else if (frame.command == CMD_POWER) {
+    ESP_LOGD(TAG, "Processing power status (cmd 0x0A)");
+    this->parse_power_response_(frame.payload, frame.length);
+  } else if (frame.command == CMD_TEMP_RESPONSE) {
+    ESP_LOGD(TAG, "Processing temp response");
+    this->parse_temp_response_(frame.payload, frame.length);
+  } else if (frame.command == CMD_SHORT_STATUS) {
+    ESP_LOGV(TAG, "Processing short status (0x09)");
+    this->parse_short_status_(frame.payload, frame.length);
+  } else if (frame.command == CMD_STATUS_ECHO) {
+    ESP_LOGD(TAG, "Processing status echo (0x06)");
+    this->parse_status_packet_(frame.payload, frame.length);
+  } else {
+    ESP_LOGW(TAG, "Unknown command: 0x%02X", frame.command);
   }
 }
 
+bool TclAcClimate::is_repeated_frame_(const Frame &frame) {
+  PayloadCache *cache;
+  switch (frame.command) {
+    case CMD_SET_PARAMS:
+      cache = &this->payload_cache_[0];
+      break;
+    case CMD_POLL:
+      cache = &this->payload_cache_[1];
+      break;
+    case CMD_TEMP_RESPONSE:
+      cache = &this->payload_cache_[2];
+      break;
+    case CMD_STATUS_ECHO:
+      cache = &this->payload_cache_[3];
+      break;
+    case CMD_POWER:
+      cache = &this->payload_cache_[4];
+      break;
+    default:
+      return false;
+  }
+  if (frame.length > sizeof(cache->data)) {
+    cache->valid = false;
+    return false;
+  }
+  
+  if (cache->valid && cache->length == frame.length && memcmp(cache->data, frame.payload, frame.length) == 0)
+    return true;
+  memcpy(cache->data, frame.payload, frame.length);
+  cache->length = frame.length;
+  cache->valid = true;
+  return false;
+}
+
+void TclAcClimate::invalidate_payload_cache_() {
+  // Our state moved away from what the AC last reported, so its next report
+  // must be decoded even if it repeats the previous one
+  for (auto &cache : this->payload_cache_)
+    cache.valid = false;
+}
+
 void TclAcClimate::dump_config() {
   ESP_LOGCONFIG(TAG, "TCL AC Climate:");
+  ESP_LOGCONFIG(TAG, "  Protocol Model: %s", ActiveModel::NAME);
   ESP_LOGCONFIG(TAG, "  Beeper: %s", this->beeper_enabled_ ? "ON" : "OFF");
   ESP_LOGCONFIG(TAG, "  Display: %s", this->display_enabled_ ? "ON" : "OFF");
   ESP_LOGCONFIG(TAG, "  Vertical Direction: %d", this->vertical_direction_);
   ESP_LOGCONFIG(TAG, "  Horizontal Direction: %d", this->horizontal_direction_);
+  ESP_LOGCONFIG(TAG, "  Coalesce Window: %u ms", (unsigned) this->coalesce_window_);
+  ESP_LOGCONFIG(TAG, "  Force Mode: %s", this->force_mode_ ? "ON (unchanged SETs are sent)" : "OFF");
+  ESP_LOGCONFIG(TAG, "  Command Timeout: %u ms, %u retransmission(s) with backoff",
+                (unsigned) this->tracker_.get_timeout(), (unsigned) this->tracker_.get_max_retries());
+  const RttHistogram &rtt = this->tracker_.get_rtt();
+  if (rtt.get_total() > 0) {
+    ESP_LOGCONFIG(TAG, "  Command RTT: median %.0f ms, p95 %.0f ms over %u command(s)", rtt.percentile(0.5f),
+                  rtt.percentile(0.95f), (unsigned) rtt.get_total());
+    for (size_t i = 0; i < RttHistogram::BUCKETS; i++) {
+      if (i + 1 < RttHistogram::BUCKETS) {
+        ESP_LOGCONFIG(TAG, "    <= %4u ms: %u", (unsigned) RttHistogram::BUCKET_MS[i], (unsigned) rtt.get_count(i));
+      } else {
+        ESP_LOGCONFIG(TAG, "    >  %4u ms: %u", (unsigned) RttHistogram::BUCKET_MS[i - 1], (unsigned) rtt.get_count(i));
+      }
+    }
+  }
+  ESP_LOGCONFIG(TAG, "  Publish: on change, deadband %.2f°C, at most every %u ms", this->temperature_deadband_,
+                (unsigned) this->min_publish_interval_);
+  ESP_LOGCONFIG(TAG, "  Poll Interval: %u ms (idle up to %u ms)", (unsigned) this->link_.get_poll_interval(),
+                (unsigned) this->link_.get_idle_poll_interval());
+  ESP_LOGCONFIG(TAG, "  Fast Poll: %u x %u ms after a command", (unsigned) this->link_.get_fast_poll_count(),
+                (unsigned) this->link_.get_fast_poll_interval());
+  if (this->idle_check_interval_ != 0 && this->link_.rx_task_running()) {
+    ESP_LOGCONFIG(TAG, "  Idle: loop() parked until the next deadline or received frame; parked %u time(s)",
+                  (unsigned) this->loop_parks_);
+  } else if (this->idle_check_interval_ != 0) {
+    ESP_LOGCONFIG(TAG, "  Idle: loop() parked until the next deadline, UART checked every %u ms; parked %u time(s)",
+                  (unsigned) this->idle_check_interval_, (unsigned) this->loop_parks_);
+  } else {
+    ESP_LOGCONFIG(TAG, "  Idle: loop() runs on every pass");
+  }
+  ESP_LOGCONFIG(TAG, "  Frame Lengths: %s", this->link_.get_check_lengths() ? "checked against the protocol table"
+                                                                               : "not checked");
+  ESP_LOGCONFIG(TAG, "  RX Budget: %u bytes, %u us per loop (0 = unlimited); hit %u time(s), longest loop %u us",
+                (unsigned) this->link_.get_rx_budget_bytes(), (unsigned) this->link_.get_rx_budget_time(),
+                (unsigned) this->link_.get_rx_budget_hits(), (unsigned) this->loop_max_us_);
+#ifdef TCL_AC_RX_TASK
+  if (this->link_.get_rx_task().running()) {
+    const RxTask &task = this->link_.get_rx_task();
+    ESP_LOGCONFIG(TAG, "  RX Task: core %d; %u frames, %u bad checksums, %u lost to a full queue", this->rx_task_core_,
+                  (unsigned) task.get_frames(), (unsigned) task.get_checksum_errors(), (unsigned) task.get_overflows());
+  }
+#endif
+  const FrameCapture &capture = this->link_.get_capture();
+  if (capture.enabled()) {
+    ESP_LOGCONFIG(TAG, "  Capture: last %u frames, %u held, %u overwritten", (unsigned) capture.capacity(),
+                  (unsigned) capture.size(), (unsigned) capture.get_overwritten());
+  }
   this->check_uart_settings(9600, 1, uart::UART_CONFIG_PARITY_EVEN, 8);
 }
 
+void TclAcClimate::dump_capture() {
+  const FrameCapture &capture = this->link_.get_capture();
+  if (!capture.enabled()) {
+    ESP_LOGW(TAG, "Frame capture is off (capture_frames)");
+    return;
+  }
+  ESP_LOGI(TAG, "Capture: %u frame(s), %u overwritten", (unsigned) capture.size(),
+           (unsigned) capture.get_overwritten());
+  // Time (us), direction, checksum status and bytes, as the replay tool reads them
+  for (size_t i = 0; i < capture.size(); i++) {
+    const CaptureRecord &record = capture.at(i);
+    size_t length = std::min<size_t>(record.size, CAPTURE_FRAME_BYTES);
+    ESP_LOGI(TAG, "  %10u %s %s %s", (unsigned) record.time_us, (record.flags & CAPTURE_TX) ? "TX" : "RX",
+             (record.flags & CAPTURE_CHECKSUM_OK) ? "ok " : "bad", format_hex_pretty(record.data, length).c_str());
+  }
+}
+
+void TclAcClimate::clear_capture() {
+  if (!this->link_.get_capture().clear())
+    ESP_LOGW(TAG, "Capture not cleared, it is being downloaded");
+}
+
 climate::ClimateTraits TclAcClimate::traits() {
   auto traits = climate::ClimateTraits();
   
   // Supported modes (VALIDATED from log)
-  traits.set_supported_modes({
-    climate::CLIMATE_MODE_OFF,
-    climate::CLIMATE_MODE_COOL,      // MODE_COOLING - 44x in log
-    climate::CLIMATE_MODE_HEAT,      // MODE_HEATING - 6x in log
-    climate::CLIMATE_MODE_DRY,       // MODE_DRY - 1x in log
-    climate::CLIMATE_MODE_FAN_ONLY,  // MODE_FAN - theoretical
-    climate::CLIMATE_MODE_AUTO,      // MODE_AUTO - 1x with ECO in log
-  });
+  if (ActiveModel::HAS_MODE) {
+    traits.set_supported_modes({
+      climate::CLIMATE_MODE_OFF,
+      climate::CLIMATE_MODE_COOL,      // MODE_COOLING - 44x in log
+      climate::CLIMATE_MODE_HEAT,      // MODE_HEATING - 6x in log
+      climate::CLIMATE_MODE_DRY,       // MODE_DRY - 1x in log
+      climate::CLIMATE_MODE_FAN_ONLY,  // MODE_FAN - theoretical
+      climate::CLIMATE_MODE_AUTO,      // MODE_AUTO - 1x with ECO in log
+    });
+  } else {
+    // Model A frames only carry power: on is the one mode status frames report
+    traits.set_supported_modes({climate::CLIMATE_MODE_OFF, ModelA::ON_MODE});
+  }
   
   // Fan modes (mapped to fan speeds)
   traits.set_supported_fan_modes({
-    climate::CLIMATE_FAN_AUTO,     // FAN_SPEED_AUTO
-    climate::CLIMATE_FAN_LOW,      // FAN_SPEED_LOW (83% in log)
-    climate::CLIMATE_FAN_MEDIUM,   // FAN_SPEED_MEDIUM
-    climate::CLIMATE_FAN_HIGH,     // FAN_SPEED_HIGH/MAX
+    climate::CLIMATE_FAN_AUTO,     // Speed 0
+    climate::CLIMATE_FAN_LOW,      // Speed 1 (83% in log)
+    climate::CLIMATE_FAN_MEDIUM,   // Speed 3
+    climate::CLIMATE_FAN_HIGH,     // Speed 7
   });
   
   // Presets (special modes)
@@ -179,36 +479,7 @@ void TclAcClimate::control(const climate::ClimateCall &call) {
   
   // Handle preset change
   if (call.get_preset().has_value()) {
-    climate::ClimatePreset preset = *call.get_preset();
-    
-    // Reset all preset flags
-    this->eco_mode_ = false;
-    this->turbo_mode_ = false;
-    this->quiet_mode_ = false;
-    
-    // Set the appropriate flag
-    switch (preset) {
-      case climate::CLIMATE_PRESET_ECO:
-        this->eco_mode_ = true;
-        // ECO only works with AUTO mode (observed in log)
-        if (this->mode != climate::CLIMATE_MODE_OFF) {
-          this->mode = climate::CLIMATE_MODE_AUTO;
-        }
-        break;
-      case climate::CLIMATE_PRESET_BOOST:
-        this->turbo_mode_ = true;
-        break;
-      case climate::CLIMATE_PRESET_COMFORT:
-        this->quiet_mode_ = true;
-        break;
-      case climate::CLIMATE_PRESET_SLEEP:
-        // Sleep mode is handled separately in packet creation
-        break;
-      default:
-        break;
-    }
-    
-    this->preset = preset;
+    this->apply_preset_(*call.get_preset());
   }
   
   // Handle swing mode change
@@ -216,654 +487,515 @@ void TclAcClimate::control(const climate::ClimateCall &call) {
     this->swing_mode = *call.get_swing_mode();
   }
   
-  // Publish updated state
-  this->publish_state();
+  // Optimistic: the requested state is published right away. It stays until
+  // a status frame confirms the SET (the reported state takes over from
+  // then) or the SET fails, which rolls it back to the reported state.
+  this->publish_now_();
   
-  // Send control packet to AC
-  if (this->mode != climate::CLIMATE_MODE_OFF) {
-    uint8_t packet[SET_PACKET_SIZE];
-    this->create_set_packet_(packet);
-    this->send_packet_(packet, SET_PACKET_SIZE);
-    ESP_LOGD(TAG, "Sent SET packet to AC");
-  } else {
-    // Send power off packet (simplified set packet with specific flags)
-    uint8_t packet[SET_PACKET_SIZE];
-    memset(packet, 0, SET_PACKET_SIZE);
-    packet[0] = HEADER_MCU_TO_AC_0;
-    packet[1] = HEADER_MCU_TO_AC_1;
-    packet[2] = HEADER_MCU_TO_AC_2;
-    packet[3] = CMD_SET_PARAMS;
-    packet[4] = 0x20;  // 32 data bytes
-    packet[5] = 0x03;
-    packet[6] = 0x01;
-    packet[7] = 0x00;  // Mode byte = 0x00 indicates power off (observed as 0x20 in one packet)
-    packet[SET_PACKET_SIZE - 1] = this->calculate_checksum_(packet, SET_PACKET_SIZE - 1);
-    this->send_packet_(packet, SET_PACKET_SIZE);
-    ESP_LOGD(TAG, "Sent POWER OFF packet to AC");
-  }
+  // Send control packet to AC (power off is a simplified set packet)
+  this->request_set_(this->mode == climate::CLIMATE_MODE_OFF);
 }
 
-void TclAcClimate::create_set_packet_(uint8_t *packet) {
-  // COMPLETE TCLAC PROTOCOL IMPLEMENTATION
-  // Based on https://github.com/Kannix2005/tclac Lines 393-711
-  
-  memset(packet, 0, SET_PACKET_SIZE);
-  
-  // Header (bytes 0-2)
-  packet[0] = HEADER_MCU_TO_AC_0;  // 0xBB
-  packet[1] = HEADER_MCU_TO_AC_1;  // 0x00
-  packet[2] = HEADER_MCU_TO_AC_2;  // 0x01
-  
-  // Command and length (bytes 3-4)
-  packet[3] = CMD_SET_PARAMS;  // 0x03 = control
-  packet[4] = 0x20;  // 32 data bytes (decimal 32)
-  
-  // Data payload starts at offset 5
-  packet[5] = 0x03;
-  packet[6] = 0x01;
-  
-  // Initialize control bytes to zero (will be built up with bit operations)
-  packet[7]  = 0x00;  // Mode/Power/Display/Beeper/ECO
-  packet[8]  = 0x00;  // Mode details/Quiet/Turbo/Health
-  packet[9]  = 0x00;  // Temperature (will be set below)
-  packet[10] = 0x00;  // Fan speed/Swing vertical
-  packet[11] = 0x00;  // Swing horizontal
-  packet[12] = 0x00;  // Fahrenheit/Timer
-  packet[13] = 0x01;  // Fixed
-  packet[14] = 0x00;  // Half degree
-  packet[15] = 0x00;
-  packet[16] = 0x00;
-  packet[17] = 0x00;
-  packet[18] = 0x00;
-  packet[19] = 0x00;  // Sleep mode
-  packet[20] = 0x00;
-  packet[21] = 0x00;
-  packet[22] = 0x00;
-  packet[23] = 0x00;
-  packet[24] = 0x00;
-  packet[25] = 0x00;
-  packet[26] = 0x00;
-  packet[27] = 0x00;
-  packet[28] = 0x00;
-  packet[29] = 0x20;  // Fixed
-  packet[30] = 0x00;
-  packet[31] = 0x00;
-  packet[32] = 0x00;  // Vertical swing mode + airflow position
-  packet[33] = 0x00;  // Horizontal swing mode + airflow position
-  packet[34] = 0x00;
-  packet[35] = 0x00;
-  packet[36] = 0x00;
-  
-  // ========== Byte 7: Power/Display/Beeper/ECO ==========
-  // Bit 7 (0x80): ECO mode
-  // Bit 6 (0x40): DISPLAY
-  // Bit 5 (0x20): BEEPER
-  // Bit 2 (0x04): POWER ON
-  
-  if (this->eco_mode_) {
-    packet[7] += 0b10000000;  // ECO mode
-    ESP_LOGD(TAG, "ECO mode enabled");
-  }
-  
-  if (this->display_state_) {
-    packet[7] += 0b01000000;  // Display ON
-    ESP_LOGD(TAG, "Display ON");
-  }
-  
-  if (this->beeper_state_) {
-    packet[7] += 0b00100000;  // Beeper ON
-    ESP_LOGD(TAG, "Beeper ON");
-  }
-  
-  // ========== Configure operating mode (TCLAC Lines 429-460) ==========
-  switch (this->mode) {
-    case climate::CLIMATE_MODE_OFF:
-      packet[7] += 0b00000000;
-      packet[8] += 0b00000000;
-      ESP_LOGD(TAG, "Mode: OFF");
-      break;
-    case climate::CLIMATE_MODE_AUTO:
-      packet[7] += 0b00000100;  // Power ON
-      packet[8] += 0b00001000;  // AUTO mode
-      ESP_LOGD(TAG, "Mode: AUTO");
-      break;
-    case climate::CLIMATE_MODE_COOL:
-      packet[7] += 0b00000100;  // Power ON
-      packet[8] += 0b00000011;  // COOL mode
-      ESP_LOGD(TAG, "Mode: COOL");
+void TclAcClimate::apply_preset_(climate::ClimatePreset preset) {
+  // Reset all preset flags
+  this->eco_mode_ = false;
+  this->turbo_mode_ = false;
+  this->quiet_mode_ = false;
+  
+  // Set the appropriate flag
+  switch (preset) {
+    case climate::CLIMATE_PRESET_ECO:
+      this->eco_mode_ = true;
+      // ECO only works with AUTO mode (observed in log)
+      if (ActiveModel::HAS_MODE && this->mode != climate::CLIMATE_MODE_OFF) {
+        this->mode = climate::CLIMATE_MODE_AUTO;
+      }
       break;
-    case climate::CLIMATE_MODE_DRY:
-      packet[7] += 0b00000100;  // Power ON
-      packet[8] += 0b00000010;  // DRY mode
-      ESP_LOGD(TAG, "Mode: DRY");
+    case climate::CLIMATE_PRESET_BOOST:
+      this->turbo_mode_ = true;
       break;
-    case climate::CLIMATE_MODE_FAN_ONLY:
-      packet[7] += 0b00000100;  // Power ON
-      packet[8] += 0b00000111;  // FAN mode
-      ESP_LOGD(TAG, "Mode: FAN_ONLY");
+    case climate::CLIMATE_PRESET_COMFORT:
+      this->quiet_mode_ = true;
       break;
-    case climate::CLIMATE_MODE_HEAT:
-      packet[7] += 0b00000100;  // Power ON
-      packet[8] += 0b00000001;  // HEAT mode
-      ESP_LOGD(TAG, "Mode: HEAT");
+    case climate::CLIMATE_PRESET_SLEEP:
+      // Sleep mode is handled separately in packet creation
       break;
     default:
-      packet[7] += 0b00000100;
-      packet[8] += 0b00000011;  // Default COOL
-      ESP_LOGD(TAG, "Mode: DEFAULT (COOL)");
       break;
   }
-
-  // ========== Byte 8: Quiet/Turbo/Health/Mode details ==========
-  // Bit 7 (0x80): QUIET mode
-  // Bit 6 (0x40): TURBO mode
-  // Bit 5 (0x20): HEALTH mode
-  // Bits 0-4: Mode details (already set above)
   
-  if (this->quiet_mode_) {
-    packet[8] += 0b10000000;  // QUIET
-    ESP_LOGD(TAG, "QUIET mode enabled");
+  this->preset = preset;
+}
+
+void TclAcClimate::apply(const AcStateUpdate &update) {
+  ESP_LOGD(TAG, "Applying state update");
+  if (update.mode.has_value()) {
+    this->mode = *update.mode;
+    // Not checked against traits() like a climate call; without a mode field only power is ours
+    if (!ActiveModel::HAS_MODE && this->mode != climate::CLIMATE_MODE_OFF)
+      this->mode = ModelA::ON_MODE;
   }
+  if (update.target_temperature.has_value())
+    this->target_temperature = *update.target_temperature;
+  if (update.fan_mode.has_value())
+    this->fan_mode = *update.fan_mode;
+  if (update.preset.has_value())
+    this->apply_preset_(*update.preset);  // After mode: ECO forces AUTO
+  if (update.swing_mode.has_value())
+    this->swing_mode = *update.swing_mode;
+  if (update.vertical_airflow.has_value())
+    this->vertical_airflow_ = *update.vertical_airflow;
+  if (update.horizontal_airflow.has_value())
+    this->horizontal_airflow_ = *update.horizontal_airflow;
+  if (update.vertical_swing.has_value())
+    this->vertical_swing_ = *update.vertical_swing;
+  if (update.horizontal_swing.has_value())
+    this->horizontal_swing_ = *update.horizontal_swing;
+  if (update.display_state.has_value())
+    this->display_state_ = *update.display_state;
+  if (update.beeper_state.has_value())
+    this->beeper_state_ = *update.beeper_state;
+  if (update.health_mode.has_value())
+    this->health_mode_ = *update.health_mode;
   
-  if (this->turbo_mode_) {
-    packet[8] += 0b01000000;  // TURBO
-    ESP_LOGD(TAG, "TURBO mode enabled");
-  }
+  this->publish_now_();
+  
+  this->invalidate_payload_cache_();
   
-  if (this->health_mode_) {
-    packet[8] += 0b00100000;  // HEALTH
-    ESP_LOGD(TAG, "HEALTH mode enabled");
+  // Sent right away; anything still waiting in the coalescing window is
+  // already part of this state and needs no frame of its own
+  if (this->set_pending_changes_ > 0) {
+    this->coalesce_saved_ += this->set_pending_changes_;
+    this->set_pending_changes_ = 0;
   }
-
-  // ========== Configure fan mode (TCLAC Lines 462-496) ==========
-  switch (this->fan_mode.value_or(climate::CLIMATE_FAN_AUTO)) {
-    case climate::CLIMATE_FAN_AUTO:
-      packet[8]  += 0b00000000;
-      packet[10] += 0b00000000;
-      ESP_LOGD(TAG, "Fan: AUTO");
-      break;
-    case climate::CLIMATE_FAN_QUIET:
-      packet[8]  += 0b10000000;
-      packet[10] += 0b00000000;
-      ESP_LOGD(TAG, "Fan: QUIET");
-      break;
-    case climate::CLIMATE_FAN_LOW:
-      packet[8]  += 0b00000000;
-      packet[10] += 0b00000001;
-      ESP_LOGD(TAG, "Fan: LOW");
-      break;
-    case climate::CLIMATE_FAN_MIDDLE:
-      packet[8]  += 0b00000000;
-      packet[10] += 0b00000110;
-      ESP_LOGD(TAG, "Fan: MIDDLE");
-      break;
-    case climate::CLIMATE_FAN_MEDIUM:
-      packet[8]  += 0b00000000;
-      packet[10] += 0b00000011;
-      ESP_LOGD(TAG, "Fan: MEDIUM");
-      break;
-    case climate::CLIMATE_FAN_HIGH:
-      packet[8]  += 0b00000000;
-      packet[10] += 0b00000111;
-      ESP_LOGD(TAG, "Fan: HIGH");
-      break;
-    case climate::CLIMATE_FAN_FOCUS:
-      packet[8]  += 0b00000000;
-      packet[10] += 0b00000101;
-      ESP_LOGD(TAG, "Fan: FOCUS");
-      break;
-    case climate::CLIMATE_FAN_DIFFUSE:
-      packet[8]  += 0b01000000;
-      packet[10] += 0b00000000;
-      ESP_LOGD(TAG, "Fan: DIFFUSE");
-      break;
-    default:
-      packet[8]  += 0b00000000;
-      packet[10] += 0b00000000;
-      ESP_LOGD(TAG, "Fan: DEFAULT (AUTO)");
-      break;
+  if (this->send_set_packet_(this->mode == climate::CLIMATE_MODE_OFF, this->current_settings_())) {
+    ESP_LOGD(TAG, "Queued %s packet to AC for state update",
+             this->mode == climate::CLIMATE_MODE_OFF ? "POWER OFF" : "SET");
   }
+}
 
-  // ========== Configure swing mode (TCLAC Lines 498-515) ==========
-  // ESPHome's built-in swing modes (VERTICAL/HORIZONTAL/BOTH/OFF)
-  switch (this->swing_mode) {
-    case climate::CLIMATE_SWING_OFF:
-      packet[10] += 0b00000000;
-      packet[11] += 0b00000000;
-      ESP_LOGD(TAG, "Swing: OFF");
-      break;
-    case climate::CLIMATE_SWING_VERTICAL:
-      packet[10] += 0b00111000;  // Vertical swing ON
-      packet[11] += 0b00000000;
-      ESP_LOGD(TAG, "Swing: VERTICAL");
-      break;
-    case climate::CLIMATE_SWING_HORIZONTAL:
-      packet[10] += 0b00000000;
-      packet[11] += 0b00001000;  // Horizontal swing ON
-      ESP_LOGD(TAG, "Swing: HORIZONTAL");
-      break;
-    case climate::CLIMATE_SWING_BOTH:
-      packet[10] += 0b00111000;  // Both swings ON
-      packet[11] += 0b00001000;
-      ESP_LOGD(TAG, "Swing: BOTH");
-      break;
-    default:
-      packet[10] += 0b00000000;
-      packet[11] += 0b00000000;
-      ESP_LOGD(TAG, "Swing: DEFAULT (OFF)");
-      break;
-  }
+void TclAcClimate::request_set_(bool power_off) {
+  this->invalidate_payload_cache_();
+  // Every change carries the full state, so a burst only needs its last frame
+  uint32_t now = millis();
+  if (this->set_pending_changes_ == 0)
+    this->set_first_change_ = now;
+  this->set_last_change_ = now;
+  this->set_pending_changes_++;
+  this->set_power_off_ = power_off;
+  // Taken now: a frame from the AC may change the climate before the flush
+  this->set_requested_ = this->current_settings_();
+  this->wake_loop_();
+}
 
-  // ========== Configure presets (TCLAC Lines 517-530) ==========
-  switch (this->preset.value_or(climate::CLIMATE_PRESET_NONE)) {
-    case climate::CLIMATE_PRESET_NONE:
-      break;
-    case climate::CLIMATE_PRESET_ECO:
-      packet[7] += 0b10000000;  // ECO flag (duplicate but safe)
-      ESP_LOGD(TAG, "Preset: ECO");
-      break;
-    case climate::CLIMATE_PRESET_SLEEP:
-      packet[19] += 0b00000001;  // Sleep mode
-      ESP_LOGD(TAG, "Preset: SLEEP");
-      break;
-    case climate::CLIMATE_PRESET_COMFORT:
-      packet[8] += 0b00010000;  // Comfort/Health flag
-      ESP_LOGD(TAG, "Preset: COMFORT");
-      break;
-    default:
-      break;
+void TclAcClimate::flush_set_() {
+  if (this->set_pending_changes_ == 0)
+    return;
+  
+  // Wait until the burst has been quiet for one window, but never longer
+  // than COALESCE_MAX_WINDOWS windows after its first change
+  uint32_t now = millis();
+  if (now - this->set_last_change_ < this->coalesce_window_ &&
+      now - this->set_first_change_ < this->coalesce_window_ * COALESCE_MAX_WINDOWS)
+    return;
+  
+  if (this->send_set_packet_(this->set_power_off_, this->set_requested_)) {
+    this->coalesce_bursts_++;
+    this->coalesce_saved_ += this->set_pending_changes_ - 1;
+    ESP_LOGD(TAG, "Queued %s packet to AC: %u change(s) in %u ms, %u write(s) saved so far",
+             this->set_power_off_ ? "POWER OFF" : "SET", (unsigned) this->set_pending_changes_,
+             (unsigned) (now - this->set_first_change_), (unsigned) this->coalesce_saved_);
   }
+  this->set_pending_changes_ = 0;
+}
 
-  // ========== Temperature (TCLAC Line 668) ==========
-  packet[9] = 111 - (int)(this->target_temperature + 0.5f);
-  ESP_LOGD(TAG, "Temperature: %.1f°C -> raw 0x%02X", this->target_temperature, packet[9]);
-
-  // ========== Vertical Swing Direction (TCLAC Lines 559-580) ==========
-  // Byte 32 bits 3-4 (mask 0b00011000): Swing direction
-  //   00 = OFF, 01 = UP_DOWN, 10 = UPSIDE, 11 = DOWNSIDE
-  switch (this->vertical_swing_) {
-    case VerticalSwingDirection::OFF:
-      packet[32] += 0b00000000;
-      ESP_LOGD(TAG, "Vertical swing direction: OFF");
-      break;
-    case VerticalSwingDirection::UP_DOWN:
-      packet[32] += 0b00001000;
-      ESP_LOGD(TAG, "Vertical swing direction: UP_DOWN");
-      break;
-    case VerticalSwingDirection::UPSIDE:
-      packet[32] += 0b00010000;
-      ESP_LOGD(TAG, "Vertical swing direction: UPSIDE");
-      break;
-    case VerticalSwingDirection::DOWNSIDE:
-      packet[32] += 0b00011000;
-      ESP_LOGD(TAG, "Vertical swing direction: DOWNSIDE");
-      break;
+bool TclAcClimate::send_set_packet_(bool power_off, const AcSettings &settings) {
+  uint8_t packet[SET_PACKET_SIZE];
+  if (power_off) {
+    encode_power_off_packet(packet);
+  } else {
+    encode_set_packet(settings, packet);
   }
-
-  // ========== Horizontal Swing Direction (TCLAC Lines 582-606) ==========
-  // Byte 33 bits 3-5 (mask 0b00111000): Swing direction
-  switch (this->horizontal_swing_) {
-    case HorizontalSwingDirection::OFF:
-      packet[33] += 0b00000000;
-      ESP_LOGD(TAG, "Horizontal swing direction: OFF");
-      break;
-    case HorizontalSwingDirection::LEFT_RIGHT:
-      packet[33] += 0b00001000;
-      ESP_LOGD(TAG, "Horizontal swing direction: LEFT_RIGHT");
-      break;
-    case HorizontalSwingDirection::LEFTSIDE:
-      packet[33] += 0b00010000;
-      ESP_LOGD(TAG, "Horizontal swing direction: LEFTSIDE");
-      break;
-    case HorizontalSwingDirection::CENTER:
-      packet[33] += 0b00011000;
-      ESP_LOGD(TAG, "Horizontal swing direction: CENTER");
-      break;
-    case HorizontalSwingDirection::RIGHTSIDE:
-      packet[33] += 0b00100000;
-      ESP_LOGD(TAG, "Horizontal swing direction: RIGHTSIDE");
-      break;
+  
+  // The AC already confirmed exactly this frame; sending it again would only
+  // occupy the bus for 44 ms and make the unit beep
+  if (!this->force_mode_ && this->set_acked_valid_ && memcmp(packet, this->set_acked_, SET_PACKET_SIZE) == 0) {
+    this->sets_suppressed_++;
+    ESP_LOGD(TAG, "%s packet unchanged since the AC confirmed it, not sent (%u suppressed)",
+             power_off ? "POWER OFF" : "SET", (unsigned) this->sets_suppressed_);
+    return false;
   }
+  
+  this->tracker_.start(packet, millis());
+  this->send_packet_(packet, SET_PACKET_SIZE);
+  return true;
+}
 
-  // ========== Vertical Airflow Position (TCLAC Lines 608-628) ==========
-  // Byte 32 bits 0-2 (mask 0b00000111): Fixed position
-  //   000 = LAST, 001 = MAX_UP, 010 = UP, 011 = CENTER, 100 = DOWN, 101 = MAX_DOWN
-  switch (this->vertical_airflow_) {
-    case AirflowVerticalDirection::LAST:
-      packet[32] += 0b00000000;
-      ESP_LOGD(TAG, "Vertical airflow: LAST");
-      break;
-    case AirflowVerticalDirection::MAX_UP:
-      packet[32] += 0b00000001;
-      ESP_LOGD(TAG, "Vertical airflow: MAX_UP");
-      break;
-    case AirflowVerticalDirection::UP:
-      packet[32] += 0b00000010;
-      ESP_LOGD(TAG, "Vertical airflow: UP");
-      break;
-    case AirflowVerticalDirection::CENTER:
-      packet[32] += 0b00000011;
-      ESP_LOGD(TAG, "Vertical airflow: CENTER");
+void TclAcClimate::check_command_() {
+  switch (this->tracker_.check(millis())) {
+    case CommandTracker::Event::RETRANSMIT:
+      this->invalidate_payload_cache_();
+      this->send_packet_(this->tracker_.packet(), SET_PACKET_SIZE);
+      this->publish_command_stats_();
       break;
-    case AirflowVerticalDirection::DOWN:
-      packet[32] += 0b00000100;
-      ESP_LOGD(TAG, "Vertical airflow: DOWN");
+    case CommandTracker::Event::FAILED:
+      this->invalidate_payload_cache_();
+      this->roll_back_();
+      this->publish_command_stats_();
       break;
-    case AirflowVerticalDirection::MAX_DOWN:
-      packet[32] += 0b00000101;
-      ESP_LOGD(TAG, "Vertical airflow: MAX_DOWN");
+    default:
       break;
   }
+}
 
-  // ========== Horizontal Airflow Position (TCLAC Lines 630-656) ==========
-  // Byte 33 bits 0-2 (mask 0b00000111): Fixed position
-  switch (this->horizontal_airflow_) {
-    case AirflowHorizontalDirection::LAST:
-      packet[33] += 0b00000000;
-      ESP_LOGD(TAG, "Horizontal airflow: LAST");
-      break;
-    case AirflowHorizontalDirection::MAX_LEFT:
-      packet[33] += 0b00000001;
-      ESP_LOGD(TAG, "Horizontal airflow: MAX_LEFT");
-      break;
-    case AirflowHorizontalDirection::LEFT:
-      packet[33] += 0b00000010;
-      ESP_LOGD(TAG, "Horizontal airflow: LEFT");
-      break;
-    case AirflowHorizontalDirection::CENTER:
-      packet[33] += 0b00000011;
-      ESP_LOGD(TAG, "Horizontal airflow: CENTER");
-      break;
-    case AirflowHorizontalDirection::RIGHT:
-      packet[33] += 0b00000100;
-      ESP_LOGD(TAG, "Horizontal airflow: RIGHT");
-      break;
-    case AirflowHorizontalDirection::MAX_RIGHT:
-      packet[33] += 0b00000101;
-      ESP_LOGD(TAG, "Horizontal airflow: MAX_RIGHT");
-      break;
+void TclAcClimate::roll_back_() {
+  // A newer change is about to be sent; it replaces the failed one
+  if (this->set_pending_changes_ > 0)
+    return;
+  if (!this->has_reported_) {
+    ESP_LOGW(TAG, "No status from the AC yet, keeping the requested state");
+    return;
   }
   
-  // ========== Checksum (last byte) ==========
-  packet[SET_PACKET_SIZE - 1] = this->calculate_checksum_(packet, SET_PACKET_SIZE - 1);
-  
-  ESP_LOGD(TAG, "Created complete SET packet with TCLAC protocol");
+  const AcSettings &requested = this->tracker_.get_requested();
+  uint16_t diff = settings_diff(requested, this->reported_);
+  if (requested.mode == climate::CLIMATE_MODE_OFF)
+    diff &= FIELD_MODE;  // The power-off frame carries nothing else
+  char fields[96];
+  format_settings_diff(diff, fields, sizeof(fields));
+  this->rollbacks_++;
+  ESP_LOGW(TAG, "AC did not take the requested %s, rolling back to the reported state (%u rollback(s))",
+           fields[0] != '\0' ? fields : "settings", (unsigned) this->rollbacks_);
+  this->apply_reported_settings_(this->reported_);
+  this->publish_if_changed_();
+}
+
+void TclAcClimate::publish_command_stats_() {
+#ifdef USE_SENSOR
+  const CommandTracker &tracker = this->tracker_;
+  if (this->command_rtt_median_sensor_ != nullptr && tracker.get_rtt().get_total() > 0)
+    this->command_rtt_median_sensor_->publish_state(tracker.get_rtt().percentile(0.5f));
+  if (this->command_rtt_p95_sensor_ != nullptr && tracker.get_rtt().get_total() > 0)
+    this->command_rtt_p95_sensor_->publish_state(tracker.get_rtt().percentile(0.95f));
+  if (this->command_retransmits_sensor_ != nullptr)
+    this->command_retransmits_sensor_->publish_state(tracker.get_retransmits());
+  if (this->command_failures_sensor_ != nullptr)
+    this->command_failures_sensor_->publish_state(tracker.get_failures());
+#endif
+}
+
+AcSettings TclAcClimate::current_settings_() const {
+  AcSettings settings;
+  settings.mode = this->mode;
+  settings.target_temperature = this->target_temperature;
+  settings.fan_mode = this->fan_mode.value_or(climate::CLIMATE_FAN_AUTO);
+  settings.preset = this->preset.value_or(climate::CLIMATE_PRESET_NONE);
+  settings.swing_mode = this->swing_mode;
+  settings.eco_mode = this->eco_mode_;
+  settings.turbo_mode = this->turbo_mode_;
+  settings.quiet_mode = this->quiet_mode_;
+  settings.health_mode = this->health_mode_;
+  settings.display_state = this->display_state_;
+  settings.beeper_state = this->beeper_state_;
+  settings.vertical_swing = this->vertical_swing_;
+  settings.horizontal_swing = this->horizontal_swing_;
+  settings.vertical_airflow = this->vertical_airflow_;
+  settings.horizontal_airflow = this->horizontal_airflow_;
+  return settings;
+}
+
+void TclAcClimate::create_set_packet_(uint8_t *packet) {
+  encode_set_packet(this->current_settings_(), packet);
 }
 
 void TclAcClimate::send_packet_(const uint8_t *packet, size_t length) {
-  // Log packet for debugging
-  ESP_LOGV(TAG, "Sending packet (%d bytes):", length);
-  for (size_t i = 0; i < length; i++) {
-    ESP_LOGV(TAG, "  [%02d] 0x%02X", i, packet[i]);
-  }
-  
-  // Send via UART
-  this->write_array(packet, length);
-  this->flush();
-  this->last_transmit_ = millis();
+  // Never blocks: the link queues the frame and feeds the UART from loop()
+  this->link_.send(packet, length);
+  this->wake_loop_();
 }
 
 void TclAcClimate::send_poll_packet_() {
-  uint8_t packet[POLL_PACKET_SIZE] = {
-    HEADER_MCU_TO_AC_0,
-    HEADER_MCU_TO_AC_1,
-    HEADER_MCU_TO_AC_2,
-    CMD_POLL,
-    0x01,  // Length
-    0x00,  // Data
-    0x00   // Checksum (will be calculated)
-  };
-  
-  packet[POLL_PACKET_SIZE - 1] = this->calculate_checksum_(packet, POLL_PACKET_SIZE - 1);
-  this->send_packet_(packet, POLL_PACKET_SIZE);
-  ESP_LOGV(TAG, "Sent POLL packet");
+  this->link_.send_poll();
+  this->wake_loop_();
 }
 
-uint8_t TclAcClimate::calculate_checksum_(const uint8_t *data, size_t length) {
-  // XOR checksum - VALIDATED from log analysis
-  uint8_t checksum = 0;
-  for (size_t i = 0; i < length; i++) {
-    checksum ^= data[i];
+void TclAcClimate::parse_status_packet_(const uint8_t *data, size_t length) {
+  StatusData status;
+  if (!decode_status(data, length, &status)) {
+    ESP_LOGW(TAG, "Status packet too short: %u bytes", (unsigned) length);
+    return;
+  }
+  
+  if (status.has_room_temperature) {
+    this->current_temperature = status.room_temperature;
+    this->precise_room_temperature_ = !status.room_temperature_fallback;
+    if (status.room_temperature_fallback) {
+      ESP_LOGD(TAG, "Room temperature (fallback byte[30]) raw=0x%02X -> %.1f°C", data[30], status.room_temperature);
+    } else {
+      ESP_LOGD(TAG, "Room temperature (16-bit) data[12:13]=0x%02X%02X -> %.1f°C", data[12], data[13],
+               status.room_temperature);
+    }
   }
-  return checksum;
+  
+  if (this->tracker_.pending() &&
+      this->tracker_.on_status(data, length, millis()) == CommandTracker::Event::CONFIRMED) {
+    ESP_LOGD(TAG, "AC confirmed SET in %u ms", (unsigned) this->tracker_.get_last_rtt());
+    memcpy(this->set_acked_, this->tracker_.packet(), SET_PACKET_SIZE);
+    this->set_acked_valid_ = true;
+    this->publish_command_stats_();
+  }
+  
+  // The rest of the frame has the SET layout: the unit's actual settings,
+  // including changes made with the IR remote. They are always kept as the
+  // reported state, but while a SET of ours is unconfirmed the climate state
+  // stays optimistic: the frame may predate the SET and must not undo it.
+  if (!this->has_reported_)
+    this->reported_ = this->current_settings_();
+  decode_settings(data, length, &this->reported_);
+  this->has_reported_ = true;
+  this->reconcile_reported_();
+  
+  ESP_LOGD(TAG, "Status update - Mode: %u, Target: %.1f°C, Fan: %u, ECO: %d, Turbo: %d, Quiet: %d",
+           (unsigned) this->mode, this->target_temperature, (unsigned) this->fan_mode.value_or(climate::CLIMATE_FAN_AUTO),
+           this->eco_mode_, this->turbo_mode_, this->quiet_mode_);
+  
+  this->publish_if_changed_();
 }
 
-void TclAcClimate::parse_status_packet_(const uint8_t *data, size_t length) {
-  if (length < 32) {
-    ESP_LOGW(TAG, "Status packet too short: %d bytes", length);
+bool TclAcClimate::set_in_flight_() const {
+  // Waiting in the coalescing window, queued, not yet confirmed, or sent so
+  // recently that a status frame the AC had already started may still be arriving
+  static const uint32_t STATUS_FRAME_MS = (FRAME_OVERHEAD + STATUS_DATA_SIZE) * UART_BYTE_TIME_US / 1000 + 1;
+  return this->set_pending_changes_ > 0 || !this->link_.tx_idle() || this->tracker_.pending() ||
+         (this->has_sent_set_ && (int32_t) (millis() - this->last_set_sent_) < (int32_t) STATUS_FRAME_MS);
+}
+
+void TclAcClimate::reconcile_reported_() {
+  if (this->set_in_flight_()) {
+    ESP_LOGV(TAG, "Reported settings not applied, SET in flight");
+    this->invalidate_payload_cache_();  // Decode it again once the SET is through
     return;
   }
+  this->apply_reported_settings_(this->reported_);
+}
+
+void TclAcClimate::apply_reported_settings_(const AcSettings &reported) {
+  uint8_t before[SET_PACKET_SIZE];
+  this->create_set_packet_(before);
   
-  // Parse status data based on 55-byte response format
-  // data[0-1]: Command specific data
-  // data[2]: Mode byte with flags
-  // data[3]: Speed byte with flags
+  if (this->mode != reported.mode) {
+    ESP_LOGD(TAG, "AC changed mode to: %u", (unsigned) reported.mode);
+    this->mode = reported.mode;
+  }
+  // A temperature byte that was never written (zero) decodes to no sensible setpoint
+  if (reported.target_temperature > 10.0f && reported.target_temperature < 40.0f &&
+      this->target_temperature != reported.target_temperature) {
+    ESP_LOGD(TAG, "AC changed target temperature to: %.0f°C", reported.target_temperature);
+    this->target_temperature = reported.target_temperature;
+  }
+  if (this->fan_mode != reported.fan_mode) {
+    ESP_LOGD(TAG, "AC changed fan mode to: %u", (unsigned) reported.fan_mode);
+    this->fan_mode = reported.fan_mode;
+  }
+  if (this->swing_mode != reported.swing_mode) {
+    ESP_LOGD(TAG, "AC changed swing mode to: %u", (unsigned) reported.swing_mode);
+    this->swing_mode = reported.swing_mode;
+  }
   
-  // Byte 2 (data[2]): Mode flags
-  uint8_t mode_byte = data[2];
-  bool display_on = (mode_byte & FLAG_DISPLAY_ON) != 0;
-  bool eco_on = (mode_byte & FLAG_ECO_MODE) != 0;
+  // Check if AC changed modes without our consent (e.g., auto-enabling ECO)
+  if (this->eco_mode_ != reported.eco_mode)
+    ESP_LOGD(TAG, "AC changed ECO mode to: %s", reported.eco_mode ? "ON" : "OFF");
+  if (this->turbo_mode_ != reported.turbo_mode)
+    ESP_LOGD(TAG, "AC changed TURBO mode to: %s", reported.turbo_mode ? "ON" : "OFF");
+  if (this->quiet_mode_ != reported.quiet_mode)
+    ESP_LOGD(TAG, "AC changed QUIET mode to: %s", reported.quiet_mode ? "ON" : "OFF");
+  if (this->health_mode_ != reported.health_mode)
+    ESP_LOGD(TAG, "AC changed HEALTH mode to: %s", reported.health_mode ? "ON" : "OFF");
+  if (this->display_state_ != reported.display_state)
+    ESP_LOGD(TAG, "AC changed display to: %s", reported.display_state ? "ON" : "OFF");
+  this->eco_mode_ = reported.eco_mode;
+  this->turbo_mode_ = reported.turbo_mode;
+  this->quiet_mode_ = reported.quiet_mode;
+  this->health_mode_ = reported.health_mode;
+  this->display_state_ = reported.display_state;
+  // The beeper bit only says whether the unit beeps on our SETs; it stays ours
   
-  // Byte 3 (data[3]): Speed flags
-  uint8_t speed_byte = data[3];
-  bool turbo_on = (speed_byte & FLAG_TURBO_MODE) != 0;
-  bool quiet_on = (speed_byte & FLAG_QUIET_MODE) != 0;
+  if (this->vertical_airflow_ != reported.vertical_airflow || this->vertical_swing_ != reported.vertical_swing) {
+    ESP_LOGD(TAG, "AC changed vertical louvre to: position %u, swing %u", (unsigned) reported.vertical_airflow,
+             (unsigned) reported.vertical_swing);
+    this->vertical_airflow_ = reported.vertical_airflow;
+    this->vertical_swing_ = reported.vertical_swing;
+  }
+  if (this->horizontal_airflow_ != reported.horizontal_airflow ||
+      this->horizontal_swing_ != reported.horizontal_swing) {
+    ESP_LOGD(TAG, "AC changed horizontal louvre to: position %u, swing %u", (unsigned) reported.horizontal_airflow,
+             (unsigned) reported.horizontal_swing);
+    this->horizontal_airflow_ = reported.horizontal_airflow;
+    this->horizontal_swing_ = reported.horizontal_swing;
+  }
   
-  // Check if AC changed modes without our consent (e.g., auto-enabling ECO)
-  bool eco_changed = (this->eco_mode_ != eco_on);
-  bool turbo_changed = (this->turbo_mode_ != turbo_on);
-  bool quiet_changed = (this->quiet_mode_ != quiet_on);
-  
-  // Update state
-  this->eco_mode_ = eco_on;
-  this->turbo_mode_ = turbo_on;
-  this->quiet_mode_ = quiet_on;
-  
-  // Log changes
-  if (eco_changed) {
-    ESP_LOGD(TAG, "AC changed ECO mode to: %s", eco_on ? "ON" : "OFF");
-  }
-  if (turbo_changed) {
-    ESP_LOGD(TAG, "AC changed TURBO mode to: %s", turbo_on ? "ON" : "OFF");
-  }
-  if (quiet_changed) {
-    ESP_LOGD(TAG, "AC changed QUIET mode to: %s", quiet_on ? "ON" : "OFF");
-  }
-  
- // Temperature parsing
-  // PACKET bytes [17:18] using:  (((raw16)/374 - 32) / 1.8)
-  //   // In this parser, "data" points to payload starting at PACKET byte 5, so:
-  //   PACKET[17] -> data[12]
-  //   PACKET[18] -> data[13]
-  // This method is preferred because it is stable across mode/power changes.
-  bool got_room_temp = false;
-  if (length >= 14) {
-    const uint16_t raw16 = ((uint16_t) data[12] << 8) | data[13];
-    const float room_c = (((float) raw16 / 374.0f) - 32.0f) / 1.8f;
-    if (room_c > -10.0f && room_c < 60.0f) {
-      this->current_temperature = room_c;
-      got_room_temp = true;
-      ESP_LOGD(TAG, "Room temperature (16-bit) data[12:13]=0x%02X%02X raw=%u -> %.1f°C",
-               data[12], data[13], raw16, room_c);
+  // Preset as apply_preset_() would have set it: sleep and comfort have
+  // their own fields, ECO and BOOST are the eco and turbo flags
+  climate::ClimatePreset preset = reported.preset;
+  if (preset == climate::CLIMATE_PRESET_NONE) {
+    if (reported.eco_mode) {
+      preset = climate::CLIMATE_PRESET_ECO;
+    } else if (reported.turbo_mode) {
+      preset = climate::CLIMATE_PRESET_BOOST;
     }
   }
+  if (this->preset != preset) {
+    ESP_LOGD(TAG, "AC changed preset to: %u", (unsigned) preset);
+    this->preset = preset;
+  }
+  
+  // Changed at the unit: the frame it confirmed last no longer describes it
+  uint8_t after[SET_PACKET_SIZE];
+  this->create_set_packet_(after);
+  if (memcmp(before, after, SET_PACKET_SIZE) != 0)
+    this->set_acked_valid_ = false;
+}
 
-  // Fallback (older single-byte heuristic)
-  if (!got_room_temp && length >= 55) {
-    const uint8_t ac_temp_raw = data[30];
-    if (ac_temp_raw >= 120 && ac_temp_raw <= 180) {
-      const float ac_temp = this->raw_to_celsius_(ac_temp_raw);
-      if (ac_temp > -10.0f && ac_temp < 60.0f) {
-        this->current_temperature = ac_temp;
-        ESP_LOGD(TAG, "Room temperature (fallback byte[30]) raw=0x%02X -> %.1f°C", ac_temp_raw, ac_temp);
-      }
-    }
+void TclAcClimate::parse_short_status_(const uint8_t *data, size_t length) {
+  climate::ClimateMode mode = this->mode;
+  if (!decode_short_status(data, length, &mode)) {
+    ESP_LOGW(TAG, "Short status too short: %u bytes", (unsigned) length);
+    return;
   }
+  this->short_status_frames_++;
   
-  ESP_LOGD(TAG, "Status update - Temp: %.1f°C, ECO: %d, Turbo: %d, Quiet: %d", 
-           this->target_temperature, eco_on, turbo_on, quiet_on);
+  // The short status layout is inferred, not captured: it is only believed
+  // once it has reported the same power and mode as the full status frames
+  if (!this->short_status_trusted_) {
+    if (!this->has_reported_ || mode != this->reported_.mode) {
+      this->short_status_matches_ = 0;
+      return;
+    }
+    if (++this->short_status_matches_ < SHORT_STATUS_TRUST)
+      return;
+    this->short_status_trusted_ = true;
+    ESP_LOGI(TAG, "Short status (0x09) agrees with status frames, using it for power and mode");
+  }
   
-  this->publish_state();
+  this->link_.note_status();
+  if (mode == this->mode || this->set_in_flight_())
+    return;
+  ESP_LOGD(TAG, "AC changed mode to: %u (short status)", (unsigned) mode);
+  this->mode = mode;
+  this->set_acked_valid_ = false;
+  this->publish_if_changed_();
 }
 
 void TclAcClimate::parse_temp_response_(const uint8_t *data, size_t length) {
-  if (length < 4) {
-    ESP_LOGW(TAG, "Temp response too short: %d bytes", length);
+  TempData temp;
+  if (!decode_temp_response(data, length, &temp)) {
+    ESP_LOGW(TAG, "Temp response too short: %u bytes", (unsigned) length);
     return;
   }
   
-// TEMP_RESPONSE encoding differs from STATUS.
-  // Byte 0: current temperature (raw - 7)
-  // Byte 2: target temperature  (raw - 12)
-  const uint8_t current_raw = data[0];
-  const uint8_t target_raw = data[2];
-
-  const float current_c = ((float) current_raw) - 7.0f;
-  if (current_c > -10.0f && current_c < 60.0f) {
-    this->current_temperature = current_c;
-    ESP_LOGD(TAG, "TEMP_RESPONSE current: raw=0x%02X -> %.1f°C", current_raw, current_c);
+  if (temp.has_current) {
+    ESP_LOGD(TAG, "TEMP_RESPONSE current: raw=0x%02X -> %.1f°C", data[0], temp.current_temperature);
+    // Whole degrees only: don't let it flap against the 16-bit status reading
+    // while the two agree within its resolution
+    if (!this->precise_room_temperature_ || std::isnan(this->current_temperature) ||
+        std::fabs(temp.current_temperature - this->current_temperature) >= 1.0f) {
+      this->current_temperature = temp.current_temperature;
+      this->precise_room_temperature_ = false;
+    }
   }
-
-  const float target_c = ((float) target_raw) - 12.0f;
-  if (target_c > 10.0f && target_c < 40.0f) {
-    this->target_temperature = target_c;
-    ESP_LOGD(TAG, "TEMP_RESPONSE target: raw=0x%02X -> %.1f°C", target_raw, target_c);
+  
+  if (temp.has_target) {
+    ESP_LOGD(TAG, "TEMP_RESPONSE target: raw=0x%02X -> %.1f°C", data[2], temp.target_temperature);
+    // Only the setpoint is in this frame; the rest stays as last reported
+    if (!this->has_reported_)
+      this->reported_ = this->current_settings_();
+    this->reported_.target_temperature = temp.target_temperature;
+    this->reconcile_reported_();
   }
 
-  this->publish_state();
+  this->publish_if_changed_();
 }
 
 void TclAcClimate::parse_power_response_(const uint8_t *data, size_t length) {
-  // CMD_POWER (0x0A) packet structure:
-  // - Payload length: 45 bytes
-  // - Byte[0]: Always 0x04 (unknown)
-  // - Byte[1]: Always 0x00 (unknown)
-  // - Byte[2]: POWER FLAG - 0x04=OFF, 0x0C=ON
-  // - Byte[3]: Secondary flag (0x00 or 0x01, rare)
-  // - Rest: Mostly zeros
-  
   if (length < 3) {
-    ESP_LOGW(TAG, "Power response too short: %d bytes", length);
+    ESP_LOGW(TAG, "Power response too short: %u bytes", (unsigned) length);
     return;
   }
   
-  uint8_t power_flag = data[2];  // Byte[2] in payload
-  
   ESP_LOGD(TAG, "Power packet: Byte[0]=0x%02X, Byte[1]=0x%02X, Byte[2]=0x%02X", 
-           data[0], data[1], power_flag);
-  
-  if (power_flag == 0x04) {
-    // Power OFF
-    if (this->mode != climate::CLIMATE_MODE_OFF) {
-      ESP_LOGI(TAG, "AC Power Status: OFF (from CMD_POWER packet)");
-      this->mode = climate::CLIMATE_MODE_OFF;
-      this->publish_state();
-    }
-  } else if (power_flag == 0x0C) {
-    // Power ON
-    if (this->mode == climate::CLIMATE_MODE_OFF) {
-      ESP_LOGI(TAG, "AC Power Status: ON (from CMD_POWER packet)");
-      // Mode was already saved, just publish
-      this->publish_state();
-    }
-  } else {
-    ESP_LOGW(TAG, "Unknown power flag in CMD_POWER: 0x%02X", power_flag);
-  }
-}
-
-uint8_t TclAcClimate::get_fan_speed_() {
-  // Map ESPHome fan modes to TCL fan speeds (validated from log)
-  switch (this->fan_mode.value_or(climate::CLIMATE_FAN_LOW)) {
-    case climate::CLIMATE_FAN_AUTO:
-      return FAN_SPEED_AUTO;
-    case climate::CLIMATE_FAN_LOW:
-      return FAN_SPEED_LOW;  // Most common (83% in log)
-    case climate::CLIMATE_FAN_MEDIUM:
-      return FAN_SPEED_MEDIUM;
-    case climate::CLIMATE_FAN_HIGH:
-      return FAN_SPEED_MAX;  // Use MAX for "high"
+           data[0], data[1], data[2]);
+  
+  if (!this->has_reported_)
+    this->reported_ = this->current_settings_();
+  switch (decode_power(data, length)) {
+    case PowerState::OFF:
+      if (this->reported_.mode != climate::CLIMATE_MODE_OFF) {
+        ESP_LOGI(TAG, "AC Power Status: OFF (from CMD_POWER packet)");
+        this->reported_.mode = climate::CLIMATE_MODE_OFF;
+      }
+      this->reconcile_reported_();
+      this->publish_if_changed_();
+      break;
+    case PowerState::ON:
+      // The frame has no mode; the status frame that follows a poll does
+      if (this->reported_.mode == climate::CLIMATE_MODE_OFF && !this->set_in_flight_()) {
+        ESP_LOGI(TAG, "AC Power Status: ON (from CMD_POWER packet), asking for the mode");
+        this->send_poll_packet_();
+      }
+      break;
     default:
-      return FAN_SPEED_LOW;
+      ESP_LOGW(TAG, "Unknown power flag in CMD_POWER: 0x%02X", data[2]);
+      break;
   }
 }
 
-uint8_t TclAcClimate::celsius_to_raw_(float temp) {
-  // TCLAC protocol formula: 111 - celsius
-  // This is what works with your AC!
-  int raw = 111 - (int)(temp + 0.5f);  // +0.5 for rounding
-  if (raw < 0) raw = 0;
-  if (raw > 255) raw = 255;
-  ESP_LOGD(TAG, "Temperature encoding: %.1f°C -> raw 0x%02X (111 - %d)", temp, raw, (int)(temp + 0.5f));
-  return (uint8_t)raw;
-}
-
-float TclAcClimate::raw_to_celsius_(uint8_t raw) {
-  // Formula from protocol analysis: raw - 127 gives accurate room temp
-  // Analysis: Byte[30] with 'raw - 127' = ~18.87°C (0.43°C deviation from 19.3°C)
-  // Note: Only valid for ~36% of packets (STATUS packets), not SHORT_STATUS/POWER
-  return (float)raw - 127.0f;
-}
-
 // Runtime control methods for Home Assistant automations
 
 void TclAcClimate::set_vertical_airflow(AirflowVerticalDirection direction) {
   ESP_LOGD(TAG, "Setting vertical airflow direction: %d", (int)direction);
   this->vertical_airflow_ = direction;
-  if (this->force_mode_ && this->allow_send_) {
-    // Create and send packet with new settings
-    uint8_t packet[SET_PACKET_SIZE];
-    this->create_set_packet_(packet);
-    this->send_packet_(packet, SET_PACKET_SIZE);
+  if (this->allow_send_) {
+    this->request_set_(false);
   }
 }
 
 void TclAcClimate::set_horizontal_airflow(AirflowHorizontalDirection direction) {
   ESP_LOGD(TAG, "Setting horizontal airflow direction: %d", (int)direction);
   this->horizontal_airflow_ = direction;
-  if (this->force_mode_ && this->allow_send_) {
-    uint8_t packet[SET_PACKET_SIZE];
-    this->create_set_packet_(packet);
-    this->send_packet_(packet, SET_PACKET_SIZE);
+  if (this->allow_send_) {
+    this->request_set_(false);
   }
 }
 
 void TclAcClimate::set_vertical_swing(VerticalSwingDirection direction) {
   ESP_LOGD(TAG, "Setting vertical swing direction: %d", (int)direction);
   this->vertical_swing_ = direction;
-  if (this->force_mode_ && this->allow_send_) {
-    uint8_t packet[SET_PACKET_SIZE];
-    this->create_set_packet_(packet);
-    this->send_packet_(packet, SET_PACKET_SIZE);
+  if (this->allow_send_) {
+    this->request_set_(false);
   }
 }
 
 void TclAcClimate::set_horizontal_swing(HorizontalSwingDirection direction) {
   ESP_LOGD(TAG, "Setting horizontal swing direction: %d", (int)direction);
   this->horizontal_swing_ = direction;
-  if (this->force_mode_ && this->allow_send_) {
-    uint8_t packet[SET_PACKET_SIZE];
-    this->create_set_packet_(packet);
-    this->send_packet_(packet, SET_PACKET_SIZE);
+  if (this->allow_send_) {
+    this->request_set_(false);
   }
 }
 
 void TclAcClimate::set_display_state(bool state) {
   ESP_LOGD(TAG, "Setting display state: %s", state ? "ON" : "OFF");
   this->display_state_ = state;
-  if (this->force_mode_ && this->allow_send_) {
-    uint8_t packet[SET_PACKET_SIZE];
-    this->create_set_packet_(packet);
-    this->send_packet_(packet, SET_PACKET_SIZE);
+  if (this->allow_send_) {
+    this->request_set_(false);
   }
 }
 
 void TclAcClimate::set_beeper_state(bool state) {
   ESP_LOGD(TAG, "Setting beeper state: %s", state ? "ON" : "OFF");
   this->beeper_state_ = state;
-  if (this->force_mode_ && this->allow_send_) {
-    uint8_t packet[SET_PACKET_SIZE];
-    this->create_set_packet_(packet);
-    this->send_packet_(packet, SET_PACKET_SIZE);
+  if (this->allow_send_) {
+    this->request_set_(false);
   }
 }
 
@@ -883,10 +1015,8 @@ void TclAcClimate::set_eco_mode(bool enabled) {
     }
   }
   
-  if (this->force_mode_ && this->allow_send_) {
-    uint8_t packet[SET_PACKET_SIZE];
-    this->create_set_packet_(packet);
-    this->send_packet_(packet, SET_PACKET_SIZE);
+  if (this->allow_send_) {
+    this->request_set_(false);
   }
 }
 
@@ -906,10 +1036,8 @@ void TclAcClimate::set_turbo_mode(bool enabled) {
     }
   }
   
-  if (this->force_mode_ && this->allow_send_) {
-    uint8_t packet[SET_PACKET_SIZE];
-    this->create_set_packet_(packet);
-    this->send_packet_(packet, SET_PACKET_SIZE);
+  if (this->allow_send_) {
+    this->request_set_(false);
   }
 }
 
@@ -929,20 +1057,16 @@ void TclAcClimate::set_quiet_mode(bool enabled) {
     }
   }
   
-  if (this->force_mode_ && this->allow_send_) {
-    uint8_t packet[SET_PACKET_SIZE];
-    this->create_set_packet_(packet);
-    this->send_packet_(packet, SET_PACKET_SIZE);
+  if (this->allow_send_) {
+    this->request_set_(false);
   }
 }
 
 void TclAcClimate::set_health_mode(bool enabled) {
   ESP_LOGD(TAG, "Setting HEALTH mode: %s", enabled ? "ON" : "OFF");
   this->health_mode_ = enabled;
-  if (this->force_mode_ && this->allow_send_) {
-    uint8_t packet[SET_PACKET_SIZE];
-    this->create_set_packet_(packet);
-    this->send_packet_(packet, SET_PACKET_SIZE);
+  if (this->allow_send_) {
+    this->request_set_(false);
   }
 }
 
@@ -1,122 +1,58 @@
 #pragma once
 
 #include "esphome/core/component.h"
+#include "esphome/core/defines.h"
 #include "esphome/components/climate/climate.h"
 #include "esphome/components/uart/uart.h"
+#ifdef USE_SENSOR
+#include "esphome/components/sensor/sensor.h"
+#endif
+#include "ac_link.h"
+#include "command_tracker.h"
+#include "tcl_ac_codec.h"
 
 namespace esphome {
 namespace tcl_ac {
 
-// Protocol Constants - VALIDATED from UART log analysis (both.txt)
-
-// Packet Headers - CRITICAL: Direction matters!
-// MCU → AC: BB 00 01
-static const uint8_t HEADER_MCU_TO_AC_0 = 0xBB;
-static const uint8_t HEADER_MCU_TO_AC_1 = 0x00;
-static const uint8_t HEADER_MCU_TO_AC_2 = 0x01;
-// AC → MCU: BB 01 00 (bytes 1-2 swapped!)
-static const uint8_t HEADER_AC_TO_MCU_0 = 0xBB;
-static const uint8_t HEADER_AC_TO_MCU_1 = 0x01;
-static const uint8_t HEADER_AC_TO_MCU_2 = 0x00;
-
-// Commands
-static const uint8_t CMD_SET_PARAMS = 0x03;  // MCU → AC: Set parameters (AC responds with same cmd)
-static const uint8_t CMD_POLL = 0x04;        // MCU → AC: Poll status
-static const uint8_t CMD_TEMP_RESPONSE = 0x05;
-static const uint8_t CMD_STATUS_ECHO = 0x06;  // AC → MCU: Status echo (received only)
-static const uint8_t CMD_SHORT_STATUS = 0x09;
-static const uint8_t CMD_POWER = 0x0A;
-static const uint8_t CMD_TIME = 0x0B;
-
-// Packet sizes
-static const uint8_t SET_PACKET_SIZE = 38;
-static const uint8_t POLL_PACKET_SIZE = 7;
-
-// Fan Speed (Byte 8 Bits 0-2) - VALIDATED: 44x Speed1, 2x Speed3, 1x Speed7
-static const uint8_t FAN_SPEED_AUTO = 0;
-static const uint8_t FAN_SPEED_LOW = 1;        // 83% in log - DEFAULT
-static const uint8_t FAN_SPEED_MEDIUM_LOW = 2;
-static const uint8_t FAN_SPEED_MEDIUM = 3;
-static const uint8_t FAN_SPEED_MEDIUM_HIGH = 4;
-static const uint8_t FAN_SPEED_HIGH = 5;
-static const uint8_t FAN_SPEED_VERY_HIGH = 6;
-static const uint8_t FAN_SPEED_MAX = 7;
-
-// Byte 7 Flags (Mode + Flags) - VALIDATED
-static const uint8_t FLAG_ECO_MODE = 0x80;    // Bit 7 (1x observed)
-static const uint8_t FLAG_DISPLAY_ON = 0x40;   // Bit 6 (7x observed)
-static const uint8_t FLAG_BEEPER_ON = 0x20;    // Bit 5 (52/53 observed - DEFAULT ON)
-static const uint8_t MODE_BASE = 0x04;         // Bits 0-4 base value
-
-// Byte 8 Flags (Speed + Flags) - VALIDATED
-static const uint8_t FLAG_QUIET_MODE = 0x80;   // Bit 7 (1x observed)
-static const uint8_t FLAG_TURBO_MODE = 0x40;   // Bit 6 (3x observed)
-static const uint8_t FLAG_HEALTH_MODE = 0x20;  // Bit 5 (position identified)
-
-// Sleep Mode (Byte 19) - VALIDATED: 48x OFF, 1x Mode1, 2x Mode2
-static const uint8_t SLEEP_MODE_OFF = 0;
-static const uint8_t SLEEP_MODE_1 = 1;
-static const uint8_t SLEEP_MODE_2 = 2;
-
-// Direction Positions - VALIDATED from log
-static const uint8_t VERTICAL_POS_LAST = 0;
-static const uint8_t VERTICAL_POS_MAX_UP = 1;
-static const uint8_t VERTICAL_POS_UP = 2;
-static const uint8_t VERTICAL_POS_CENTER = 3;
-static const uint8_t VERTICAL_POS_DOWN = 4;
-static const uint8_t VERTICAL_POS_MAX_DOWN = 5;  // DEFAULT - 75% in log
-
-static const uint8_t HORIZONTAL_POS_LAST = 0;
-static const uint8_t HORIZONTAL_POS_MAX_LEFT = 1;
-static const uint8_t HORIZONTAL_POS_LEFT = 2;
-static const uint8_t HORIZONTAL_POS_CENTER = 3;
-static const uint8_t HORIZONTAL_POS_RIGHT = 4;
-static const uint8_t HORIZONTAL_POS_MAX_RIGHT = 5;  // DEFAULT - 60% in log
-
-// Swing Modes - Full range based on tclac protocol
-static const uint8_t VERTICAL_SWING_OFF = 0;
-static const uint8_t VERTICAL_SWING_FULL = 1;      // UP_DOWN - Full swing
-static const uint8_t VERTICAL_SWING_UPPER = 2;     // UPSIDE - Upper half
-static const uint8_t VERTICAL_SWING_LOWER = 3;     // DOWNSIDE - Lower half
-
-static const uint8_t HORIZONTAL_SWING_OFF = 0;
-static const uint8_t HORIZONTAL_SWING_FULL = 1;    // LEFT_RIGHT
-static const uint8_t HORIZONTAL_SWING_LEFT = 2;    // LEFTSIDE
-static const uint8_t HORIZONTAL_SWING_CENTER = 3;  // CENTER
-static const uint8_t HORIZONTAL_SWING_RIGHT = 4;   // RIGHTSIDE
-
-// Enums for better type safety
-enum class AirflowVerticalDirection : uint8_t {
-  LAST = 0,
-  MAX_UP = 1,
-  UP = 2,
-  CENTER = 3,
-  DOWN = 4,
-  MAX_DOWN = 5,
-};
+// Binds the protocol link to the ESPHome UART bus and clock
+class UARTTransport : public AcTransport {
+ public:
+  explicit UARTTransport(uart::UARTDevice *device) : device_(device) {}
+  size_t rx_available() override { return this->device_->available(); }
+  bool rx_read_array(uint8_t *data, size_t length) override { return this->device_->read_array(data, length); }
+  void tx_write(const uint8_t *data, size_t length) override { this->device_->write_array(data, length); }
+  uint32_t now_ms() override { return millis(); }
+  uint32_t now_us() override { return micros(); }
 
-enum class AirflowHorizontalDirection : uint8_t {
-  LAST = 0,
-  MAX_LEFT = 1,
-  LEFT = 2,
-  CENTER = 3,
-  RIGHT = 4,
-  MAX_RIGHT = 5,
+ protected:
+  uart::UARTDevice *device_;
 };
 
-enum class VerticalSwingDirection : uint8_t {
-  OFF = 0,
-  UP_DOWN = 1,
-  UPSIDE = 2,
-  DOWNSIDE = 3,
+// Changes applied together by TclAcClimate::apply() and sent to the AC as a
+// single SET packet. Fields left empty keep their current value.
+struct AcStateUpdate {
+  optional<climate::ClimateMode> mode;
+  optional<float> target_temperature;
+  optional<climate::ClimateFanMode> fan_mode;
+  optional<climate::ClimatePreset> preset;  // Also selects ECO/Turbo/Quiet, as from Home Assistant
+  optional<climate::ClimateSwingMode> swing_mode;
+  optional<AirflowVerticalDirection> vertical_airflow;
+  optional<AirflowHorizontalDirection> horizontal_airflow;
+  optional<VerticalSwingDirection> vertical_swing;
+  optional<HorizontalSwingDirection> horizontal_swing;
+  optional<bool> display_state;
+  optional<bool> beeper_state;
+  optional<bool> health_mode;
 };
 
-enum class HorizontalSwingDirection : uint8_t {
-  OFF = 0,
-  LEFT_RIGHT = 1,
-  LEFTSIDE = 2,
-  CENTER = 3,
-  RIGHTSIDE = 4,
+// Climate state as last sent to Home Assistant
+struct PublishedState {
+  climate::ClimateMode mode;
+  float target_temperature;
+  float current_temperature;
+  climate::ClimateFanMode fan_mode;
+  climate::ClimatePreset preset;
+  climate::ClimateSwingMode swing_mode;
 };
 
 class TclAcClimate : public climate::Climate, public uart::UARTDevice, public Component {
@@ -133,6 +69,37 @@ class TclAcClimate : public climate::Climate, public uart::UARTDevice, public Co
   void set_vertical_swing_direction(uint8_t direction) { vertical_swing_direction_ = direction; }
   void set_horizontal_swing_direction(uint8_t direction) { horizontal_swing_direction_ = direction; }
   void set_force_mode(bool enabled) { force_mode_ = enabled; }
+  void set_coalesce_window(uint32_t window_ms) { coalesce_window_ = window_ms; }
+  void set_temperature_deadband(float deadband) { temperature_deadband_ = deadband; }
+  void set_min_publish_interval(uint32_t interval_ms) { min_publish_interval_ = interval_ms; }
+  void set_memoize_frames(bool enabled) { memoize_frames_ = enabled; }
+  void set_poll_interval(uint32_t interval_ms) { link_.set_poll_interval(interval_ms); }
+  void set_idle_poll_interval(uint32_t interval_ms) { link_.set_idle_poll_interval(interval_ms); }
+  void set_fast_poll_interval(uint32_t interval_ms) { link_.set_fast_poll_interval(interval_ms); }
+  void set_fast_poll_count(uint8_t count) { link_.set_fast_poll_count(count); }
+  void set_command_timeout(uint32_t timeout_ms) { tracker_.set_timeout(timeout_ms); }
+  void set_command_retries(uint8_t retries) { tracker_.set_max_retries(retries); }
+  void set_rx_budget_bytes(size_t bytes) { link_.set_rx_budget_bytes(bytes); }
+  void set_rx_budget_time(uint32_t time_us) { link_.set_rx_budget_time(time_us); }
+  void set_check_frame_lengths(bool check) { link_.set_check_lengths(check); }
+  // While idle, loop() is parked until the next deadline but at most this
+  // long, to read what the UART has received; 0 = run loop() on every pass
+  void set_idle_check_interval(uint32_t interval_ms) { idle_check_interval_ = interval_ms; }
+  // Keep the last `records` frames in both directions in RAM (72 bytes each); 0 = off
+  void set_capture_size(uint16_t records) { capture_size_ = records; }
+#ifdef TCL_AC_RX_TASK
+  // Receive on a task pinned to this core instead of in loop()
+  void set_rx_task_core(uint8_t core) { rx_task_core_ = core; }
+#endif
+#ifdef USE_SENSOR
+  // Diagnostic sensors (sensor platform)
+  void set_command_rtt_median_sensor(sensor::Sensor *sensor) { command_rtt_median_sensor_ = sensor; }
+  void set_command_rtt_p95_sensor(sensor::Sensor *sensor) { command_rtt_p95_sensor_ = sensor; }
+  void set_command_retransmits_sensor(sensor::Sensor *sensor) { command_retransmits_sensor_ = sensor; }
+  void set_command_failures_sensor(sensor::Sensor *sensor) { command_failures_sensor_ = sensor; }
+  void set_loop_time_max_sensor(sensor::Sensor *sensor) { loop_time_max_sensor_ = sensor; }
+  void set_rx_budget_hits_sensor(sensor::Sensor *sensor) { rx_budget_hits_sensor_ = sensor; }
+#endif
 
   // Runtime control methods for Home Assistant automations
   void set_vertical_airflow(AirflowVerticalDirection direction);
@@ -145,6 +112,10 @@ class TclAcClimate : public climate::Climate, public uart::UARTDevice, public Co
   void set_turbo_mode(bool enabled);
   void set_quiet_mode(bool enabled);
   void set_health_mode(bool enabled);
+  
+  // Apply several changes at once: one state publish and one SET packet,
+  // sent without waiting for the coalescing window
+  void apply(const AcStateUpdate &update);
 
   // Getter methods for current state (for UI feedback)
   bool get_beeper_state() const { return beeper_state_; }
@@ -158,6 +129,42 @@ class TclAcClimate : public climate::Climate, public uart::UARTDevice, public Co
   VerticalSwingDirection get_vertical_swing() const { return vertical_swing_; }
   HorizontalSwingDirection get_horizontal_swing() const { return horizontal_swing_; }
 
+  // Coalescing statistics: SET frames sent for change bursts, and writes saved
+  uint32_t get_coalesce_bursts() const { return coalesce_bursts_; }
+  uint32_t get_coalesce_saved() const { return coalesce_saved_; }
+  // SET frames not sent because the AC had already confirmed the same frame
+  uint32_t get_sets_suppressed() const { return sets_suppressed_; }
+  // Confirmation of sent SET frames: round-trip times, retransmissions, failures
+  const CommandTracker &get_command_tracker() const { return tracker_; }
+  // Failed SETs whose optimistic state was replaced by the reported one
+  uint32_t get_rollbacks() const { return rollbacks_; }
+  
+  // Poll statistics: polls sent, and polls skipped because status was fresh
+  uint32_t get_polls_sent() const { return link_.get_polls_sent(); }
+  uint32_t get_polls_suppressed() const { return link_.get_polls_suppressed(); }
+  
+  // Publish statistics: state updates sent, and AC reports that changed nothing
+  uint32_t get_publishes() const { return publish_count_; }
+  uint32_t get_publishes_suppressed() const { return publish_suppressed_; }
+  // Frames skipped because their payload repeated the previous one
+  uint32_t get_frames_memoized() const { return frames_memoized_; }
+  // Longest loop() since boot, and loop() calls that left received data for
+  // the next one because the receive budget was used up
+  uint32_t get_loop_max_us() const { return loop_max_us_; }
+  // Times loop() was disabled to wait for its next deadline
+  uint32_t get_loop_parks() const { return loop_parks_; }
+  uint32_t get_rx_budget_hits() const { return link_.get_rx_budget_hits(); }
+  // Short status (0x09) frames, and whether their power/mode has been seen
+  // to agree with full status frames often enough to be used
+  uint32_t get_short_status_frames() const { return short_status_frames_; }
+  bool is_short_status_trusted() const { return short_status_trusted_; }
+
+  // Frame capture: log it as hex, one line per frame, or empty it. With the
+  // web server it is also served as a binary file at /tcl_ac/capture.
+  void dump_capture();
+  void clear_capture();
+  FrameCapture &get_capture() { return link_.get_capture(); }
+
   // Climate traits (capabilities)
   climate::ClimateTraits traits() override;
 
@@ -169,17 +176,34 @@ class TclAcClimate : public climate::Climate, public uart::UARTDevice, public Co
   void create_set_packet_(uint8_t *packet);
   void send_packet_(const uint8_t *packet, size_t length);
   void send_poll_packet_();
-  uint8_t calculate_checksum_(const uint8_t *data, size_t length);
+  void apply_preset_(climate::ClimatePreset preset);
+  void request_set_(bool power_off);
+  void flush_set_();
+  bool send_set_packet_(bool power_off, const AcSettings &settings);
+  void check_command_();
+  void roll_back_();
+  void publish_command_stats_();
+  void publish_loop_stats_();
+  void park_loop_();
+  void wake_loop_();
+  AcSettings current_settings_() const;
   
   // Packet parsing
+  void handle_frame_(const Frame &frame);
+  bool is_repeated_frame_(const Frame &frame);
+  void invalidate_payload_cache_();
   void parse_status_packet_(const uint8_t *data, size_t length);
+  bool set_in_flight_() const;
+  void reconcile_reported_();
+  void apply_reported_settings_(const AcSettings &reported);
   void parse_temp_response_(const uint8_t *data, size_t length);
   void parse_power_response_(const uint8_t *data, size_t length);
+  void parse_short_status_(const uint8_t *data, size_t length);
   
-  // Helper functions
-  uint8_t get_fan_speed_();
-  uint8_t celsius_to_raw_(float temp);
-  float raw_to_celsius_(uint8_t raw);
+  // State publishing
+  bool state_changed_() const;
+  void publish_if_changed_();
+  void publish_now_();
 
   // Configuration (from YAML)
   bool beeper_enabled_{true};      // DEFAULT: ON (98% in log)
@@ -188,7 +212,15 @@ class TclAcClimate : public climate::Climate, public uart::UARTDevice, public Co
   uint8_t horizontal_direction_{HORIZONTAL_POS_MAX_RIGHT}; // DEFAULT (60% in log)
   uint8_t vertical_swing_direction_{VERTICAL_SWING_OFF};
   uint8_t horizontal_swing_direction_{HORIZONTAL_SWING_OFF};
-  bool force_mode_{true};  // If true, always apply settings on send
+  bool force_mode_{false};  // If true, send every change, even a frame the AC already confirmed
+  uint32_t coalesce_window_{50};  // Quiet time (ms) that ends a burst of changes
+  float temperature_deadband_{0.2f};  // Smallest room temperature change worth publishing
+  uint32_t min_publish_interval_{1000};
+  bool memoize_frames_{true};  // Skip decoding payloads identical to the last one per command
+  uint16_t capture_size_{0};
+#ifdef TCL_AC_RX_TASK
+  int8_t rx_task_core_{-1};  // -1 = receive in loop()
+#endif
 
   // Runtime state (can be changed via actions)
   bool beeper_state_{true};
@@ -202,13 +234,81 @@ class TclAcClimate : public climate::Climate, public uart::UARTDevice, public Co
   VerticalSwingDirection vertical_swing_{VerticalSwingDirection::OFF};
   HorizontalSwingDirection horizontal_swing_{HorizontalSwingDirection::OFF};
 
-  // Timing
-  uint32_t last_transmit_{0};
-  uint32_t last_poll_{0};
   bool allow_send_{true};  // Flag to control when we can send commands
   
-  // UART buffer
-  std::vector<uint8_t> rx_buffer_;
+  // Pending SET: changes are collected here and sent as one frame from loop()
+  uint32_t set_pending_changes_{0};
+  uint32_t set_first_change_{0};
+  uint32_t set_last_change_{0};
+  bool set_power_off_{false};
+  AcSettings set_requested_;  // The state as of the last change, what the frame carries
+  uint32_t coalesce_bursts_{0};
+  uint32_t coalesce_saved_{0};
+  uint32_t last_set_sent_{0};  // When the last SET left the wire
+  bool has_sent_set_{false};
+  
+  // SET in flight until a status frame shows it, and the last one confirmed;
+  // a new frame equal to the confirmed one is not sent
+  CommandTracker tracker_;
+  uint8_t set_acked_[SET_PACKET_SIZE]{};
+  bool set_acked_valid_{false};
+  uint32_t sets_suppressed_{0};
+  
+  // Settings from the last full status frame, updated by the temperature
+  // (0x05) and power (0x0A) frames, whether or not they were applied: the
+  // climate state is rolled back to them when a SET fails
+  AcSettings reported_;
+  bool has_reported_{false};
+  uint32_t rollbacks_{0};
+#ifdef USE_SENSOR
+  sensor::Sensor *command_rtt_median_sensor_{nullptr};
+  sensor::Sensor *command_rtt_p95_sensor_{nullptr};
+  sensor::Sensor *command_retransmits_sensor_{nullptr};
+  sensor::Sensor *command_failures_sensor_{nullptr};
+  sensor::Sensor *loop_time_max_sensor_{nullptr};
+  sensor::Sensor *rx_budget_hits_sensor_{nullptr};
+#endif
+  
+  // Last payload per decoded command (0x03, 0x04, 0x05, 0x06, 0x0A)
+  struct PayloadCache {
+    uint8_t data[STATUS_DATA_SIZE];
+    uint8_t length;
+    bool valid;
+  };
+  PayloadCache payload_cache_[5]{};
+  uint32_t frames_memoized_{0};
+  
+  // Short status is only used once it has matched the mode of the full
+  // status frame before it SHORT_STATUS_TRUST times in a row
+  uint8_t short_status_matches_{0};
+  bool short_status_trusted_{false};
+  uint32_t short_status_frames_{0};
+  
+  // Publish filter: AC reports are only forwarded when they change the state
+  PublishedState published_{};
+  bool has_published_{false};
+  bool precise_room_temperature_{false};  // current_temperature came from the 16-bit status field
+  bool publish_pending_{false};
+  uint32_t last_publish_{0};
+  uint32_t publish_count_{0};
+  uint32_t publish_suppressed_{0};
+  
+  // loop() duration: since boot, and over the current report window
+  uint32_t loop_max_us_{0};
+  uint32_t loop_window_max_us_{0};
+  uint32_t loop_window_start_{0};
+  
+  // Idle: loop() disabled until a scheduler timeout, new work or (with the
+  // RX task) a received frame enables it again
+  uint32_t idle_check_interval_{100};
+  bool loop_parked_{false};
+  uint32_t loop_parks_{0};
+  bool idle_wake_armed_{false};
+  uint32_t idle_wake_at_{0};
+  
+  // UART link: receive framer (fixed size, no heap), transmit and poll scheduling
+  UARTTransport transport_{this};
+  AcLink link_{&this->transport_};
 };
 
 }  // namespace tcl_ac
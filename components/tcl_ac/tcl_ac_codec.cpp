@@ -0,0 +1,456 @@
+#include "tcl_ac_codec.h"
+#include "tcl_ac_schema.h"
+#include "frame_reader.h"
+#include "esphome/core/log.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace esphome {
+namespace tcl_ac {
+
+static const char *const TAG = "tcl_ac";
+
+uint8_t calculate_checksum(const uint8_t *data, size_t length) {
+  // XOR checksum - VALIDATED from log analysis
+  uint8_t checksum = 0;
+  for (size_t i = 0; i < length; i++) {
+    checksum ^= data[i];
+  }
+  return checksum;
+}
+
+// ========== SET packet encoder ==========
+// COMPLETE TCLAC PROTOCOL IMPLEMENTATION
+// Based on https://github.com/Kannix2005/tclac Lines 393-711
+//
+// Bit positions and enum codes come from tcl_ac_schema.h, which the status
+// decoder below uses as well. Every field is OR-ed into a constant template
+// frame with the checksum patched per byte. Everything that depends on the
+// model profile is a template on it, built at compile time.
+
+static constexpr uint8_t COMMON_SET_TEMPLATE[SET_PACKET_SIZE] = {
+    HEADER_MCU_TO_AC_0, HEADER_MCU_TO_AC_1, HEADER_MCU_TO_AC_2,
+    CMD_SET_PARAMS,  // 0x03 = control
+    0x20,            // 32 data bytes
+    0x03, 0x01,      // Data payload starts at offset 5
+    0x00,            // [7]  Mode/Power/Display/Beeper/ECO
+    0x00,            // [8]  Mode details/Quiet/Turbo/Health
+    0x00,            // [9]  Temperature (Model B)
+    0x00,            // [10] Fan speed (Model B)/Swing vertical
+    0x00,            // [11] Swing horizontal
+    0x00,            // [12] Fahrenheit/Timer
+    0x01,            // [13] Fixed
+    0x00,            // [14] Half degree
+    0x00, 0x00, 0x00, 0x00,
+    0x00,            // [19] Sleep mode
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00,            // [29] Fixed 0x20 (Model B)
+    0x00,            // [30] Fixed 0x20 (Model A)
+    0x00,            // [31] Temperature (Model A)
+    0x00,            // [32] Vertical swing mode + airflow position
+    0x00,            // [33] Horizontal swing mode + airflow position
+    0x00, 0x00, 0x00,
+    0x00,            // [37] Checksum
+};
+
+struct SetTemplate {
+  uint8_t frame[SET_PACKET_SIZE];
+  uint8_t checksum;  // Of the template as is
+};
+
+template<typename M> static constexpr SetTemplate make_set_template() {
+  SetTemplate set{};
+  for (size_t i = 0; i < SET_PACKET_SIZE; i++)
+    set.frame[i] = COMMON_SET_TEMPLATE[i];
+  M::set_constants(set.frame + FRAME_HEADER_SIZE);
+  for (size_t i = 0; i < SET_PACKET_SIZE - 1; i++)
+    set.checksum ^= set.frame[i];
+  return set;
+}
+
+template<typename M> static constexpr SetTemplate SET_TEMPLATE = make_set_template<M>();
+
+// Bytes OR-ed into the packet for one field value. The tables below are
+// generated from the schema at compile time, indexed by the enum value.
+struct SetPatch {
+  uint8_t offset_a;
+  uint8_t bits_a;
+  uint8_t offset_b;
+  uint8_t bits_b;
+};
+
+template<typename F> static constexpr SetPatch field_patch(uint8_t raw) {
+  return {static_cast<uint8_t>(FRAME_HEADER_SIZE + F::offset), F::bits(raw), 0, 0};
+}
+
+template<typename F, typename G> static constexpr SetPatch field_patch(uint8_t raw_f, uint8_t raw_g) {
+  return {static_cast<uint8_t>(FRAME_HEADER_SIZE + F::offset), F::bits(raw_f),
+          static_cast<uint8_t>(FRAME_HEADER_SIZE + G::offset), G::bits(raw_g)};
+}
+
+// Operating mode (TCLAC Lines 429-460): OFF leaves power and mode clear
+template<typename M> static constexpr SetPatch mode_patch(uint8_t mode) {
+  if (mode == climate::CLIMATE_MODE_OFF)
+    return field_patch<PowerFlag>(0);
+  if constexpr (M::HAS_MODE) {
+    using Mode = typename M::Mode;
+    return field_patch<PowerFlag, Mode>(1, EnumCodec<Mode>::to_raw(static_cast<climate::ClimateMode>(mode)));
+  } else {
+    return field_patch<PowerFlag>(1);
+  }
+}
+
+// Fan mode (TCLAC Lines 462-496): QUIET and DIFFUSE are flags, not speeds
+template<typename M> static constexpr SetPatch fan_patch(uint8_t fan) {
+  using Fan = typename M::Fan;
+  if (fan == climate::CLIMATE_FAN_QUIET)
+    return field_patch<QuietFlag>(1);
+  if (fan == climate::CLIMATE_FAN_DIFFUSE)
+    return field_patch<TurboFlag>(1);
+  return field_patch<Fan>(EnumCodec<Fan>::to_raw(static_cast<climate::ClimateFanMode>(fan)));
+}
+
+// ESPHome's built-in swing modes (TCLAC Lines 498-515)
+static constexpr SetPatch swing_patch(uint8_t swing) {
+  bool vertical = swing == climate::CLIMATE_SWING_VERTICAL || swing == climate::CLIMATE_SWING_BOTH;
+  bool horizontal = swing == climate::CLIMATE_SWING_HORIZONTAL || swing == climate::CLIMATE_SWING_BOTH;
+  return field_patch<VerticalSwingFlag, HorizontalSwingFlag>(vertical ? VerticalSwingFlag::max : 0, horizontal);
+}
+
+// Presets (TCLAC Lines 517-530)
+static constexpr SetPatch preset_patch(uint8_t preset) {
+  switch (preset) {
+    case climate::CLIMATE_PRESET_ECO:
+      return field_patch<EcoFlag>(1);
+    case climate::CLIMATE_PRESET_SLEEP:
+      return field_patch<SleepField>(1);
+    case climate::CLIMATE_PRESET_COMFORT:
+      return field_patch<ComfortFlag>(1);
+    default:
+      return field_patch<SleepField>(0);
+  }
+}
+
+template<size_t N> struct PatchTable {
+  SetPatch entry[N];
+  SetPatch fallback;
+};
+
+template<size_t N> static constexpr PatchTable<N> make_table(SetPatch (*patch)(uint8_t)) {
+  PatchTable<N> table{};
+  for (size_t i = 0; i < N; i++)
+    table.entry[i] = patch(i);
+  table.fallback = patch(0xFF);
+  return table;
+}
+
+template<typename M> static constexpr auto MODE_TABLE = make_table<climate::CLIMATE_MODE_AUTO + 1>(mode_patch<M>);
+template<typename M> static constexpr auto FAN_TABLE = make_table<climate::CLIMATE_FAN_QUIET + 1>(fan_patch<M>);
+static constexpr auto SWING_TABLE = make_table<climate::CLIMATE_SWING_HORIZONTAL + 1>(swing_patch);
+static constexpr auto PRESET_TABLE = make_table<climate::CLIMATE_PRESET_ACTIVITY + 1>(preset_patch);
+
+template<size_t N> static inline const SetPatch &lookup(const PatchTable<N> &table, uint8_t value) {
+  return value < N ? table.entry[value] : table.fallback;
+}
+
+static inline void or_bits(uint8_t *packet, uint8_t *checksum, uint8_t offset, uint8_t bits) {
+  uint8_t old = packet[offset];
+  packet[offset] = old | bits;
+  *checksum ^= old ^ packet[offset];
+}
+
+// OR, so a flag requested twice (eco_mode and preset ECO) stays set
+static inline void apply_patch(uint8_t *packet, uint8_t *checksum, const SetPatch &patch) {
+  if (patch.bits_a != 0)
+    or_bits(packet, checksum, patch.offset_a, patch.bits_a);
+  if (patch.bits_b != 0)
+    or_bits(packet, checksum, patch.offset_b, patch.bits_b);
+}
+
+// Louvre bytes hold a range and a position field each
+template<typename F> static inline uint8_t enum_bits(decltype(F::CODES[0].value) value) {
+  return F::bits(EnumCodec<F>::to_raw(value));
+}
+
+template<typename M> void encode_set_packet_for(const AcSettings &settings, uint8_t *packet) {
+  memcpy(packet, SET_TEMPLATE<M>.frame, SET_PACKET_SIZE);
+  uint8_t checksum = SET_TEMPLATE<M>.checksum;
+  uint8_t *payload = packet + FRAME_HEADER_SIZE;
+  
+  static_assert(EcoFlag::offset == DisplayFlag::offset && EcoFlag::offset == BeeperFlag::offset,
+                "Byte 7 flags are combined");
+  static_assert(QuietFlag::offset == TurboFlag::offset && QuietFlag::offset == HealthFlag::offset,
+                "Byte 8 flags are combined");
+  or_bits(payload, &checksum, EcoFlag::offset,
+          EcoFlag::bits(settings.eco_mode) | DisplayFlag::bits(settings.display_state) |
+              BeeperFlag::bits(settings.beeper_state));
+  or_bits(payload, &checksum, QuietFlag::offset,
+          QuietFlag::bits(settings.quiet_mode) | TurboFlag::bits(settings.turbo_mode) |
+              HealthFlag::bits(settings.health_mode));
+  
+  apply_patch(packet, &checksum, lookup(MODE_TABLE<M>, settings.mode));
+  apply_patch(packet, &checksum, lookup(FAN_TABLE<M>, settings.fan_mode));
+  apply_patch(packet, &checksum, lookup(SWING_TABLE, settings.swing_mode));
+  apply_patch(packet, &checksum, lookup(PRESET_TABLE, settings.preset));
+  
+  // Temperature
+  or_bits(payload, &checksum, M::TargetTemperature::offset,
+          M::target_raw((int) (settings.target_temperature + 0.5f)));
+  
+  static_assert(VerticalRangeField::offset == VerticalPositionField::offset &&
+                    HorizontalRangeField::offset == HorizontalPositionField::offset,
+                "Louvre range and position share a byte");
+  or_bits(payload, &checksum, VerticalRangeField::offset,
+          enum_bits<VerticalRangeField>(settings.vertical_swing) |
+              enum_bits<VerticalPositionField>(settings.vertical_airflow));
+  or_bits(payload, &checksum, HorizontalRangeField::offset,
+          enum_bits<HorizontalRangeField>(settings.horizontal_swing) |
+              enum_bits<HorizontalPositionField>(settings.horizontal_airflow));
+  
+  packet[SET_PACKET_SIZE - 1] = checksum;
+  
+  ESP_LOGD(TAG, "SET packet (model %s): mode=%u fan=%u swing=%u preset=%u temp=%.1f°C (0x%02X) "
+           "flags=0x%02X/0x%02X/0x%02X vertical=0x%02X horizontal=0x%02X", M::NAME, (unsigned) settings.mode,
+           (unsigned) settings.fan_mode, (unsigned) settings.swing_mode, (unsigned) settings.preset,
+           settings.target_temperature, payload[M::TargetTemperature::offset], packet[7], packet[8], packet[10],
+           packet[32], packet[33]);
+}
+
+void encode_set_packet(const AcSettings &settings, uint8_t *packet) {
+  encode_set_packet_for<ActiveModel>(settings, packet);
+}
+
+void encode_power_off_packet(uint8_t *packet) {
+  // Simplified set packet with specific flags
+  memset(packet, 0, SET_PACKET_SIZE);
+  packet[0] = HEADER_MCU_TO_AC_0;
+  packet[1] = HEADER_MCU_TO_AC_1;
+  packet[2] = HEADER_MCU_TO_AC_2;
+  packet[3] = CMD_SET_PARAMS;
+  packet[4] = 0x20;  // 32 data bytes
+  packet[5] = 0x03;
+  packet[6] = 0x01;
+  packet[7] = 0x00;  // Mode byte = 0x00 indicates power off (observed as 0x20 in one packet)
+  packet[SET_PACKET_SIZE - 1] = calculate_checksum(packet, SET_PACKET_SIZE - 1);
+}
+
+void encode_poll_packet(uint8_t *packet) {
+  packet[0] = HEADER_MCU_TO_AC_0;
+  packet[1] = HEADER_MCU_TO_AC_1;
+  packet[2] = HEADER_MCU_TO_AC_2;
+  packet[3] = CMD_POLL;
+  packet[4] = 0x01;  // Length
+  packet[5] = 0x00;  // Data
+  packet[POLL_PACKET_SIZE - 1] = calculate_checksum(packet, POLL_PACKET_SIZE - 1);
+}
+
+bool decode_status(const uint8_t *data, size_t length, StatusData *status) {
+  if (length < 32) {
+    return false;
+  }
+  
+  // Temperature parsing
+  // PACKET bytes [17:18] using:  (((raw16)/374 - 32) / 1.8)
+  //   // In this parser, "data" points to payload starting at PACKET byte 5, so:
+  //   PACKET[17] -> data[12]
+  //   PACKET[18] -> data[13]
+  // This method is preferred because it is stable across mode/power changes.
+  status->has_room_temperature = false;
+  status->room_temperature_fallback = false;
+  const uint16_t raw16 = ((uint16_t) data[12] << 8) | data[13];
+  const float room_c = (((float) raw16 / 374.0f) - 32.0f) / 1.8f;
+  if (room_c > -10.0f && room_c < 60.0f) {
+    status->room_temperature = room_c;
+    status->has_room_temperature = true;
+    return true;
+  }
+
+  // Fallback (older single-byte heuristic)
+  if (length >= 55) {
+    const uint8_t ac_temp_raw = data[30];
+    if (ac_temp_raw >= 120 && ac_temp_raw <= 180) {
+      const float ac_temp = raw_to_celsius(ac_temp_raw);
+      if (ac_temp > -10.0f && ac_temp < 60.0f) {
+        status->room_temperature = ac_temp;
+        status->has_room_temperature = true;
+        status->room_temperature_fallback = true;
+      }
+    }
+  }
+  return true;
+}
+
+// Power and operating mode, shared by the status and short status decoders
+template<typename M> static void decode_mode(const uint8_t *data, climate::ClimateMode *mode) {
+  if (PowerFlag::read(data) == 0) {
+    *mode = climate::CLIMATE_MODE_OFF;
+  } else if constexpr (M::HAS_MODE) {
+    EnumCodec<typename M::Mode>::read(data, mode);
+  } else {
+    *mode = M::ON_MODE;  // On, in a mode the frame does not tell
+  }
+}
+
+template<typename M> bool decode_settings_for(const uint8_t *data, size_t length, AcSettings *settings) {
+  if (length < SCHEMA_PAYLOAD_SIZE) {
+    return false;
+  }
+  
+  // Inverse of encode_set_packet(). QUIET/DIFFUSE fan and ECO preset come
+  // back as their flags; codes the schema does not know keep the current value.
+  decode_mode<M>(data, &settings->mode);
+  settings->eco_mode = EcoFlag::read(data) != 0;
+  settings->display_state = DisplayFlag::read(data) != 0;
+  settings->beeper_state = BeeperFlag::read(data) != 0;
+  settings->quiet_mode = QuietFlag::read(data) != 0;
+  settings->turbo_mode = TurboFlag::read(data) != 0;
+  settings->health_mode = HealthFlag::read(data) != 0;
+  EnumCodec<typename M::Fan>::read(data, &settings->fan_mode);
+  
+  bool vertical = VerticalSwingFlag::read(data) == VerticalSwingFlag::max;
+  bool horizontal = HorizontalSwingFlag::read(data) != 0;
+  if (vertical && horizontal) {
+    settings->swing_mode = climate::CLIMATE_SWING_BOTH;
+  } else if (vertical) {
+    settings->swing_mode = climate::CLIMATE_SWING_VERTICAL;
+  } else if (horizontal) {
+    settings->swing_mode = climate::CLIMATE_SWING_HORIZONTAL;
+  } else {
+    settings->swing_mode = climate::CLIMATE_SWING_OFF;
+  }
+  
+  if (SleepField::read(data) != 0) {
+    settings->preset = climate::CLIMATE_PRESET_SLEEP;
+  } else if (ComfortFlag::read(data) != 0) {
+    settings->preset = climate::CLIMATE_PRESET_COMFORT;
+  } else {
+    settings->preset = climate::CLIMATE_PRESET_NONE;
+  }
+  
+  settings->target_temperature = (float) M::target_celsius(M::TargetTemperature::read(data));
+  EnumCodec<VerticalRangeField>::read(data, &settings->vertical_swing);
+  EnumCodec<VerticalPositionField>::read(data, &settings->vertical_airflow);
+  EnumCodec<HorizontalRangeField>::read(data, &settings->horizontal_swing);
+  EnumCodec<HorizontalPositionField>::read(data, &settings->horizontal_airflow);
+  return true;
+}
+
+bool decode_settings(const uint8_t *data, size_t length, AcSettings *settings) {
+  return decode_settings_for<ActiveModel>(data, length, settings);
+}
+
+uint16_t settings_diff(const AcSettings &requested, const AcSettings &reported) {
+  uint16_t diff = 0;
+  if (requested.mode != reported.mode)
+    diff |= FIELD_MODE;
+  if (requested.target_temperature != reported.target_temperature)
+    diff |= FIELD_TARGET_TEMPERATURE;
+  if (requested.fan_mode != reported.fan_mode)
+    diff |= FIELD_FAN_MODE;
+  if (requested.preset != reported.preset)
+    diff |= FIELD_PRESET;
+  if (requested.swing_mode != reported.swing_mode)
+    diff |= FIELD_SWING_MODE;
+  if (requested.eco_mode != reported.eco_mode)
+    diff |= FIELD_ECO;
+  if (requested.turbo_mode != reported.turbo_mode)
+    diff |= FIELD_TURBO;
+  if (requested.quiet_mode != reported.quiet_mode)
+    diff |= FIELD_QUIET;
+  if (requested.health_mode != reported.health_mode)
+    diff |= FIELD_HEALTH;
+  if (requested.display_state != reported.display_state)
+    diff |= FIELD_DISPLAY;
+  if (requested.vertical_swing != reported.vertical_swing || requested.vertical_airflow != reported.vertical_airflow)
+    diff |= FIELD_VERTICAL_LOUVRE;
+  if (requested.horizontal_swing != reported.horizontal_swing ||
+      requested.horizontal_airflow != reported.horizontal_airflow)
+    diff |= FIELD_HORIZONTAL_LOUVRE;
+  return diff;
+}
+
+void format_settings_diff(uint16_t diff, char *buffer, size_t size) {
+  // In SettingsField bit order
+  static const char *const NAMES[] = {"mode", "target temperature", "fan", "preset", "swing", "eco", "turbo",
+                                      "quiet", "health", "display", "vertical louvre", "horizontal louvre"};
+  if (size == 0)
+    return;
+  buffer[0] = '\0';
+  size_t used = 0;
+  for (size_t bit = 0; bit < sizeof(NAMES) / sizeof(NAMES[0]); bit++) {
+    if ((diff & (1u << bit)) == 0)
+      continue;
+    int n = snprintf(buffer + used, size - used, "%s%s", used > 0 ? ", " : "", NAMES[bit]);
+    if (n < 0 || (size_t) n >= size - used)
+      return;  // Truncated
+    used += n;
+  }
+}
+
+bool decode_short_status(const uint8_t *data, size_t length, climate::ClimateMode *mode) {
+  // CMD_SHORT_STATUS (0x09): 45 bytes that start like the status payload.
+  // Only power and operating mode (bytes 2-3) are taken from it; whether a
+  // unit really puts them there is checked against full status frames by
+  // the caller before they are used.
+  static_assert(PowerFlag::offset < SHORT_STATUS_DATA_SIZE && ModelB::Mode::offset < SHORT_STATUS_DATA_SIZE,
+                "Short status covers the mode bytes");
+  if (length < SHORT_STATUS_DATA_SIZE) {
+    return false;
+  }
+  decode_mode<ActiveModel>(data, mode);
+  return true;
+}
+
+// Host tools check both profiles whichever one the build selects
+#ifdef TCL_AC_ALL_MODELS
+template void encode_set_packet_for<ModelA>(const AcSettings &settings, uint8_t *packet);
+template void encode_set_packet_for<ModelB>(const AcSettings &settings, uint8_t *packet);
+template bool decode_settings_for<ModelA>(const uint8_t *data, size_t length, AcSettings *settings);
+template bool decode_settings_for<ModelB>(const uint8_t *data, size_t length, AcSettings *settings);
+#endif
+
+bool decode_temp_response(const uint8_t *data, size_t length, TempData *temp) {
+  if (length < TEMP_MIN_DATA_SIZE) {
+    return false;
+  }
+  
+  // TEMP_RESPONSE encoding differs from STATUS.
+  // Byte 0: current temperature (raw - 7)
+  // Byte 2: target temperature  (raw - 12)
+  temp->current_temperature = ((float) data[0]) - 7.0f;
+  temp->has_current = temp->current_temperature > -10.0f && temp->current_temperature < 60.0f;
+  temp->target_temperature = ((float) data[2]) - 12.0f;
+  temp->has_target = temp->target_temperature > 10.0f && temp->target_temperature < 40.0f;
+  return true;
+}
+
+PowerState decode_power(const uint8_t *data, size_t length) {
+  // CMD_POWER (0x0A) packet structure:
+  // - Payload length: 45 bytes
+  // - Byte[0]: Always 0x04 (unknown)
+  // - Byte[1]: Always 0x00 (unknown)
+  // - Byte[2]: POWER FLAG - 0x04=OFF, 0x0C=ON
+  // - Byte[3]: Secondary flag (0x00 or 0x01, rare)
+  // - Rest: Mostly zeros
+  if (length < 3) {
+    return PowerState::UNKNOWN;
+  }
+  if (data[2] == 0x04) {
+    return PowerState::OFF;
+  }
+  if (data[2] == 0x0C) {
+    return PowerState::ON;
+  }
+  return PowerState::UNKNOWN;
+}
+
+float raw_to_celsius(uint8_t raw) {
+  // Formula from protocol analysis: raw - 127 gives accurate room temp
+  // Analysis: Byte[30] with 'raw - 127' = ~18.87°C (0.43°C deviation from 19.3°C)
+  // Note: Only valid for ~36% of packets (STATUS packets), not SHORT_STATUS/POWER
+  return (float)raw - 127.0f;
+}
+
+}  // namespace tcl_ac
+}  // namespace esphome
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "esphome/components/climate/climate.h"
+#include "tcl_ac_protocol.h"
+
+namespace esphome {
+namespace tcl_ac {
+
+// Everything the AC needs to know to build a SET packet. Kept separate from
+// TclAcClimate so the encoder can run (and be measured) without ESPHome.
+struct AcSettings {
+  climate::ClimateMode mode{climate::CLIMATE_MODE_OFF};
+  float target_temperature{22.0f};
+  climate::ClimateFanMode fan_mode{climate::CLIMATE_FAN_AUTO};
+  climate::ClimatePreset preset{climate::CLIMATE_PRESET_NONE};
+  climate::ClimateSwingMode swing_mode{climate::CLIMATE_SWING_OFF};
+  bool eco_mode{false};
+  bool turbo_mode{false};
+  bool quiet_mode{false};
+  bool health_mode{false};
+  bool display_state{false};
+  bool beeper_state{true};
+  VerticalSwingDirection vertical_swing{VerticalSwingDirection::OFF};
+  HorizontalSwingDirection horizontal_swing{HorizontalSwingDirection::OFF};
+  AirflowVerticalDirection vertical_airflow{AirflowVerticalDirection::LAST};
+  AirflowHorizontalDirection horizontal_airflow{AirflowHorizontalDirection::LAST};
+};
+
+// Room temperature read from a 0x03/0x04/0x06 status payload. Everything
+// else in it has the SET layout and is read with decode_settings().
+struct StatusData {
+  bool has_room_temperature;
+  float room_temperature;
+  bool room_temperature_fallback;  // Taken from the single-byte heuristic in data[30]
+};
+
+// Values read from a CMD_TEMP_RESPONSE (0x05) payload
+struct TempData {
+  bool has_current;
+  float current_temperature;
+  bool has_target;
+  float target_temperature;
+};
+
+enum class PowerState : uint8_t {
+  OFF,
+  ON,
+  UNKNOWN,
+};
+
+// XOR checksum - VALIDATED from log analysis
+uint8_t calculate_checksum(const uint8_t *data, size_t length);
+
+// MCU → AC packets. encode_set_packet() uses the layout of the model
+// selected at build time (ActiveModel in tcl_ac_schema.h).
+void encode_set_packet(const AcSettings &settings, uint8_t *packet);
+template<typename M> void encode_set_packet_for(const AcSettings &settings, uint8_t *packet);
+void encode_power_off_packet(uint8_t *packet);
+void encode_poll_packet(uint8_t *packet);
+
+// AC → MCU payload decoders. `data` is the payload after the 5-byte header.
+bool decode_status(const uint8_t *data, size_t length, StatusData *status);
+// Settings carried by a SET or status payload, read with the encoder's field schema
+bool decode_settings(const uint8_t *data, size_t length, AcSettings *settings);
+template<typename M> bool decode_settings_for(const uint8_t *data, size_t length, AcSettings *settings);
+// AcSettings fields, as a mask for settings_diff()
+enum SettingsField : uint16_t {
+  FIELD_MODE = 1 << 0,
+  FIELD_TARGET_TEMPERATURE = 1 << 1,
+  FIELD_FAN_MODE = 1 << 2,
+  FIELD_PRESET = 1 << 3,
+  FIELD_SWING_MODE = 1 << 4,
+  FIELD_ECO = 1 << 5,
+  FIELD_TURBO = 1 << 6,
+  FIELD_QUIET = 1 << 7,
+  FIELD_HEALTH = 1 << 8,
+  FIELD_DISPLAY = 1 << 9,
+  FIELD_VERTICAL_LOUVRE = 1 << 10,  // Position or swing
+  FIELD_HORIZONTAL_LOUVRE = 1 << 11,
+};
+// Fields in which `reported` (decoded from a status payload) differs from
+// `requested` (decoded from a SET payload). The beeper bit only affects how
+// the unit answers and is not compared.
+uint16_t settings_diff(const AcSettings &requested, const AcSettings &reported);
+// True if `reported` shows everything `requested` asks for
+inline bool settings_match(const AcSettings &requested, const AcSettings &reported) {
+  return settings_diff(requested, reported) == 0;
+}
+// Comma-separated field names of a settings_diff() mask, for the log
+void format_settings_diff(uint16_t diff, char *buffer, size_t size);
+
+// Power and mode from a CMD_SHORT_STATUS (0x09) payload; `mode` is updated
+// like AcSettings::mode in decode_settings()
+bool decode_short_status(const uint8_t *data, size_t length, climate::ClimateMode *mode);
+bool decode_temp_response(const uint8_t *data, size_t length, TempData *temp);
+PowerState decode_power(const uint8_t *data, size_t length);
+
+// Status byte[30] single-byte room temperature heuristic
+float raw_to_celsius(uint8_t raw);
+
+}  // namespace tcl_ac
+}  // namespace esphome
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace tcl_ac {
+
+// Protocol Constants - VALIDATED from UART log analysis (both.txt)
+
+// Packet Headers - CRITICAL: Direction matters!
+// MCU → AC: BB 00 01
+static const uint8_t HEADER_MCU_TO_AC_0 = 0xBB;
+static const uint8_t HEADER_MCU_TO_AC_1 = 0x00;
+static const uint8_t HEADER_MCU_TO_AC_2 = 0x01;
+// AC → MCU: BB 01 00 (bytes 1-2 swapped!)
+static const uint8_t HEADER_AC_TO_MCU_0 = 0xBB;
+static const uint8_t HEADER_AC_TO_MCU_1 = 0x01;
+static const uint8_t HEADER_AC_TO_MCU_2 = 0x00;
+
+// Commands
+static const uint8_t CMD_SET_PARAMS = 0x03;  // MCU → AC: Set parameters (AC responds with same cmd)
+static const uint8_t CMD_POLL = 0x04;        // MCU → AC: Poll status
+static const uint8_t CMD_TEMP_RESPONSE = 0x05;
+static const uint8_t CMD_STATUS_ECHO = 0x06;  // AC → MCU: Status echo (received only)
+static const uint8_t CMD_SHORT_STATUS = 0x09;
+static const uint8_t CMD_POWER = 0x0A;
+static const uint8_t CMD_TIME = 0x0B;
+
+// Packet sizes
+static const uint8_t SET_PACKET_SIZE = 38;
+static const uint8_t POLL_PACKET_SIZE = 7;
+static const uint8_t STATUS_DATA_SIZE = 55;  // Payload of 0x03/0x04/0x06 status frames
+static const uint8_t STATUS_MIN_DATA_SIZE = 32;  // Shortest status payload documented (38-byte frames)
+static const uint8_t SHORT_STATUS_DATA_SIZE = 45;  // Payload of 0x09 short status frames
+static const uint8_t TEMP_DATA_SIZE = 4;  // Longest 0x05 temperature payload expected
+static const uint8_t TEMP_MIN_DATA_SIZE = 3;  // 9-byte frames, as documented; the decoder reads bytes 0 and 2
+static const size_t RX_BUFFER_SIZE = 128;  // Largest AC frame seen is 61 bytes (55-byte status)
+
+// Line timing: 9600 baud 8E1 = start + 8 data + parity + stop = 11 bits per byte
+static const uint32_t UART_BYTE_TIME_US = 11 * 1000000 / 9600;  // ~1.15 ms
+// A frame is sent back to back. When the line has been quiet for this long
+// with a frame still incomplete, the rest is not coming: its length byte was
+// wrong or bytes were lost. The margin covers UART drivers that hand over
+// received bytes only after a few idle byte times.
+static const uint32_t RX_GAP_TIMEOUT_US = 16 * UART_BYTE_TIME_US;  // ~18 ms
+static const size_t UART_TX_FIFO_SIZE = 128;  // Hardware TX FIFO on ESP8266 and ESP32
+static const size_t TX_QUEUE_SIZE = 8;  // Frames waiting for the line
+static const size_t RX_QUEUE_SIZE = 8;  // Validated frames between the RX task and loop()
+
+// Field bit positions and codes of the SET/status payload: see tcl_ac_schema.h
+
+// Direction Positions - VALIDATED from log
+static const uint8_t VERTICAL_POS_LAST = 0;
+static const uint8_t VERTICAL_POS_MAX_UP = 1;
+static const uint8_t VERTICAL_POS_UP = 2;
+static const uint8_t VERTICAL_POS_CENTER = 3;
+static const uint8_t VERTICAL_POS_DOWN = 4;
+static const uint8_t VERTICAL_POS_MAX_DOWN = 5;  // DEFAULT - 75% in log
+
+static const uint8_t HORIZONTAL_POS_LAST = 0;
+static const uint8_t HORIZONTAL_POS_MAX_LEFT = 1;
+static const uint8_t HORIZONTAL_POS_LEFT = 2;
+static const uint8_t HORIZONTAL_POS_CENTER = 3;
+static const uint8_t HORIZONTAL_POS_RIGHT = 4;
+static const uint8_t HORIZONTAL_POS_MAX_RIGHT = 5;  // DEFAULT - 60% in log
+
+// Swing Modes - Full range based on tclac protocol
+static const uint8_t VERTICAL_SWING_OFF = 0;
+static const uint8_t VERTICAL_SWING_FULL = 1;      // UP_DOWN - Full swing
+static const uint8_t VERTICAL_SWING_UPPER = 2;     // UPSIDE - Upper half
+static const uint8_t VERTICAL_SWING_LOWER = 3;     // DOWNSIDE - Lower half
+
+static const uint8_t HORIZONTAL_SWING_OFF = 0;
+static const uint8_t HORIZONTAL_SWING_FULL = 1;    // LEFT_RIGHT
+static const uint8_t HORIZONTAL_SWING_LEFT = 2;    // LEFTSIDE
+static const uint8_t HORIZONTAL_SWING_CENTER = 3;  // CENTER
+static const uint8_t HORIZONTAL_SWING_RIGHT = 4;   // RIGHTSIDE
+
+// Enums for better type safety
+enum class AirflowVerticalDirection : uint8_t {
+  LAST = 0,
+  MAX_UP = 1,
+  UP = 2,
+  CENTER = 3,
+  DOWN = 4,
+  MAX_DOWN = 5,
+};
+
+enum class AirflowHorizontalDirection : uint8_t {
+  LAST = 0,
+  MAX_LEFT = 1,
+  LEFT = 2,
+  CENTER = 3,
+  RIGHT = 4,
+  MAX_RIGHT = 5,
+};
+
+enum class VerticalSwingDirection : uint8_t {
+  OFF = 0,
+  UP_DOWN = 1,
+  UPSIDE = 2,
+  DOWNSIDE = 3,
+};
+
+enum class HorizontalSwingDirection : uint8_t {
+  OFF = 0,
+  LEFT_RIGHT = 1,
+  LEFTSIDE = 2,
+  CENTER = 3,
+  RIGHTSIDE = 4,
+};
+
+}  // namespace tcl_ac
+}  // namespace esphome
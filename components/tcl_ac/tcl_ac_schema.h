@@ -0,0 +1,246 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "esphome/components/climate/climate.h"
+#include "tcl_ac_protocol.h"
+
+namespace esphome {
+namespace tcl_ac {
+
+// Protocol field schema - the one place where bit positions are written down.
+//
+// The SET payload (MCU → AC, 32 bytes) and the 0x03/0x04/0x06 status payload
+// (AC → MCU, 55 bytes) share their layout for everything the MCU can set.
+// Offsets below are payload offsets, i.e. SET packet byte - 5 (FRAME_HEADER_SIZE).
+//
+// Each field is a type carrying its offset and mask as template constants.
+// The encoder in tcl_ac_codec.cpp builds its per-value patch tables from
+// these at compile time and the decoders read through them, so every access
+// compiles down to a fixed byte/mask operation. Enum fields also list their
+// wire codes, from which lookup tables are generated in both directions.
+
+template<uint8_t MASK> constexpr uint8_t mask_shift() {
+  uint8_t shift = 0;
+  while (((MASK >> shift) & 1) == 0)
+    shift++;
+  return shift;
+}
+
+template<uint8_t OFFSET, uint8_t MASK> struct BitField {
+  static_assert(MASK != 0, "Field mask must not be empty");
+  static constexpr uint8_t offset = OFFSET;
+  static constexpr uint8_t mask = MASK;
+  static constexpr uint8_t shift = mask_shift<MASK>();
+  static constexpr uint8_t max = MASK >> shift;
+
+  static constexpr uint8_t bits(uint8_t raw) { return static_cast<uint8_t>(raw << shift) & MASK; }
+  static uint8_t read(const uint8_t *payload) { return (payload[OFFSET] & MASK) >> shift; }
+};
+
+template<typename E> struct EnumCode {
+  E value;
+  uint8_t raw;
+};
+
+// ========== Payload byte 2 (SET byte 7): power and feature flags ==========
+using PowerFlag = BitField<2, 0x04>;
+using EcoFlag = BitField<2, 0x80>;      // 1x observed
+using DisplayFlag = BitField<2, 0x40>;  // 7x observed
+using BeeperFlag = BitField<2, 0x20>;   // 52/53 observed - DEFAULT ON
+
+// ========== Payload byte 3 (SET byte 8): operating mode and feature flags ==========
+using QuietFlag = BitField<3, 0x80>;    // 1x observed; also fan mode QUIET
+using TurboFlag = BitField<3, 0x40>;    // 3x observed; also fan mode DIFFUSE
+using HealthFlag = BitField<3, 0x20>;   // Position identified, not observed
+using ComfortFlag = BitField<3, 0x10>;  // Preset COMFORT
+
+// Bits 0-3 carry the operating mode on Model B only (see the profiles below)
+
+// ========== Payload byte 5 (SET byte 10): vertical swing ==========
+using VerticalSwingFlag = BitField<5, 0x38>;  // ESPHome swing VERTICAL/BOTH, all bits set
+
+// ========== Payload byte 6 (SET byte 11): horizontal swing ==========
+using HorizontalSwingFlag = BitField<6, 0x08>;  // ESPHome swing HORIZONTAL/BOTH
+
+// ========== Payload byte 14 (SET byte 19): sleep mode ==========
+// Observed: 48x 0 (off), 1x 1, 2x 2. Preset SLEEP sends 1.
+using SleepField = BitField<14, 0x03>;
+
+// ========== Payload byte 27 (SET byte 32): vertical louvre ==========
+// Bits 3-4: swing range (TCLAC Lines 559-580), bits 0-2: fixed position (Lines 608-628)
+struct VerticalRangeField : BitField<27, 0x18> {
+  static constexpr EnumCode<VerticalSwingDirection> CODES[] = {
+      {VerticalSwingDirection::OFF, 0},    {VerticalSwingDirection::UP_DOWN, 1},
+      {VerticalSwingDirection::UPSIDE, 2}, {VerticalSwingDirection::DOWNSIDE, 3},
+  };
+  static constexpr VerticalSwingDirection FALLBACK = VerticalSwingDirection::OFF;
+};
+struct VerticalPositionField : BitField<27, 0x07> {
+  static constexpr EnumCode<AirflowVerticalDirection> CODES[] = {
+      {AirflowVerticalDirection::LAST, 0},   {AirflowVerticalDirection::MAX_UP, 1},
+      {AirflowVerticalDirection::UP, 2},     {AirflowVerticalDirection::CENTER, 3},
+      {AirflowVerticalDirection::DOWN, 4},   {AirflowVerticalDirection::MAX_DOWN, 5},
+  };
+  static constexpr AirflowVerticalDirection FALLBACK = AirflowVerticalDirection::LAST;
+};
+
+// ========== Payload byte 28 (SET byte 33): horizontal louvre ==========
+// Bits 3-5: swing range (TCLAC Lines 582-606), bits 0-2: fixed position (Lines 630-656)
+struct HorizontalRangeField : BitField<28, 0x38> {
+  static constexpr EnumCode<HorizontalSwingDirection> CODES[] = {
+      {HorizontalSwingDirection::OFF, 0},      {HorizontalSwingDirection::LEFT_RIGHT, 1},
+      {HorizontalSwingDirection::LEFTSIDE, 2}, {HorizontalSwingDirection::CENTER, 3},
+      {HorizontalSwingDirection::RIGHTSIDE, 4},
+  };
+  static constexpr HorizontalSwingDirection FALLBACK = HorizontalSwingDirection::OFF;
+};
+struct HorizontalPositionField : BitField<28, 0x07> {
+  static constexpr EnumCode<AirflowHorizontalDirection> CODES[] = {
+      {AirflowHorizontalDirection::LAST, 0},   {AirflowHorizontalDirection::MAX_LEFT, 1},
+      {AirflowHorizontalDirection::LEFT, 2},   {AirflowHorizontalDirection::CENTER, 3},
+      {AirflowHorizontalDirection::RIGHT, 4},  {AirflowHorizontalDirection::MAX_RIGHT, 5},
+  };
+  static constexpr AirflowHorizontalDirection FALLBACK = AirflowHorizontalDirection::LAST;
+};
+
+// ========== Model profiles ==========
+// TCL units speak two variants of the SET/status layout (PROTOCOL.md,
+// "Protocol Differences Between Models"). They share every field above and
+// differ in where the operating mode, fan speed and target temperature live.
+// The variant is chosen with `model:` in YAML and compiled in as ActiveModel;
+// the codec is a template on the profile, so firmware contains only one.
+
+// Fan speed codes, the same on both models. Observed: 44x 1 (LOW), 2x 3
+// (MEDIUM), 1x 7 (HIGH). QUIET and DIFFUSE have no speed code and are sent as
+// QuietFlag / TurboFlag instead.
+template<uint8_t OFFSET> struct FanField : BitField<OFFSET, 0x07> {
+  static constexpr EnumCode<climate::ClimateFanMode> CODES[] = {
+      {climate::CLIMATE_FAN_AUTO, 0},   {climate::CLIMATE_FAN_LOW, 1},    {climate::CLIMATE_FAN_MEDIUM, 3},
+      {climate::CLIMATE_FAN_FOCUS, 5},  {climate::CLIMATE_FAN_MIDDLE, 6}, {climate::CLIMATE_FAN_HIGH, 7},
+  };
+  static constexpr climate::ClimateFanMode FALLBACK = climate::CLIMATE_FAN_AUTO;
+};
+
+// Model B: the tclac layout (Kannix2005/tclac, I-am-nightingale/tclac), which
+// this component has always sent. Operating mode in byte 8 bits 0-3, fan
+// speed in byte 10 bits 0-2, target temperature in byte 9 as 111 - °C.
+struct ModelB {
+  static constexpr const char *NAME = "B";
+
+  // Operating mode (TCLAC Lines 429-460). OFF is PowerFlag clear; modes
+  // without a code (HEAT_COOL) are sent as COOL.
+  static constexpr bool HAS_MODE = true;
+  struct Mode : BitField<3, 0x0F> {
+    static constexpr EnumCode<climate::ClimateMode> CODES[] = {
+        {climate::CLIMATE_MODE_HEAT, 0b00001},     {climate::CLIMATE_MODE_DRY, 0b00010},
+        {climate::CLIMATE_MODE_COOL, 0b00011},     {climate::CLIMATE_MODE_FAN_ONLY, 0b00111},
+        {climate::CLIMATE_MODE_AUTO, 0b01000},
+    };
+    static constexpr climate::ClimateMode FALLBACK = climate::CLIMATE_MODE_COOL;
+  };
+  using Fan = FanField<5>;
+
+  // TCLAC Line 668
+  using TargetTemperature = BitField<4, 0xFF>;
+  static constexpr uint8_t target_raw(int celsius) { return static_cast<uint8_t>(111 - celsius); }
+  static constexpr int target_celsius(uint8_t raw) { return 111 - raw; }
+
+  // Payload bytes the SET template carries besides the common constants
+  static constexpr void set_constants(uint8_t *payload) { payload[24] = 0x20; }
+};
+
+// Model A: the unit captured for PROTOCOL.md. Fan speed in byte 8 bits 0-2,
+// target temperature in byte 31 as °C + 12. Byte 9 held 0x56 and byte 30
+// 0x20 in every captured SET; both are sent unchanged. The captures did not reveal where the
+// operating mode goes (byte 7 only carries power), so the unit keeps its own.
+struct ModelA {
+  static constexpr const char *NAME = "A";
+
+  static constexpr bool HAS_MODE = false;
+  // The one mode a powered-on frame decodes to, and the only one offered
+  static constexpr climate::ClimateMode ON_MODE = climate::CLIMATE_MODE_COOL;
+  using Fan = FanField<3>;
+
+  using TargetTemperature = BitField<26, 0xFF>;
+  static constexpr uint8_t target_raw(int celsius) { return static_cast<uint8_t>(celsius + 12); }
+  static constexpr int target_celsius(uint8_t raw) { return raw - 12; }
+
+  static constexpr void set_constants(uint8_t *payload) {
+    payload[4] = 0x56;
+    payload[25] = 0x20;
+  }
+};
+
+#ifdef TCL_AC_MODEL_A
+using ActiveModel = ModelA;
+#else
+using ActiveModel = ModelB;
+#endif
+
+// Smallest payload holding every field above (the SET payload is 32 bytes)
+static const uint8_t SCHEMA_PAYLOAD_SIZE = 29;
+
+// ========== Enum field codec ==========
+// Lookup tables generated at compile time from F::CODES: value → raw
+// (values without a code use F::FALLBACK's code) and raw → value.
+
+template<typename F> constexpr size_t enum_value_limit() {
+  size_t limit = 0;
+  for (const auto &code : F::CODES) {
+    if (static_cast<size_t>(code.value) + 1 > limit)
+      limit = static_cast<size_t>(code.value) + 1;
+  }
+  return limit;
+}
+
+template<typename F> constexpr uint8_t enum_fallback_raw() {
+  for (const auto &code : F::CODES) {
+    if (code.value == F::FALLBACK)
+      return code.raw;
+  }
+  return 0;
+}
+
+static const uint8_t NO_CODE = 0xFF;
+
+template<typename F> struct EnumTables {
+  uint8_t raw[enum_value_limit<F>()];  // Indexed by enum value
+  uint8_t value[F::max + 1];           // Indexed by raw code; NO_CODE if unknown
+};
+
+template<typename F> constexpr EnumTables<F> make_enum_tables() {
+  EnumTables<F> tables{};
+  for (auto &raw : tables.raw)
+    raw = enum_fallback_raw<F>();
+  for (auto &value : tables.value)
+    value = NO_CODE;
+  for (const auto &code : F::CODES) {
+    tables.raw[static_cast<size_t>(code.value)] = code.raw;
+    tables.value[code.raw] = static_cast<uint8_t>(code.value);
+  }
+  return tables;
+}
+
+template<typename F> struct EnumCodec {
+  using Enum = decltype(F::CODES[0].value);
+  static constexpr size_t LIMIT = enum_value_limit<F>();
+  static constexpr EnumTables<F> TABLES = make_enum_tables<F>();
+
+  static constexpr uint8_t to_raw(Enum value) {
+    size_t i = static_cast<size_t>(value);
+    return i < LIMIT ? TABLES.raw[i] : enum_fallback_raw<F>();
+  }
+  // False if the payload holds a code the schema does not know
+  static bool read(const uint8_t *payload, Enum *value) {
+    uint8_t v = TABLES.value[F::read(payload)];
+    if (v == NO_CODE)
+      return false;
+    *value = static_cast<Enum>(v);
+    return true;
+  }
+};
+
+}  // namespace tcl_ac
+}  // namespace esphome
@@ -0,0 +1,713 @@
+// SET encoder check and benchmark.
+//
+// Verifies that encode_set_packet() is bit-exact with the switch-based
+// encoder it replaced (kept below as the reference), then reports encode
+// ns/frame for both. Exits non-zero on the first mismatch.
+//
+// The reference added its bits, so a flag requested twice (eco_mode with
+// preset ECO, quiet_mode with fan QUIET, turbo_mode with fan DIFFUSE)
+// carried into the next bit; the schema encoder ORs them. The reference is
+// fed the settings with the duplicate removed, which is what it meant.
+//
+// Every checked input is also decoded again with decode_settings(), which
+// shares the field schema with the encoder: the result must equal the
+// input in canonical form (aliases resolved, unknown codes replaced by the
+// fallback the encoder sends, temperature rounded), and encoding that
+// canonical form must give the same packet. The reference is the Model B
+// encoder; the round trip runs for both model profiles, and each profile
+// is checked against fixed golden frames.
+//
+// Coverage: every combination of the eight enum fields, including one
+// out-of-range value each, and every combination of the seven flags with
+// mode, fan and preset, the other fields that share bytes 7 and 8 with them.
+// The target temperature is swept separately.
+
+#include "tcl_ac_codec.h"
+#include "tcl_ac_schema.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace esphome;
+using namespace esphome::tcl_ac;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+// The encoder as it was before the lookup tables, minus its log calls
+void legacy_encode_set_packet(const AcSettings &settings, uint8_t *packet) {
+  // COMPLETE TCLAC PROTOCOL IMPLEMENTATION
+  // Based on https://github.com/Kannix2005/tclac Lines 393-711
+  
+  memset(packet, 0, SET_PACKET_SIZE);
+  
+  // Header (bytes 0-2)
+  packet[0] = HEADER_MCU_TO_AC_0;  // 0xBB
+  packet[1] = HEADER_MCU_TO_AC_1;  // 0x00
+  packet[2] = HEADER_MCU_TO_AC_2;  // 0x01
+  
+  // Command and length (bytes 3-4)
+  packet[3] = CMD_SET_PARAMS;  // 0x03 = control
+  packet[4] = 0x20;  // 32 data bytes (decimal 32)
+  
+  // Data payload starts at offset 5
+  packet[5] = 0x03;
+  packet[6] = 0x01;
+  
+  // Initialize control bytes to zero (will be built up with bit operations)
+  packet[7]  = 0x00;  // Mode/Power/Display/Beeper/ECO
+  packet[8]  = 0x00;  // Mode details/Quiet/Turbo/Health
+  packet[9]  = 0x00;  // Temperature (will be set below)
+  packet[10] = 0x00;  // Fan speed/Swing vertical
+  packet[11] = 0x00;  // Swing horizontal
+  packet[12] = 0x00;  // Fahrenheit/Timer
+  packet[13] = 0x01;  // Fixed
+  packet[14] = 0x00;  // Half degree
+  packet[15] = 0x00;
+  packet[16] = 0x00;
+  packet[17] = 0x00;
+  packet[18] = 0x00;
+  packet[19] = 0x00;  // Sleep mode
+  packet[20] = 0x00;
+  packet[21] = 0x00;
+  packet[22] = 0x00;
+  packet[23] = 0x00;
+  packet[24] = 0x00;
+  packet[25] = 0x00;
+  packet[26] = 0x00;
+  packet[27] = 0x00;
+  packet[28] = 0x00;
+  packet[29] = 0x20;  // Fixed
+  packet[30] = 0x00;
+  packet[31] = 0x00;
+  packet[32] = 0x00;  // Vertical swing mode + airflow position
+  packet[33] = 0x00;  // Horizontal swing mode + airflow position
+  packet[34] = 0x00;
+  packet[35] = 0x00;
+  packet[36] = 0x00;
+  
+  // ========== Byte 7: Power/Display/Beeper/ECO ==========
+  // Bit 7 (0x80): ECO mode
+  // Bit 6 (0x40): DISPLAY
+  // Bit 5 (0x20): BEEPER
+  // Bit 2 (0x04): POWER ON
+  
+  if (settings.eco_mode) {
+    packet[7] += 0b10000000;  // ECO mode
+  }
+  
+  if (settings.display_state) {
+    packet[7] += 0b01000000;  // Display ON
+  }
+  
+  if (settings.beeper_state) {
+    packet[7] += 0b00100000;  // Beeper ON
+  }
+  
+  // ========== Configure operating mode (TCLAC Lines 429-460) ==========
+  switch (settings.mode) {
+    case climate::CLIMATE_MODE_OFF:
+      packet[7] += 0b00000000;
+      packet[8] += 0b00000000;
+      break;
+    case climate::CLIMATE_MODE_AUTO:
+      packet[7] += 0b00000100;  // Power ON
+      packet[8] += 0b00001000;  // AUTO mode
+      break;
+    case climate::CLIMATE_MODE_COOL:
+      packet[7] += 0b00000100;  // Power ON
+      packet[8] += 0b00000011;  // COOL mode
+      break;
+    case climate::CLIMATE_MODE_DRY:
+      packet[7] += 0b00000100;  // Power ON
+      packet[8] += 0b00000010;  // DRY mode
+      break;
+    case climate::CLIMATE_MODE_FAN_ONLY:
+      packet[7] += 0b00000100;  // Power ON
+      packet[8] += 0b00000111;  // FAN mode
+      break;
+    case climate::CLIMATE_MODE_HEAT:
+      packet[7] += 0b00000100;  // Power ON
+      packet[8] += 0b00000001;  // HEAT mode
+      break;
+    default:
+      packet[7] += 0b00000100;
+      packet[8] += 0b00000011;  // Default COOL
+      break;
+  }
+
+  // ========== Byte 8: Quiet/Turbo/Health/Mode details ==========
+  // Bit 7 (0x80): QUIET mode
+  // Bit 6 (0x40): TURBO mode
+  // Bit 5 (0x20): HEALTH mode
+  // Bits 0-4: Mode details (already set above)
+  
+  if (settings.quiet_mode) {
+    packet[8] += 0b10000000;  // QUIET
+  }
+  
+  if (settings.turbo_mode) {
+    packet[8] += 0b01000000;  // TURBO
+  }
+  
+  if (settings.health_mode) {
+    packet[8] += 0b00100000;  // HEALTH
+  }
+
+  // ========== Configure fan mode (TCLAC Lines 462-496) ==========
+  switch (settings.fan_mode) {
+    case climate::CLIMATE_FAN_AUTO:
+      packet[8]  += 0b00000000;
+      packet[10] += 0b00000000;
+      break;
+    case climate::CLIMATE_FAN_QUIET:
+      packet[8]  += 0b10000000;
+      packet[10] += 0b00000000;
+      break;
+    case climate::CLIMATE_FAN_LOW:
+      packet[8]  += 0b00000000;
+      packet[10] += 0b00000001;
+      break;
+    case climate::CLIMATE_FAN_MIDDLE:
+      packet[8]  += 0b00000000;
+      packet[10] += 0b00000110;
+      break;
+    case climate::CLIMATE_FAN_MEDIUM:
+      packet[8]  += 0b00000000;
+      packet[10] += 0b00000011;
+      break;
+    case climate::CLIMATE_FAN_HIGH:
+      packet[8]  += 0b00000000;
+      packet[10] += 0b00000111;
+      break;
+    case climate::CLIMATE_FAN_FOCUS:
+      packet[8]  += 0b00000000;
+      packet[10] += 0b00000101;
+      break;
+    case climate::CLIMATE_FAN_DIFFUSE:
+      packet[8]  += 0b01000000;
+      packet[10] += 0b00000000;
+      break;
+    default:
+      packet[8]  += 0b00000000;
+      packet[10] += 0b00000000;
+      break;
+  }
+
+  // ========== Configure swing mode (TCLAC Lines 498-515) ==========
+  // ESPHome's built-in swing modes (VERTICAL/HORIZONTAL/BOTH/OFF)
+  switch (settings.swing_mode) {
+    case climate::CLIMATE_SWING_OFF:
+      packet[10] += 0b00000000;
+      packet[11] += 0b00000000;
+      break;
+    case climate::CLIMATE_SWING_VERTICAL:
+      packet[10] += 0b00111000;  // Vertical swing ON
+      packet[11] += 0b00000000;
+      break;
+    case climate::CLIMATE_SWING_HORIZONTAL:
+      packet[10] += 0b00000000;
+      packet[11] += 0b00001000;  // Horizontal swing ON
+      break;
+    case climate::CLIMATE_SWING_BOTH:
+      packet[10] += 0b00111000;  // Both swings ON
+      packet[11] += 0b00001000;
+      break;
+    default:
+      packet[10] += 0b00000000;
+      packet[11] += 0b00000000;
+      break;
+  }
+
+  // ========== Configure presets (TCLAC Lines 517-530) ==========
+  switch (settings.preset) {
+    case climate::CLIMATE_PRESET_NONE:
+      break;
+    case climate::CLIMATE_PRESET_ECO:
+      packet[7] += 0b10000000;  // ECO flag (duplicate but safe)
+      break;
+    case climate::CLIMATE_PRESET_SLEEP:
+      packet[19] += 0b00000001;  // Sleep mode
+      break;
+    case climate::CLIMATE_PRESET_COMFORT:
+      packet[8] += 0b00010000;  // Comfort/Health flag
+      break;
+    default:
+      break;
+  }
+
+  // ========== Temperature (TCLAC Line 668) ==========
+  packet[9] = 111 - (int)(settings.target_temperature + 0.5f);
+
+  // ========== Vertical Swing Direction (TCLAC Lines 559-580) ==========
+  // Byte 32 bits 3-4 (mask 0b00011000): Swing direction
+  //   00 = OFF, 01 = UP_DOWN, 10 = UPSIDE, 11 = DOWNSIDE
+  switch (settings.vertical_swing) {
+    case VerticalSwingDirection::OFF:
+      packet[32] += 0b00000000;
+      break;
+    case VerticalSwingDirection::UP_DOWN:
+      packet[32] += 0b00001000;
+      break;
+    case VerticalSwingDirection::UPSIDE:
+      packet[32] += 0b00010000;
+      break;
+    case VerticalSwingDirection::DOWNSIDE:
+      packet[32] += 0b00011000;
+      break;
+  }
+
+  // ========== Horizontal Swing Direction (TCLAC Lines 582-606) ==========
+  // Byte 33 bits 3-5 (mask 0b00111000): Swing direction
+  switch (settings.horizontal_swing) {
+    case HorizontalSwingDirection::OFF:
+      packet[33] += 0b00000000;
+      break;
+    case HorizontalSwingDirection::LEFT_RIGHT:
+      packet[33] += 0b00001000;
+      break;
+    case HorizontalSwingDirection::LEFTSIDE:
+      packet[33] += 0b00010000;
+      break;
+    case HorizontalSwingDirection::CENTER:
+      packet[33] += 0b00011000;
+      break;
+    case HorizontalSwingDirection::RIGHTSIDE:
+      packet[33] += 0b00100000;
+      break;
+  }
+
+  // ========== Vertical Airflow Position (TCLAC Lines 608-628) ==========
+  // Byte 32 bits 0-2 (mask 0b00000111): Fixed position
+  //   000 = LAST, 001 = MAX_UP, 010 = UP, 011 = CENTER, 100 = DOWN, 101 = MAX_DOWN
+  switch (settings.vertical_airflow) {
+    case AirflowVerticalDirection::LAST:
+      packet[32] += 0b00000000;
+      break;
+    case AirflowVerticalDirection::MAX_UP:
+      packet[32] += 0b00000001;
+      break;
+    case AirflowVerticalDirection::UP:
+      packet[32] += 0b00000010;
+      break;
+    case AirflowVerticalDirection::CENTER:
+      packet[32] += 0b00000011;
+      break;
+    case AirflowVerticalDirection::DOWN:
+      packet[32] += 0b00000100;
+      break;
+    case AirflowVerticalDirection::MAX_DOWN:
+      packet[32] += 0b00000101;
+      break;
+  }
+
+  // ========== Horizontal Airflow Position (TCLAC Lines 630-656) ==========
+  // Byte 33 bits 0-2 (mask 0b00000111): Fixed position
+  switch (settings.horizontal_airflow) {
+    case AirflowHorizontalDirection::LAST:
+      packet[33] += 0b00000000;
+      break;
+    case AirflowHorizontalDirection::MAX_LEFT:
+      packet[33] += 0b00000001;
+      break;
+    case AirflowHorizontalDirection::LEFT:
+      packet[33] += 0b00000010;
+      break;
+    case AirflowHorizontalDirection::CENTER:
+      packet[33] += 0b00000011;
+      break;
+    case AirflowHorizontalDirection::RIGHT:
+      packet[33] += 0b00000100;
+      break;
+    case AirflowHorizontalDirection::MAX_RIGHT:
+      packet[33] += 0b00000101;
+      break;
+  }
+  
+  // ========== Checksum (last byte) ==========
+  packet[SET_PACKET_SIZE - 1] = calculate_checksum(packet, SET_PACKET_SIZE - 1);
+  
+}
+
+const uint8_t MODES = climate::CLIMATE_MODE_AUTO + 2;  // One past the last value each
+const uint8_t FANS = climate::CLIMATE_FAN_QUIET + 2;
+const uint8_t PRESETS = climate::CLIMATE_PRESET_ACTIVITY + 2;
+const uint8_t SWINGS = climate::CLIMATE_SWING_HORIZONTAL + 2;
+const uint8_t VERTICAL_SWINGS = 5;
+const uint8_t HORIZONTAL_SWINGS = 6;
+const uint8_t AIRFLOWS = 7;
+const float TEMPERATURES[] = {16.0f, 16.5f, 17.0f, 20.4f, 22.0f, 24.5f, 26.0f, 28.7f, 30.0f, 31.5f, 32.0f};
+
+void set_flags(AcSettings *settings, unsigned flags) {
+  settings->eco_mode = flags & 1;
+  settings->turbo_mode = flags & 2;
+  settings->quiet_mode = flags & 4;
+  settings->health_mode = flags & 8;
+  settings->display_state = flags & 16;
+  settings->beeper_state = flags & 32;
+  // Bit 6 selects the louvre defaults, so flags vary bytes 32/33 as well
+  if (flags & 64) {
+    settings->vertical_airflow = AirflowVerticalDirection::MAX_DOWN;
+    settings->horizontal_airflow = AirflowHorizontalDirection::MAX_RIGHT;
+  }
+}
+
+// The same request without flags that the reference would add twice
+AcSettings without_duplicates(AcSettings settings) {
+  if (settings.preset == climate::CLIMATE_PRESET_ECO)
+    settings.eco_mode = false;
+  if (settings.fan_mode == climate::CLIMATE_FAN_QUIET)
+    settings.quiet_mode = false;
+  if (settings.fan_mode == climate::CLIMATE_FAN_DIFFUSE)
+    settings.turbo_mode = false;
+  return settings;
+}
+
+// What decode_settings_for<M>() can give back for these settings, decoding
+// into a default AcSettings
+template<typename M> AcSettings canonical(AcSettings settings) {
+  switch (settings.mode) {
+    case climate::CLIMATE_MODE_OFF:
+    case climate::CLIMATE_MODE_COOL:
+    case climate::CLIMATE_MODE_HEAT:
+    case climate::CLIMATE_MODE_FAN_ONLY:
+    case climate::CLIMATE_MODE_DRY:
+    case climate::CLIMATE_MODE_AUTO:
+      break;
+    default:
+      settings.mode = climate::CLIMATE_MODE_COOL;
+      break;
+  }
+  if (!M::HAS_MODE && settings.mode != climate::CLIMATE_MODE_OFF)
+    settings.mode = climate::CLIMATE_MODE_COOL;  // Only power is on the wire
+  switch (settings.fan_mode) {
+    case climate::CLIMATE_FAN_LOW:
+    case climate::CLIMATE_FAN_MEDIUM:
+    case climate::CLIMATE_FAN_HIGH:
+    case climate::CLIMATE_FAN_MIDDLE:
+    case climate::CLIMATE_FAN_FOCUS:
+      break;
+    case climate::CLIMATE_FAN_QUIET:
+      settings.quiet_mode = true;
+      settings.fan_mode = climate::CLIMATE_FAN_AUTO;
+      break;
+    case climate::CLIMATE_FAN_DIFFUSE:
+      settings.turbo_mode = true;
+      settings.fan_mode = climate::CLIMATE_FAN_AUTO;
+      break;
+    default:
+      settings.fan_mode = climate::CLIMATE_FAN_AUTO;
+      break;
+  }
+  switch (settings.preset) {
+    case climate::CLIMATE_PRESET_ECO:
+      settings.eco_mode = true;
+      settings.preset = climate::CLIMATE_PRESET_NONE;
+      break;
+    case climate::CLIMATE_PRESET_SLEEP:
+    case climate::CLIMATE_PRESET_COMFORT:
+      break;
+    default:
+      settings.preset = climate::CLIMATE_PRESET_NONE;
+      break;
+  }
+  if (settings.swing_mode > climate::CLIMATE_SWING_HORIZONTAL)
+    settings.swing_mode = climate::CLIMATE_SWING_OFF;
+  if (settings.vertical_swing > VerticalSwingDirection::DOWNSIDE)
+    settings.vertical_swing = VerticalSwingDirection::OFF;
+  if (settings.horizontal_swing > HorizontalSwingDirection::RIGHTSIDE)
+    settings.horizontal_swing = HorizontalSwingDirection::OFF;
+  if (settings.vertical_airflow > AirflowVerticalDirection::MAX_DOWN)
+    settings.vertical_airflow = AirflowVerticalDirection::LAST;
+  if (settings.horizontal_airflow > AirflowHorizontalDirection::MAX_RIGHT)
+    settings.horizontal_airflow = AirflowHorizontalDirection::LAST;
+  settings.target_temperature = (float) (int) (settings.target_temperature + 0.5f);
+  return settings;
+}
+
+// Field-by-field comparison; prints the fields that differ
+bool same_settings(const AcSettings &a, const AcSettings &b) {
+  bool same = true;
+#define CHECK_FIELD(field) \
+  if (a.field != b.field) { \
+    printf("  %s: expected %d, got %d\n", #field, (int) a.field, (int) b.field); \
+    same = false; \
+  }
+  CHECK_FIELD(mode)
+  CHECK_FIELD(fan_mode)
+  CHECK_FIELD(preset)
+  CHECK_FIELD(swing_mode)
+  CHECK_FIELD(eco_mode)
+  CHECK_FIELD(turbo_mode)
+  CHECK_FIELD(quiet_mode)
+  CHECK_FIELD(health_mode)
+  CHECK_FIELD(display_state)
+  CHECK_FIELD(beeper_state)
+  CHECK_FIELD(vertical_swing)
+  CHECK_FIELD(horizontal_swing)
+  CHECK_FIELD(vertical_airflow)
+  CHECK_FIELD(horizontal_airflow)
+#undef CHECK_FIELD
+  if (a.target_temperature != b.target_temperature) {
+    printf("  target_temperature: expected %.1f, got %.1f\n", a.target_temperature, b.target_temperature);
+    same = false;
+  }
+  return same;
+}
+
+uint64_t checked = 0;
+
+void print_settings(const char *what, const AcSettings &settings) {
+  printf("%s mode=%u fan=%u preset=%u swing=%u vswing=%u hswing=%u vair=%u hair=%u temp=%.2f\n", what,
+         settings.mode, settings.fan_mode, settings.preset, settings.swing_mode, (unsigned) settings.vertical_swing,
+         (unsigned) settings.horizontal_swing, (unsigned) settings.vertical_airflow,
+         (unsigned) settings.horizontal_airflow, settings.target_temperature);
+}
+
+bool same_packet(const uint8_t *expected, const uint8_t *actual) {
+  if (memcmp(expected, actual, SET_PACKET_SIZE) == 0)
+    return true;
+  for (size_t i = 0; i < SET_PACKET_SIZE; i++) {
+    if (expected[i] != actual[i])
+      printf("  byte %2zu: expected 0x%02X, got 0x%02X\n", i, expected[i], actual[i]);
+  }
+  return false;
+}
+
+// Round trip through the decoder. The temperature byte holds 111 - °C or
+// °C + 12 and the encoder rounds half up only for positive values, so the
+// temperature sweep's far ends are left out.
+template<typename M> bool check_round_trip(const AcSettings &settings) {
+  if (settings.target_temperature < 0.0f || settings.target_temperature > 111.0f)
+    return true;
+  uint8_t packet[SET_PACKET_SIZE];
+  encode_set_packet_for<M>(settings, packet);
+  AcSettings decoded;
+  AcSettings expected = canonical<M>(settings);
+  if (!decode_settings_for<M>(packet + 5, SET_PACKET_SIZE - 6, &decoded) || !same_settings(expected, decoded)) {
+    printf("model %s: ", M::NAME);
+    print_settings("ROUND TRIP", settings);
+    return false;
+  }
+  uint8_t again[SET_PACKET_SIZE];
+  encode_set_packet_for<M>(expected, again);
+  if (!same_packet(packet, again)) {
+    printf("model %s: ", M::NAME);
+    print_settings("CANONICAL ENCODING", settings);
+    return false;
+  }
+  return true;
+}
+
+bool check(const AcSettings &settings) {
+  uint8_t expected[SET_PACKET_SIZE];
+  uint8_t actual[SET_PACKET_SIZE];
+  legacy_encode_set_packet(without_duplicates(settings), expected);
+  encode_set_packet_for<ModelB>(settings, actual);
+  checked++;
+  if (!same_packet(expected, actual)) {
+    print_settings("MISMATCH", settings);
+    return false;
+  }
+  return check_round_trip<ModelB>(settings) && check_round_trip<ModelA>(settings);
+}
+
+// ========== Golden frames ==========
+// Model A's first frame is the SET example from PROTOCOL.md as captured on
+// the unit; the others follow its byte map. Model B's are what the tclac
+// encoder sent for the same settings.
+
+struct GoldenFrame {
+  AcSettings settings;
+  uint8_t a[SET_PACKET_SIZE];
+  uint8_t b[SET_PACKET_SIZE];
+};
+
+std::vector<GoldenFrame> golden_frames() {
+  std::vector<GoldenFrame> frames;
+  AcSettings settings;
+
+  // Cool, 22 °C, fan low, beeper on, louvres max down / max right
+  settings.mode = climate::CLIMATE_MODE_COOL;
+  settings.target_temperature = 22.0f;
+  settings.fan_mode = climate::CLIMATE_FAN_LOW;
+  settings.vertical_airflow = AirflowVerticalDirection::MAX_DOWN;
+  settings.horizontal_airflow = AirflowHorizontalDirection::MAX_RIGHT;
+  frames.push_back({settings,
+                    {0xBB, 0x00, 0x01, 0x03, 0x20, 0x03, 0x01, 0x24, 0x01, 0x56, 0x00, 0x00, 0x00,
+                     0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                     0x00, 0x00, 0x00, 0x00, 0x20, 0x22, 0x05, 0x05, 0x00, 0x00, 0x00, 0xEB},
+                    {0xBB, 0x00, 0x01, 0x03, 0x20, 0x03, 0x01, 0x24, 0x03, 0x59, 0x01, 0x00, 0x00,
+                     0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                     0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x05, 0x05, 0x00, 0x00, 0x00, 0xC5}});
+
+  // Heat, 26 °C, fan high, display on, full swing both ways, preset comfort
+  settings.mode = climate::CLIMATE_MODE_HEAT;
+  settings.target_temperature = 26.0f;
+  settings.fan_mode = climate::CLIMATE_FAN_HIGH;
+  settings.display_state = true;
+  settings.swing_mode = climate::CLIMATE_SWING_BOTH;
+  settings.vertical_swing = VerticalSwingDirection::UP_DOWN;
+  settings.horizontal_swing = HorizontalSwingDirection::LEFT_RIGHT;
+  settings.preset = climate::CLIMATE_PRESET_COMFORT;
+  frames.push_back({settings,
+                    {0xBB, 0x00, 0x01, 0x03, 0x20, 0x03, 0x01, 0x64, 0x17, 0x56, 0x38, 0x08, 0x00,
+                     0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                     0x00, 0x00, 0x00, 0x00, 0x20, 0x26, 0x0D, 0x0D, 0x00, 0x00, 0x00, 0x89},
+                    {0xBB, 0x00, 0x01, 0x03, 0x20, 0x03, 0x01, 0x64, 0x11, 0x55, 0x3F, 0x08, 0x00,
+                     0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                     0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x0D, 0x0D, 0x00, 0x00, 0x00, 0xAD}});
+
+  // Auto, 24 °C, preset ECO (with the ECO flag, as apply_preset_() sets it), fan quiet
+  settings = AcSettings();
+  settings.mode = climate::CLIMATE_MODE_AUTO;
+  settings.target_temperature = 24.0f;
+  settings.preset = climate::CLIMATE_PRESET_ECO;
+  settings.eco_mode = true;
+  settings.fan_mode = climate::CLIMATE_FAN_QUIET;
+  settings.vertical_airflow = AirflowVerticalDirection::CENTER;
+  settings.horizontal_airflow = AirflowHorizontalDirection::CENTER;
+  frames.push_back({settings,
+                    {0xBB, 0x00, 0x01, 0x03, 0x20, 0x03, 0x01, 0xA4, 0x80, 0x56, 0x00, 0x00, 0x00,
+                     0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                     0x00, 0x00, 0x00, 0x00, 0x20, 0x24, 0x03, 0x03, 0x00, 0x00, 0x00, 0xEC},
+                    {0xBB, 0x00, 0x01, 0x03, 0x20, 0x03, 0x01, 0xA4, 0x88, 0x57, 0x00, 0x00, 0x00,
+                     0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                     0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x03, 0x03, 0x00, 0x00, 0x00, 0xC1}});
+
+  // Off, 20 °C, beeper on
+  settings = AcSettings();
+  settings.target_temperature = 20.0f;
+  frames.push_back({settings,
+                    {0xBB, 0x00, 0x01, 0x03, 0x20, 0x03, 0x01, 0x20, 0x00, 0x56, 0x00, 0x00, 0x00,
+                     0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                     0x00, 0x00, 0x00, 0x00, 0x20, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0xEC},
+                    {0xBB, 0x00, 0x01, 0x03, 0x20, 0x03, 0x01, 0x20, 0x00, 0x5B, 0x00, 0x00, 0x00,
+                     0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                     0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xC1}});
+  return frames;
+}
+
+bool verify_golden() {
+  uint8_t packet[SET_PACKET_SIZE];
+  for (const auto &frame : golden_frames()) {
+    encode_set_packet_for<ModelA>(frame.settings, packet);
+    if (!same_packet(frame.a, packet)) {
+      print_settings("GOLDEN model A", frame.settings);
+      return false;
+    }
+    encode_set_packet_for<ModelB>(frame.settings, packet);
+    if (!same_packet(frame.b, packet)) {
+      print_settings("GOLDEN model B", frame.settings);
+      return false;
+    }
+    if (!check(frame.settings))
+      return false;
+  }
+  return true;
+}
+
+bool verify() {
+  AcSettings settings;
+  uint32_t n = 0;
+
+  // All enum combinations; flags and temperature rotate along
+  for (uint8_t mode = 0; mode < MODES; mode++)
+    for (uint8_t fan = 0; fan < FANS; fan++)
+      for (uint8_t preset = 0; preset < PRESETS; preset++)
+        for (uint8_t swing = 0; swing < SWINGS; swing++)
+          for (uint8_t vs = 0; vs < VERTICAL_SWINGS; vs++)
+            for (uint8_t hs = 0; hs < HORIZONTAL_SWINGS; hs++)
+              for (uint8_t va = 0; va < AIRFLOWS; va++)
+                for (uint8_t ha = 0; ha < AIRFLOWS; ha++) {
+                  settings = AcSettings();
+                  set_flags(&settings, n % 64);
+                  settings.mode = static_cast<climate::ClimateMode>(mode);
+                  settings.fan_mode = static_cast<climate::ClimateFanMode>(fan);
+                  settings.preset = static_cast<climate::ClimatePreset>(preset);
+                  settings.swing_mode = static_cast<climate::ClimateSwingMode>(swing);
+                  settings.vertical_swing = static_cast<VerticalSwingDirection>(vs);
+                  settings.horizontal_swing = static_cast<HorizontalSwingDirection>(hs);
+                  settings.vertical_airflow = static_cast<AirflowVerticalDirection>(va);
+                  settings.horizontal_airflow = static_cast<AirflowHorizontalDirection>(ha);
+                  settings.target_temperature = TEMPERATURES[n % (sizeof(TEMPERATURES) / sizeof(float))];
+                  n++;
+                  if (!check(settings))
+                    return false;
+                }
+
+  // All flag combinations against everything else that adds into bytes 7/8
+  for (unsigned flags = 0; flags < 128; flags++)
+    for (uint8_t mode = 0; mode < MODES; mode++)
+      for (uint8_t fan = 0; fan < FANS; fan++)
+        for (uint8_t preset = 0; preset < PRESETS; preset++)
+          for (float temperature : TEMPERATURES) {
+            settings = AcSettings();
+            set_flags(&settings, flags);
+            settings.mode = static_cast<climate::ClimateMode>(mode);
+            settings.fan_mode = static_cast<climate::ClimateFanMode>(fan);
+            settings.preset = static_cast<climate::ClimatePreset>(preset);
+            settings.target_temperature = temperature;
+            if (!check(settings))
+              return false;
+          }
+
+  // Temperature, including values the climate traits never allow
+  for (int t = -500; t <= 1500; t++) {
+    settings = AcSettings();
+    settings.mode = climate::CLIMATE_MODE_COOL;
+    settings.target_temperature = t / 10.0f;
+    if (!check(settings))
+      return false;
+  }
+  return true;
+}
+
+template<typename F> double time_encoder(F &&encode, const std::vector<AcSettings> &inputs) {
+  uint8_t packet[SET_PACKET_SIZE];
+  uint8_t sink = 0;
+  const int REPS = 200;
+  auto start = Clock::now();
+  for (int r = 0; r < REPS; r++) {
+    for (const auto &settings : inputs) {
+      encode(settings, packet);
+      sink ^= packet[SET_PACKET_SIZE - 1];
+    }
+  }
+  double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+  if (sink == 0x5A)
+    printf(" ");  // Keep the results observable
+  return ns / (static_cast<double>(REPS) * inputs.size());
+}
+
+}  // namespace
+
+int main() {
+  if (!verify_golden())
+    return 1;
+  printf("golden frames: %zu per model, models A and B\n", golden_frames().size());
+  if (!verify())
+    return 1;
+  printf("bit-exact and round trip: %llu settings checked\n", static_cast<unsigned long long>(checked));
+
+  // Realistic inputs: valid values only
+  std::vector<AcSettings> inputs;
+  for (uint32_t i = 0; i < 4096; i++) {
+    AcSettings settings;
+    set_flags(&settings, (i * 37) % 128);
+    settings.mode = static_cast<climate::ClimateMode>(i % (MODES - 1));
+    settings.fan_mode = static_cast<climate::ClimateFanMode>((i / 7) % (FANS - 1));
+    settings.preset = static_cast<climate::ClimatePreset>((i / 3) % (PRESETS - 1));
+    settings.swing_mode = static_cast<climate::ClimateSwingMode>((i / 5) % (SWINGS - 1));
+    settings.vertical_swing = static_cast<VerticalSwingDirection>((i / 11) % (VERTICAL_SWINGS - 1));
+    settings.horizontal_swing = static_cast<HorizontalSwingDirection>((i / 13) % (HORIZONTAL_SWINGS - 1));
+    settings.target_temperature = 16 + (i % 33) * 0.5f;
+    inputs.push_back(settings);
+  }
+  double legacy = time_encoder(legacy_encode_set_packet, inputs);
+  double schema = time_encoder(encode_set_packet_for<ModelB>, inputs);
+  printf("encode: switch %.1f ns/frame, schema %.1f ns/frame (%.1fx)\n", legacy, schema, legacy / schema);
+  return 0;
+}
@@ -0,0 +1,480 @@
+// Receive framer benchmark: FrameReader vs. the previous std::vector framer.
+//
+// Reports throughput (bytes/s) on clean, noisy and adversarial streams, the
+// per-byte cost of the slowest blocks, and how many valid frames survive a
+// corrupted length byte. Then times recovery from corrupted length bytes on
+// a 9600 baud wire read by AcLink, with and without the length table and the
+// inter-byte gap timeout, and compares reading the UART a byte at a time
+// with reading it in bulk into the framer.
+//
+// Exits non-zero if the shipped configuration (length table + gap timeout)
+// loses a good frame or recovers slower than a loop period past the gap
+// timeout, or if per-byte and bulk reads deliver different frame counts.
+
+#include "ac_link.h"
+#include "frame_reader.h"
+#include "esphome/components/uart/uart.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace esphome::tcl_ac;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+// The framer that lived in TclAcClimate::loop() before FrameReader.
+class LegacyFramer {
+ public:
+  template<typename F> void push(uint8_t byte, F &&on_frame) {
+    rx_buffer_.push_back(byte);
+    if (rx_buffer_.size() >= 7) {
+      if (rx_buffer_[0] == 0xBB && rx_buffer_[1] == 0x01 && rx_buffer_[2] == 0x00) {
+        uint8_t length = rx_buffer_[4];
+        size_t expected_size = 5 + length + 1;
+        if (rx_buffer_.size() >= expected_size) {
+          uint8_t calculated = 0;
+          for (size_t i = 0; i < expected_size - 1; i++)
+            calculated ^= rx_buffer_[i];
+          on_frame(rx_buffer_.data() + 5, length, calculated == rx_buffer_[expected_size - 1]);
+          rx_buffer_.clear();
+        }
+      } else {
+        rx_buffer_.erase(rx_buffer_.begin());
+      }
+    }
+  }
+
+ private:
+  std::vector<uint8_t> rx_buffer_;
+};
+
+void append_frame(std::vector<uint8_t> &out, uint8_t cmd, uint8_t len, std::mt19937 &rng) {
+  size_t start = out.size();
+  out.insert(out.end(), {0xBB, 0x01, 0x00, cmd, len});
+  for (uint8_t i = 0; i < len; i++)
+    out.push_back(static_cast<uint8_t>(rng()));
+  uint8_t checksum = 0;
+  for (size_t i = start; i < out.size(); i++)
+    checksum ^= out[i];
+  out.push_back(checksum);
+}
+
+// Traffic mix seen on the line: status echo, power, temp, short status
+std::vector<uint8_t> make_stream(size_t target, std::mt19937 &rng) {
+  static const uint8_t CMDS[][2] = {{0x06, 55}, {0x0A, 45}, {0x05, 4}, {0x09, 45}, {0x04, 55}};
+  std::vector<uint8_t> out;
+  out.reserve(target + 64);
+  size_t i = 0;
+  while (out.size() < target) {
+    const uint8_t *c = CMDS[i++ % 5];
+    append_frame(out, c[0], c[1], rng);
+  }
+  return out;
+}
+
+void corrupt(std::vector<uint8_t> &stream, double rate, std::mt19937 &rng) {
+  std::bernoulli_distribution hit(rate);
+  for (auto &b : stream) {
+    if (hit(rng))
+      b = static_cast<uint8_t>(rng());
+  }
+}
+
+struct Result {
+  double bytes_per_s;
+  size_t frames_ok;
+  size_t frames_bad;
+  double worst_push_ns;
+};
+
+Result run_legacy(const std::vector<uint8_t> &stream) {
+  LegacyFramer framer;
+  Result r{0, 0, 0, 0};
+  volatile uint8_t sink = 0;
+  auto on_frame = [&](const uint8_t *payload, uint8_t len, bool ok) {
+    sink = sink + payload[len ? len - 1 : 0];
+    ok ? r.frames_ok++ : r.frames_bad++;
+  };
+  auto t0 = Clock::now();
+  for (uint8_t b : stream)
+    framer.push(b, on_frame);
+  double s = std::chrono::duration<double>(Clock::now() - t0).count();
+  r.bytes_per_s = stream.size() / s;
+  return r;
+}
+
+Result run_reader(const std::vector<uint8_t> &stream) {
+  FrameReader<128> reader;
+  Result r{0, 0, 0, 0};
+  volatile uint8_t sink = 0;
+  auto t0 = Clock::now();
+  for (uint8_t b : stream) {
+    reader.push(b);
+    Frame frame;
+    while (reader.next(&frame)) {
+      sink = sink + frame.payload[frame.length ? frame.length - 1 : 0];
+      frame.checksum_ok() ? r.frames_ok++ : r.frames_bad++;
+    }
+  }
+  double s = std::chrono::duration<double>(Clock::now() - t0).count();
+  r.bytes_per_s = stream.size() / s;
+  return r;
+}
+
+// Per-byte cost of the slowest blocks (99.9th percentile of 64-byte blocks,
+// so scheduler noise and the clock read itself do not dominate)
+template<typename Run> double worst_block_ns(const std::vector<uint8_t> &stream, Run &&run) {
+  const size_t block = 64;
+  std::vector<double> samples;
+  samples.reserve(stream.size() / block);
+  for (size_t off = 0; off + block <= stream.size(); off += block) {
+    auto t0 = Clock::now();
+    run(&stream[off], block);
+    samples.push_back(std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / block);
+  }
+  if (samples.empty())
+    return 0;
+  std::sort(samples.begin(), samples.end());
+  return samples[samples.size() * 999 / 1000];
+}
+
+void report(const char *name, const std::vector<uint8_t> &stream) {
+  Result legacy = run_legacy(stream);
+  Result reader = run_reader(stream);
+
+  LegacyFramer lf;
+  auto noop = [](const uint8_t *, uint8_t, bool) {};
+  legacy.worst_push_ns = worst_block_ns(stream, [&](const uint8_t *p, size_t n) {
+    for (size_t i = 0; i < n; i++)
+      lf.push(p[i], noop);
+  });
+  FrameReader<128> fr;
+  reader.worst_push_ns = worst_block_ns(stream, [&](const uint8_t *p, size_t n) {
+    Frame frame;
+    for (size_t i = 0; i < n; i++) {
+      fr.push(p[i]);
+      while (fr.next(&frame)) {
+      }
+    }
+  });
+
+  printf("%s (%zu bytes)\n", name, stream.size());
+  printf("  %-8s %10.1f MB/s  ok=%-8zu bad=%-8zu p99.9=%.1f ns/byte\n", "legacy", legacy.bytes_per_s / 1e6,
+         legacy.frames_ok, legacy.frames_bad, legacy.worst_push_ns);
+  printf("  %-8s %10.1f MB/s  ok=%-8zu bad=%-8zu p99.9=%.1f ns/byte\n", "ring", reader.bytes_per_s / 1e6,
+         reader.frames_ok, reader.frames_bad, reader.worst_push_ns);
+}
+
+// AC traffic on the wire as AcLink sees it from the component loop: bytes
+// become readable when their last bit has arrived
+class WireTransport : public AcTransport {
+ public:
+  void add(const uint8_t *data, size_t length, uint64_t start_us) {
+    for (size_t i = 0; i < length; i++) {
+      this->bytes_.push_back(data[i]);
+      this->at_us_.push_back(start_us + (i + 1) * UART_BYTE_TIME_US);
+    }
+  }
+  uint64_t end_us() const { return this->at_us_.empty() ? 0 : this->at_us_.back(); }
+  void set_now_us(uint64_t now) { this->now_ = now; }
+
+  size_t rx_available() override {
+    return this->pos_ < this->bytes_.size() && this->at_us_[this->pos_] <= this->now_;
+  }
+  bool rx_read_array(uint8_t *data, size_t length) override {
+    for (size_t i = 0; i < length; i++) {
+      if (!this->rx_available())
+        return false;
+      data[i] = this->bytes_[this->pos_++];
+    }
+    return true;
+  }
+  void tx_write(const uint8_t *, size_t) override {}
+  uint32_t now_ms() override { return this->now_ / 1000; }
+  uint32_t now_us() override { return static_cast<uint32_t>(this->now_); }
+
+ protected:
+  std::vector<uint8_t> bytes_;
+  std::vector<uint64_t> at_us_;
+  size_t pos_{0};
+  uint64_t now_{0};
+};
+
+struct RecoveryResult {
+  size_t corrupted;
+  size_t good;
+  size_t delivered;
+  std::vector<double> recovery_ms;  // First good frame after a corruption: arrival to delivery
+  uint32_t gap_timeouts;
+};
+
+// Every 1.3 s the AC sends a status echo and, right behind it, one frame of
+// the rotation. One frame in `every` cycles gets one bit of its length byte
+// flipped. Each payload starts with a sequence number to match deliveries.
+RecoveryResult run_recovery(bool check_lengths, uint32_t gap_timeout_us, size_t cycles, size_t every) {
+  static const uint8_t ROTATION[][2] = {{0x09, 45}, {0x05, 4}, {0x0A, 45}};
+  std::mt19937 rng(0xF4A3E);
+  WireTransport wire;
+  RecoveryResult result{0, 0, 0, {}, 0};
+
+  std::vector<uint64_t> frame_end;   // Per sequence number; 0 = corrupted
+  std::vector<uint32_t> after_corruption;  // Sequence numbers of the first good frame after each corruption
+  uint64_t start = 100000;
+  for (size_t cycle = 0; cycle < cycles; cycle++) {
+    const uint8_t *rotation = ROTATION[cycle % 3];
+    uint8_t frames[2][2] = {{0x06, 55}, {rotation[0], rotation[1]}};
+    size_t victim = cycle % every == 0 ? rng() % 2 : 2;
+    uint64_t at = start;
+    for (size_t f = 0; f < 2; f++) {
+      std::vector<uint8_t> frame;
+      append_frame(frame, frames[f][0], frames[f][1], rng);
+      uint32_t seq = frame_end.size();
+      frame[5] = seq & 0xFF;
+      frame[6] = seq >> 8;
+      uint8_t checksum = 0;
+      for (size_t i = 0; i + 1 < frame.size(); i++)
+        checksum ^= frame[i];
+      frame.back() = checksum;
+      if (f == victim) {
+        frame[4] ^= 1 << (rng() % 8);  // After the checksum: the frame is lost either way
+        frame_end.push_back(0);
+        result.corrupted++;
+        after_corruption.push_back(seq + 1);
+      } else {
+        frame_end.push_back(at + frame.size() * UART_BYTE_TIME_US);
+        result.good++;
+      }
+      wire.add(frame.data(), frame.size(), at);
+      at += frame.size() * UART_BYTE_TIME_US;
+    }
+    start += 1300000 + rng() % 16000;  // Jitter against the loop period
+  }
+
+  std::vector<uint64_t> delivered(frame_end.size(), 0);
+  AcLink link(&wire);
+  link.set_check_lengths(check_lengths);
+  link.set_rx_gap_timeout(gap_timeout_us);
+  uint64_t now = 0;
+  link.set_frame_callback([&](const Frame &frame) {
+    if (!frame.checksum_ok() || frame.length < 2)
+      return;
+    uint32_t seq = frame.payload[0] | (frame.payload[1] << 8);
+    if (seq < delivered.size() && frame_end[seq] != 0 && delivered[seq] == 0) {
+      delivered[seq] = now;
+      result.delivered++;
+    }
+  });
+  // Component loop every 16 ms, then the line stays quiet for a while
+  for (now = 0; now < wire.end_us() + 2000000; now += 16000) {
+    wire.set_now_us(now);
+    link.loop();
+  }
+
+  // From the good frame's arrival to its delivery, or to the delivery of the
+  // next one if it was lost
+  for (uint32_t seq : after_corruption) {
+    uint32_t next = seq;
+    while (next < delivered.size() && (frame_end[next] == 0 || delivered[next] == 0))
+      next++;
+    if (next >= delivered.size() || seq >= frame_end.size() || frame_end[seq] == 0)
+      continue;
+    result.recovery_ms.push_back((delivered[next] - frame_end[seq]) / 1000.0);
+  }
+  result.gap_timeouts = link.get_rx_gap_timeouts();
+  return result;
+}
+
+struct RecoverySummary {
+  size_t lost;
+  double max_ms;
+};
+
+RecoverySummary report_recovery(const char *name, bool check_lengths, uint32_t gap_timeout_us) {
+  RecoveryResult r = run_recovery(check_lengths, gap_timeout_us, 4000, 4);
+  std::vector<double> &ms = r.recovery_ms;
+  std::sort(ms.begin(), ms.end());
+  auto pct = [&](double p) { return ms.empty() ? 0.0 : ms[static_cast<size_t>(p * (ms.size() - 1))]; };
+  RecoverySummary summary{r.good - r.delivered, ms.empty() ? 0.0 : ms.back()};
+  printf("  %-22s lost=%-5zu recovery p50=%7.1f p99=%7.1f max=%7.1f ms  gap timeouts=%u\n", name, summary.lost,
+         pct(0.5), pct(0.99), summary.max_ms, r.gap_timeouts);
+  return summary;
+}
+
+// UART whose receive buffer is refilled `chunk` bytes at a time, as the
+// component loop finds it: at 9600 baud a 16 ms loop sees about 14 new
+// bytes, or a whole burst when the driver hands it over at once
+class ChunkedUART : public esphome::uart::UARTComponent {
+ public:
+  ChunkedUART(const std::vector<uint8_t> &stream, size_t chunk) : stream_(stream), chunk_(chunk) {}
+  bool refill() {
+    if (this->limit_ >= this->stream_.size())
+      return false;
+    this->limit_ = std::min(this->limit_ + this->chunk_, this->stream_.size());
+    return true;
+  }
+  void write_array(const uint8_t *, size_t) override {}
+  bool peek_byte(uint8_t *data) override {
+    if (this->pos_ >= this->limit_)
+      return false;
+    *data = this->stream_[this->pos_];
+    return true;
+  }
+  bool read_array(uint8_t *data, size_t len) override {
+    if (this->limit_ - this->pos_ < len)
+      return false;
+    memcpy(data, &this->stream_[this->pos_], len);
+    this->pos_ += len;
+    return true;
+  }
+  int available() override { return this->limit_ - this->pos_; }
+  void flush() override {}
+
+ protected:
+  const std::vector<uint8_t> &stream_;
+  size_t chunk_;
+  size_t pos_{0};
+  size_t limit_{0};
+};
+
+struct IngestResult {
+  double ns_per_byte;
+  size_t frames;
+};
+
+// The receive loop before: available() and read_byte() per byte, each byte
+// pushed and framed on its own
+template<typename OnFrame> void ingest_per_byte(esphome::uart::UARTDevice &device, FrameReader<128> &reader,
+                                                OnFrame &&on_frame) {
+  while (device.available()) {
+    uint8_t byte;
+    if (!device.read_byte(&byte))
+      break;
+    reader.push(byte);
+    Frame frame;
+    while (reader.next(&frame))
+      on_frame(frame);
+  }
+}
+
+// As AcLink::receive_() reads now: one read_array() into the framer's buffer
+// per call, then one framing pass
+template<typename OnFrame> void ingest_bulk(esphome::uart::UARTDevice &device, FrameReader<128> &reader,
+                                            OnFrame &&on_frame) {
+  size_t available;
+  while ((available = device.available()) > 0) {
+    uint8_t *window;
+    size_t length = std::min(available, reader.write_window(&window));
+    if (!device.read_array(window, length))
+      break;
+    reader.commit(length);
+    Frame frame;
+    while (reader.next(&frame))
+      on_frame(frame);
+  }
+}
+
+template<typename Ingest> IngestResult run_ingest(const std::vector<uint8_t> &stream, size_t chunk, Ingest &&ingest) {
+  IngestResult best{1e9, 0};
+  for (int round = 0; round < 5; round++) {
+    ChunkedUART uart(stream, chunk);
+    esphome::uart::UARTDevice device(&uart);
+    FrameReader<128> reader;
+    size_t frames = 0;
+    volatile uint8_t sink = 0;
+    auto on_frame = [&](const Frame &frame) {
+      sink = sink + frame.checksum;
+      if (frame.checksum_ok())
+        frames++;
+    };
+    auto t0 = Clock::now();
+    while (uart.refill())
+      ingest(device, reader, on_frame);
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / stream.size();
+    if (ns < best.ns_per_byte)
+      best = {ns, frames};
+  }
+  return best;
+}
+
+// False if the two ways of reading deliver different frame counts
+bool report_ingest(const char *name, const std::vector<uint8_t> &stream) {
+  printf("%s (%zu bytes)\n", name, stream.size());
+  bool same = true;
+  for (size_t chunk : {14, 112, 1024}) {
+    IngestResult per_byte = run_ingest(stream, chunk, [](esphome::uart::UARTDevice &d, FrameReader<128> &r,
+                                                         auto &f) { ingest_per_byte(d, r, f); });
+    IngestResult bulk = run_ingest(stream, chunk, [](esphome::uart::UARTDevice &d, FrameReader<128> &r,
+                                                     auto &f) { ingest_bulk(d, r, f); });
+    printf("  %4zu-byte reads  per byte %6.2f ns/byte  bulk %6.2f ns/byte  (%.1fx)  frames %zu / %zu\n", chunk,
+           per_byte.ns_per_byte, bulk.ns_per_byte, per_byte.ns_per_byte / bulk.ns_per_byte, per_byte.frames,
+           bulk.frames);
+    same = same && per_byte.frames == bulk.frames;
+  }
+  return same;
+}
+
+}  // namespace
+
+int main() {
+  std::mt19937 rng(0x7C1AC);
+
+  std::vector<uint8_t> clean = make_stream(8 << 20, rng);
+  report("clean stream", clean);
+
+  std::vector<uint8_t> noisy = clean;
+  corrupt(noisy, 0.001, rng);
+  report("noisy stream (0.1% byte errors)", noisy);
+
+  // Garbage that keeps almost matching the header: worst case for resync
+  std::vector<uint8_t> garbage;
+  while (garbage.size() < (4 << 20)) {
+    garbage.insert(garbage.end(), {0xBB, 0x01, 0xBB, 0xBB, 0x01, 0x00, 0x03, 0x7F});
+  }
+  report("header-like garbage", garbage);
+
+  // A corrupted length byte (0xF0) followed by good frames
+  std::vector<uint8_t> burst;
+  append_frame(burst, 0x06, 55, rng);
+  burst[4] = 0xF0;
+  for (int i = 0; i < 5; i++)
+    append_frame(burst, 0x06, 55, rng);
+  report("corrupted length + 5 good frames", burst);
+
+  // Time from a good frame's last byte on the wire to its delivery, for the
+  // first good frame after each corrupted length byte; the loop period alone
+  // accounts for up to 16 ms
+  printf("recovery from corrupted length bytes (1000 in 4000 cycles, 16 ms loop)\n");
+  report_recovery("length byte only", false, 0);
+  report_recovery("gap timeout", false, RX_GAP_TIMEOUT_US);
+  report_recovery("length table", true, 0);
+  RecoverySummary shipped = report_recovery("length table + gap", true, RX_GAP_TIMEOUT_US);
+  // As shipped, no good frame may be lost, and none may wait longer than one
+  // loop period past the gap timeout
+  const double RECOVERY_BOUND_MS = 16.0 + RX_GAP_TIMEOUT_US / 1000.0;
+  bool ok = true;
+  if (shipped.lost != 0 || shipped.max_ms > RECOVERY_BOUND_MS) {
+    fprintf(stderr, "FAIL: length table + gap lost %zu frames, recovery max %.1f ms (bound %.1f ms)\n", shipped.lost,
+            shipped.max_ms, RECOVERY_BOUND_MS);
+    ok = false;
+  }
+
+  // UART reads: byte at a time vs. bulk, for loop-sized reads (14 bytes at a
+  // 16 ms loop), a whole status + rotation burst, and a backlog
+  printf("UART ingestion: available()/read_byte() per byte vs. read_array() into the framer\n");
+  std::vector<uint8_t> traffic(clean.begin(), clean.begin() + (1 << 20));
+  bool same = report_ingest("AC traffic", traffic);
+  std::vector<uint8_t> noise(1 << 20);
+  for (auto &b : noise)
+    b = static_cast<uint8_t>(rng() % 0xBB);  // No header byte: all skipped
+  same = report_ingest("line noise without headers", noise) && same;
+  if (!same) {
+    fprintf(stderr, "FAIL: per-byte and bulk reads delivered different frame counts\n");
+    ok = false;
+  }
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,234 @@
+// Receive path with the RX task (std::thread standing in for the FreeRTOS
+// task) against receiving in loop(), on the same byte stream.
+//
+//   bench_rx_task [bytes_per_second] [loop_work_us]
+//
+// The stream is half an hour of emulator traffic with one byte in a thousand
+// corrupted, made available at `bytes_per_second` (default 96000, ten times
+// the line rate, so the threads interleave often). Between calls to
+// AcLink::loop() the main thread busy-waits `loop_work_us` (default 0) to
+// stand in for the rest of the ESPHome loop.
+//
+// Every frame handed to the frame callback is checked against a reference
+// pass of FrameReader over the same bytes: the task must deliver the valid
+// frames in order, byte for byte, and as many with a bad checksum as loop()
+// sees, missing only those it counted as lost to a full queue. Build with -DTCL_AC_SANITIZE=thread to have ThreadSanitizer
+// watch the queue while it does.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "ac_emulator.h"
+#include "ac_link.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+
+using namespace esphome;
+using namespace esphome::tcl_ac;
+
+namespace {
+
+// Makes the stream available at a fixed rate from the first read on. Its rx
+// side is only used by whichever thread receives; writes are discarded.
+class PacedTransport : public AcTransport {
+ public:
+  PacedTransport(const std::vector<uint8_t> &data, uint32_t bytes_per_second)
+      : data_(data), bytes_per_second_(bytes_per_second) {}
+  bool done() const { return this->done_.load(std::memory_order_acquire); }
+
+  size_t rx_available() override {
+    uint64_t now = host::now_us();
+    if (this->start_us_ == 0)
+      this->start_us_ = now;
+    size_t arrived = std::min<uint64_t>(this->data_.size(), (now - this->start_us_) * this->bytes_per_second_ / 1000000);
+    if (this->pos_ == this->data_.size())
+      this->done_.store(true, std::memory_order_release);
+    return std::min<size_t>(arrived - this->pos_, 256);  // One driver buffer
+  }
+  bool rx_read_array(uint8_t *data, size_t length) override {
+    memcpy(data, this->data_.data() + this->pos_, length);
+    this->pos_ += length;
+    return true;
+  }
+  void tx_write(const uint8_t *, size_t) override {}
+  uint32_t now_ms() override { return static_cast<uint32_t>(host::now_us() / 1000); }
+  uint32_t now_us() override { return static_cast<uint32_t>(host::now_us()); }
+
+ protected:
+  const std::vector<uint8_t> &data_;
+  uint32_t bytes_per_second_;
+  uint64_t start_us_{0};
+  size_t pos_{0};
+  std::atomic<bool> done_{false};
+};
+
+std::vector<uint8_t> generate_stream() {
+  EmulatorConfig config;
+  AcEmulator emulator(config);
+  std::vector<uint8_t> stream;
+  emulator.set_output(
+      [&](const uint8_t *data, size_t length, uint32_t) { stream.insert(stream.end(), data, data + length); });
+  const uint64_t DURATION_US = 1800ULL * 1000000;
+  float room = config.room_temperature;
+  for (uint64_t t = 0; t < DURATION_US; t += 10000) {
+    if (t % (30ULL * 1000000) == 0) {
+      room += 0.1f;
+      emulator.set_room_temperature(room);
+    }
+    emulator.update(t);
+  }
+  std::mt19937 rng(21);
+  for (uint8_t &byte : stream) {
+    if (rng() % 1000 == 0)
+      byte ^= static_cast<uint8_t>(1 + rng() % 255);
+  }
+  return stream;
+}
+
+// The valid frames in the stream, as FrameReader finds them in one pass
+std::vector<std::vector<uint8_t>> reference_frames(const std::vector<uint8_t> &stream) {
+  std::vector<std::vector<uint8_t>> frames;
+  FrameReader<RX_BUFFER_SIZE> reader;
+  Frame frame;
+  for (size_t i = 0; i < stream.size(); i += 64) {
+    reader.push(stream.data() + i, std::min<size_t>(64, stream.size() - i));
+    while (reader.next(&frame)) {
+      if (frame.checksum_ok())
+        frames.emplace_back(frame.raw, frame.raw + frame.size());
+    }
+  }
+  return frames;
+}
+
+struct Result {
+  uint32_t delivered;
+  uint32_t skipped;     // Reference frames not delivered
+  uint32_t mismatched;  // Delivered frames not found in order in the reference
+  uint32_t lost;        // Counted by the task as lost to a full queue
+  uint32_t bad_checksums;  // Delivered with a bad checksum
+  uint32_t bad_lost;       // Of those lost, frames with a bad checksum
+  uint32_t bad_captured;   // Capture records of received frames with a bad checksum
+  double loop_ns_per_frame;  // Time spent in the AcLink::loop() calls that delivered frames
+  double max_loop_us;
+  double seconds;
+};
+
+Result run(const std::vector<uint8_t> &stream, const std::vector<std::vector<uint8_t>> &reference, bool task,
+           uint32_t bytes_per_second, uint32_t loop_work_us) {
+  PacedTransport transport(stream, bytes_per_second);
+  AcLink link(&transport);
+  link.set_rx_gap_timeout(0);  // The reference has no clock
+  link.set_rx_budget_bytes(0);
+  link.set_rx_budget_time(0);
+  link.set_poll_interval(3600000);
+  link.set_idle_poll_interval(3600000);
+  link.get_capture().init(4096);  // Every frame in the stream
+
+  Result result{};
+  size_t next = 0;
+  link.set_frame_callback([&](const Frame &frame) {
+    if (!frame.checksum_ok()) {
+      result.bad_checksums++;
+      return;
+    }
+    result.delivered++;
+    size_t at = next;
+    while (at < reference.size() &&
+           (reference[at].size() != frame.size() || memcmp(reference[at].data(), frame.raw, frame.size()) != 0))
+      at++;
+    if (at == reference.size()) {
+      result.mismatched++;
+      return;
+    }
+    result.skipped += at - next;
+    next = at + 1;
+  });
+
+  if (task && !link.start_rx_task(0)) {
+    fprintf(stderr, "could not start the RX task\n");
+    exit(1);
+  }
+  auto begin = std::chrono::steady_clock::now();
+  double in_loop_ns = 0;
+  uint64_t idle_until = 0;
+  while (true) {
+    uint32_t delivered = result.delivered + result.bad_checksums;
+    auto start = std::chrono::steady_clock::now();
+    link.loop();
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    if (result.delivered + result.bad_checksums != delivered)
+      in_loop_ns += ns;
+    result.max_loop_us = std::max(result.max_loop_us, ns / 1000);
+    // Done once the stream is through and a few ms have passed for the task
+    // to queue the last frames
+    if (transport.done()) {
+      if (idle_until == 0)
+        idle_until = host::now_us() + 20000;
+      else if (host::now_us() >= idle_until)
+        break;
+    }
+    uint64_t until = host::now_us() + loop_work_us;
+    while (host::now_us() < until) {
+    }
+  }
+  link.stop_rx_task();
+  // Whatever the task queued after the last loop()
+  link.loop();
+  result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+  result.skipped += reference.size() - next;
+  result.loop_ns_per_frame = in_loop_ns / std::max<uint32_t>(result.delivered, 1);
+  if (task) {
+    result.lost = link.get_rx_task().get_overflows();
+    result.bad_lost = link.get_rx_task().get_checksum_errors() - result.bad_checksums;
+  }
+  const FrameCapture &capture = link.get_capture();
+  for (size_t i = 0; i < capture.size(); i++) {
+    if (!(capture.at(i).flags & (CAPTURE_TX | CAPTURE_CHECKSUM_OK)))
+      result.bad_captured++;
+  }
+  return result;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  uint32_t bytes_per_second = argc > 1 ? static_cast<uint32_t>(atol(argv[1])) : 96000;
+  uint32_t loop_work_us = argc > 2 ? static_cast<uint32_t>(atol(argv[2])) : 0;
+  host::use_real_clock();
+  host::log_level = ESPHOME_LOG_LEVEL_ERROR;  // Warnings for every corrupted frame otherwise
+
+  std::vector<uint8_t> stream = generate_stream();
+  std::vector<std::vector<uint8_t>> reference = reference_frames(stream);
+  printf("stream: %zu bytes, %zu valid frames, at %u bytes/s, %u us of other work per loop()\n", stream.size(),
+         reference.size(), bytes_per_second, loop_work_us);
+  printf("%-8s %10s %8s %8s %8s %10s %12s %12s %8s\n", "receive", "delivered", "skipped", "wrong", "lost", "bad csum",
+         "loop ns/frm", "max loop us", "seconds");
+
+  bool ok = true;
+  uint32_t bad_checksums = 0;
+  for (bool task : {false, true}) {
+    Result r = run(stream, reference, task, bytes_per_second, loop_work_us);
+    printf("%-8s %10u %8u %8u %8u %10u %12.0f %12.1f %8.2f\n", task ? "task" : "loop()", r.delivered, r.skipped,
+           r.mismatched, r.lost, r.bad_checksums, r.loop_ns_per_frame, r.max_loop_us, r.seconds);
+    // Receiving in loop() skips nothing; the task only what it counted as lost
+    if (r.mismatched != 0 || r.skipped + r.bad_lost != r.lost)
+      ok = false;
+    // Bad checksums are captured before they are skipped, with the task too
+    if (r.bad_captured != r.bad_checksums)
+      ok = false;
+    if (!task)
+      bad_checksums = r.bad_checksums;
+    else if (r.bad_checksums + r.bad_lost != bad_checksums)
+      ok = false;
+  }
+  if (!ok) {
+    fprintf(stderr, "frames delivered or captured differ from the reference\n");
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,530 @@
+// Replays an AC → MCU byte stream through TclAcClimate and measures the
+// receive path per frame, with and without payload memoization.
+//
+//   bench_status [capture.bin]
+//
+// Without an argument the capture is generated by the emulator: one hour of
+// the unsolicited traffic a real unit sends, with the room temperature
+// drifting every few minutes so not every status frame is a repeat and the
+// mode changed from the remote every ten minutes. A file argument replays
+// raw AC → MCU bytes instead.
+//
+// Before timing, the short status (0x09) decoder is checked against the
+// capture: every short status must report the power and mode of the full
+// status frame before it. For a capture from a real unit this tells whether
+// its 0x09 frames carry them where decode_short_status() looks.
+//
+// A mode set on the climate must then survive the status frames that follow
+// the SET, run against the emulator on virtual time. Model A frames carry
+// only the power bit, so it may offer just OFF and the one mode a powered-on
+// frame decodes to; any other mode is refused, not shown unconfirmed
+// (configure with -DTCL_AC_MODEL=A to check that profile).
+//
+// Changes waiting in the coalescing window must reach the wire as they were
+// made: a temperature (0x05) or power (0x0A) frame from the unit arriving
+// inside the window must not change the SET that goes out, nor the climate
+// state while the SET is pending.
+//
+// Each configuration is timed with logging at WARN (log calls filtered out)
+// and at DEBUG written to /dev/null, which is closer to a device streaming
+// its log over the API. The frame capture is timed on its own, at WARN.
+//
+// Last, the capture is replayed as a backlog: the UART holding far more than
+// one FIFO per loop(), as after a stall of the main loop. It reports the
+// longest and the 99th percentile loop() with and without the receive budget.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <set>
+#include <vector>
+
+#include "ac_emulator.h"
+#include "esphome/core/log.h"
+#include "loopback_uart.h"
+#include "tcl_ac.h"
+#include "tcl_ac_schema.h"
+
+using namespace esphome;
+using namespace esphome::tcl_ac;
+
+namespace {
+
+// Serves a fixed byte stream as UART input; anything written is discarded
+class ReplayUART : public uart::UARTComponent {
+ public:
+  explicit ReplayUART(const std::vector<uint8_t> &data) : data_(data) {}
+  void rewind() {
+    this->pos_ = 0;
+    this->arrived_ = 0;
+  }
+  // Bytes available per loop() while the capture is read as a FIFO
+  void set_window(size_t window) { this->window_ = window; }
+  // Paced instead: `bytes` more become available, as if they had arrived
+  // since the last loop()
+  void arrive(size_t bytes) {
+    this->paced_ = true;
+    this->arrived_ = std::min(this->data_.size(), std::max(this->arrived_, this->pos_) + bytes);
+  }
+  bool done() const { return this->pos_ >= this->data_.size(); }
+
+  void write_array(const uint8_t *, size_t) override {}
+  bool peek_byte(uint8_t *data) override {
+    if (this->done())
+      return false;
+    *data = this->data_[this->pos_];
+    return true;
+  }
+  bool read_array(uint8_t *data, size_t len) override {
+    if (this->data_.size() - this->pos_ < len)
+      return false;
+    std::copy_n(this->data_.begin() + this->pos_, len, data);
+    this->pos_ += len;
+    return true;
+  }
+  int available() override {
+    if (this->paced_)
+      return static_cast<int>(this->arrived_ - this->pos_);
+    // One UART RX FIFO worth per loop(), as on the device
+    return static_cast<int>(std::min(this->window_, this->data_.size() - this->pos_));
+  }
+  void flush() override {}
+
+ protected:
+  const std::vector<uint8_t> &data_;
+  size_t pos_{0};
+  size_t window_{128};
+  bool paced_{false};
+  size_t arrived_{0};
+};
+
+std::vector<uint8_t> generate_capture(uint32_t *frames) {
+  EmulatorConfig config;
+  AcEmulator emulator(config);
+  std::vector<uint8_t> capture;
+  *frames = 0;
+  emulator.set_output([&](const uint8_t *data, size_t length, uint32_t) {
+    capture.insert(capture.end(), data, data + length);
+    (*frames)++;
+  });
+  static const climate::ClimateMode MODES[] = {climate::CLIMATE_MODE_COOL, climate::CLIMATE_MODE_OFF,
+                                               climate::CLIMATE_MODE_HEAT, climate::CLIMATE_MODE_DRY,
+                                               climate::CLIMATE_MODE_FAN_ONLY, climate::CLIMATE_MODE_AUTO};
+  const uint64_t HOUR_US = 3600ULL * 1000000;
+  float room = config.room_temperature;
+  size_t mode = 0;
+  for (uint64_t t = 0; t < HOUR_US; t += 10000) {
+    if (t % (180ULL * 1000000) == 0) {
+      room += 0.1f;
+      emulator.set_room_temperature(room);
+    }
+    if (t % (600ULL * 1000000) == 0) {
+      AcSettings settings = emulator.get_decoded_settings();
+      settings.mode = MODES[mode++ % (sizeof(MODES) / sizeof(MODES[0]))];
+      emulator.remote_control(settings);
+    }
+    emulator.update(t);
+  }
+  return capture;
+}
+
+struct ShortStatusCheck {
+  uint32_t frames;
+  uint32_t agree;
+  uint32_t mode_changes;  // Between consecutive short status frames
+};
+
+// Short status decode replayed against the full status frames in the capture
+ShortStatusCheck check_short_status(const std::vector<uint8_t> &capture) {
+  ShortStatusCheck check{};
+  FrameReader<RX_BUFFER_SIZE> reader;
+  AcSettings status;
+  bool has_status = false;
+  climate::ClimateMode last = climate::CLIMATE_MODE_OFF;
+  for (uint8_t byte : capture) {
+    reader.push(byte);
+    Frame frame;
+    while (reader.next(&frame)) {
+      if (!frame.checksum_ok())
+        continue;
+      if (frame.command == CMD_SET_PARAMS || frame.command == CMD_POLL || frame.command == CMD_STATUS_ECHO) {
+        has_status = decode_settings(frame.payload, frame.length, &status);
+      } else if (frame.command == CMD_SHORT_STATUS && has_status) {
+        climate::ClimateMode mode = status.mode;
+        if (!decode_short_status(frame.payload, frame.length, &mode))
+          continue;
+        check.frames++;
+        if (mode == status.mode)
+          check.agree++;
+        if (check.frames > 1 && mode != last)
+          check.mode_changes++;
+        last = mode;
+      }
+    }
+  }
+  return check;
+}
+
+std::vector<uint8_t> load_capture(const char *path) {
+  std::vector<uint8_t> capture;
+  FILE *f = fopen(path, "rb");
+  if (f == nullptr) {
+    perror(path);
+    return capture;
+  }
+  uint8_t buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+    capture.insert(capture.end(), buf, buf + n);
+  fclose(f);
+  return capture;
+}
+
+struct Result {
+  double ns_per_frame;
+  uint32_t memoized;
+};
+
+Result run(const std::vector<uint8_t> &capture, uint32_t frames, bool memoize, int log_level, int reps,
+           uint16_t capture_size = 0) {
+  host::log_level = log_level;
+  ReplayUART uart(capture);
+  TclAcClimate ac;
+  ac.set_uart_parent(&uart);
+  ac.set_memoize_frames(memoize);
+  ac.set_capture_size(capture_size);
+  ac.setup();
+  while (!uart.done())  // Warm up caches and the payload memo
+    ac.loop();
+
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < reps; r++) {
+    uart.rewind();
+    while (!uart.done())
+      ac.loop();
+  }
+  double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  host::log_level = ESPHOME_LOG_LEVEL_WARN;
+  return {ns / (static_cast<double>(frames) * reps), ac.get_frames_memoized()};
+}
+
+struct Backlog {
+  double max_us;  // Median over the runs of the longest loop()
+  double p99_us;
+  uint32_t hits;  // Per run
+};
+
+// loop() durations with the capture arriving at the line rate (10 ms of it
+// per loop()) and, every `stall_every` loops, `stall` bytes at once as after
+// the main loop was held up
+Backlog run_backlog(const std::vector<uint8_t> &capture, size_t stall, uint32_t stall_every, size_t budget_bytes,
+                    uint32_t budget_us, int reps) {
+  const size_t PER_LOOP = 10;  // 10 ms at 9600 baud
+  host::log_level = ESPHOME_LOG_LEVEL_DEBUG;
+  ReplayUART uart(capture);
+  TclAcClimate ac;
+  ac.set_uart_parent(&uart);
+  ac.set_rx_budget_bytes(budget_bytes);
+  ac.set_rx_budget_time(budget_us);
+  ac.setup();
+  std::vector<double> durations;
+  std::vector<double> maxima;
+  for (int r = 0; r < reps; r++) {
+    uart.rewind();
+    double longest = 0;
+    // Until the framer is drained as well: the last loop() with data may
+    // have left frames behind
+    uint32_t idle = 0;
+    for (uint32_t n = 1; idle < 2; n++) {
+      uart.arrive(n % stall_every == 0 ? stall : PER_LOOP);
+      idle = uart.done() ? idle + 1 : 0;
+      auto start = std::chrono::steady_clock::now();
+      ac.loop();
+      double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+      durations.push_back(us);
+      longest = std::max(longest, us);
+    }
+    maxima.push_back(longest);
+  }
+  host::log_level = ESPHOME_LOG_LEVEL_WARN;
+  std::sort(durations.begin(), durations.end());
+  std::sort(maxima.begin(), maxima.end());
+  return {maxima[maxima.size() / 2], durations[durations.size() * 99 / 100], ac.get_rx_budget_hits() / reps};
+}
+
+// Sets each mode the climate offers in turn and checks it is still the
+// climate's mode after a few seconds of status frames; one it does not
+// offer must leave the mode alone
+bool check_mode_kept() {
+  host::use_virtual_clock(0);
+  AcEmulator emulator;
+  LoopbackUART wire(&emulator);
+  TclAcClimate ac;
+  ac.set_uart_parent(&wire);
+  ac.setup();
+  auto run_for = [&](uint64_t us) {
+    const uint64_t end = host::now_us() + us;
+    while (host::now_us() < end) {
+      host::advance_us(16000);
+      wire.step();
+      host::run_scheduler();
+      host::call_loop(&ac);
+    }
+  };
+  run_for(3000000);
+  bool ok = true;
+  std::set<climate::ClimateMode> offered = ac.traits().get_supported_modes();
+  if (!ActiveModel::HAS_MODE) {
+    bool only_power = offered == std::set<climate::ClimateMode>{climate::CLIMATE_MODE_OFF, ModelA::ON_MODE};
+    printf("mode kept (model %s): %u mode(s) offered, %s\n", ActiveModel::NAME, (unsigned) offered.size(),
+           only_power ? "OFF and the powered-on mode" : "more than power");
+    ok = only_power;
+  }
+  for (climate::ClimateMode mode : {climate::CLIMATE_MODE_HEAT, climate::CLIMATE_MODE_DRY,
+                                    climate::CLIMATE_MODE_FAN_ONLY, climate::CLIMATE_MODE_COOL,
+                                    climate::CLIMATE_MODE_OFF}) {
+    climate::ClimateMode before = ac.mode;
+    ac.make_call().set_mode(mode).perform();
+    run_for(5000000);  // SET confirmed, then about three unsolicited status frames
+    climate::ClimateMode expected = offered.count(mode) != 0 ? mode : before;
+    printf("mode kept (model %s): set %u%s, %u after the status frames\n", ActiveModel::NAME, (unsigned) mode,
+           offered.count(mode) != 0 ? "" : " (not offered)", (unsigned) ac.mode);
+    ok = ok && ac.mode == expected;
+  }
+  host::use_real_clock();
+  return ok;
+}
+
+// The SETs the component puts on the wire, decoded
+struct SetWindowRun {
+  AcEmulator emulator;
+  LoopbackUART wire{&emulator};
+  TclAcClimate ac;
+  std::vector<AcSettings> sets;
+  std::vector<uint8_t> power_bytes;  // Frame byte 7: 0x04 is the power bit
+
+  SetWindowRun() {
+    this->ac.set_uart_parent(&this->wire);
+    this->ac.set_coalesce_window(200);  // Long enough for a 45-byte power frame to arrive inside it
+    this->wire.set_mcu_frame_callback([this](const Frame &frame) {
+      AcSettings settings;
+      if (frame.command != CMD_SET_PARAMS || !decode_settings(frame.payload, frame.length, &settings))
+        return;
+      this->sets.push_back(settings);
+      this->power_bytes.push_back(frame.payload[2]);
+    });
+    this->ac.setup();
+  }
+  void run_for(uint64_t us) {
+    const uint64_t end = host::now_us() + us;
+    while (host::now_us() < end) {
+      host::advance_us(16000);
+      this->wire.step();
+      host::run_scheduler();
+      host::call_loop(&this->ac);
+    }
+  }
+};
+
+bool check_set_window() {
+  host::use_virtual_clock(0);
+  bool ok = true;
+  {
+    // COOL 22 at the unit; 26 requested, then the unit's 0x05 still says 22
+    SetWindowRun run;
+    AcSettings cool;
+    cool.mode = climate::CLIMATE_MODE_COOL;
+    cool.target_temperature = 22.0f;
+    run.emulator.remote_control(cool);
+    run.run_for(8000000);  // First poll, then the status it brings
+    run.sets.clear();
+    run.ac.make_call().set_target_temperature(26.0f).perform();
+    run.emulator.send_now(CMD_TEMP_RESPONSE);
+    run.run_for(3000000);
+    float sent = run.sets.empty() ? 0.0f : run.sets.front().target_temperature;
+    printf("SET window: 26°C requested, 0x05 with 22°C inside the window: SET carries %.0f°C, climate %.0f°C\n",
+           sent, run.ac.target_temperature);
+    ok = ok && !run.sets.empty() && sent == 26.0f && run.ac.target_temperature == 26.0f;
+  }
+  {
+    // A burst of changes; 0x05 and 0x0A frames arrive while it is pending
+    SetWindowRun run;
+    AcSettings cool;
+    cool.mode = climate::CLIMATE_MODE_COOL;
+    cool.target_temperature = 22.0f;
+    run.emulator.remote_control(cool);
+    run.run_for(8000000);
+    run.sets.clear();
+    run.ac.make_call().set_target_temperature(24.0f).perform();
+    run.run_for(48000);
+    run.ac.make_call().set_target_temperature(25.0f).set_fan_mode(climate::CLIMATE_FAN_HIGH).perform();
+    run.emulator.send_now(CMD_TEMP_RESPONSE);
+    run.emulator.send_now(CMD_POWER);
+    run.run_for(160000);
+    float pending = run.ac.target_temperature;
+    run.run_for(3000000);
+    bool sent = !run.sets.empty() && run.sets.front().target_temperature == 25.0f &&
+                run.sets.front().fan_mode == climate::CLIMATE_FAN_HIGH;
+    printf("SET window: burst to 25°C and fan high, 0x05 and 0x0A inside it: climate %.0f°C while pending, "
+           "%u SET(s), first %s\n",
+           pending, (unsigned) run.sets.size(), sent ? "as requested" : "different");
+    ok = ok && pending == 25.0f && sent && run.ac.target_temperature == 25.0f;
+  }
+  {
+    // Unit off; COOL requested, then the unit's 0x0A still says off
+    SetWindowRun run;
+    AcSettings off;
+    run.emulator.remote_control(off);
+    run.run_for(8000000);
+    run.sets.clear();
+    run.power_bytes.clear();
+    run.ac.make_call().set_mode(climate::CLIMATE_MODE_COOL).perform();
+    run.emulator.send_now(CMD_POWER);
+    run.run_for(3000000);
+    climate::ClimateMode sent = run.sets.empty() ? climate::CLIMATE_MODE_OFF : run.sets.front().mode;
+    uint8_t power = run.power_bytes.empty() ? 0 : run.power_bytes.front();
+    printf("SET window: COOL requested, 0x0A with power off inside the window: SET byte 7 0x%02X, mode %u, unit %s\n",
+           power, (unsigned) sent, run.emulator.is_power_on() ? "on" : "off");
+    ok = ok && (power & 0x04) != 0 && sent == climate::CLIMATE_MODE_COOL && run.emulator.is_power_on();
+  }
+  {
+    // Nothing pending: a 0x0A reporting off is taken as it arrives
+    SetWindowRun run;
+    AcSettings cool;
+    cool.mode = climate::CLIMATE_MODE_COOL;
+    run.emulator.remote_control(cool);
+    run.run_for(8000000);
+    run.emulator.remote_control(AcSettings());
+    run.emulator.send_now(CMD_POWER);
+    run.run_for(240000);  // The 0x0A frame and one idle check, well before the next status frame
+    printf("SET window: nothing pending, 0x0A with power off: climate mode %u\n", (unsigned) run.ac.mode);
+    ok = ok && run.ac.mode == climate::CLIMATE_MODE_OFF;
+  }
+  host::use_real_clock();
+  return ok;
+}
+
+// loop() woken before its timer fires, the way the RX task wakes it for
+// each frame, parks again without setting a new timer every time
+bool check_idle_wake() {
+  host::use_virtual_clock(0);
+  SetWindowRun run;
+  run.run_for(8000000);
+  uint32_t parks = run.ac.get_loop_parks();
+  uint32_t timeouts = host::timeouts_set();
+  for (int i = 0; i < 125; i++) {
+    run.ac.enable_loop_soon_any_context();
+    run.run_for(16000);
+  }
+  parks = run.ac.get_loop_parks() - parks;
+  timeouts = host::timeouts_set() - timeouts;
+  printf("idle wake: loop() woken on every pass for 2 s: parked %u times, %u timeouts set\n", parks, timeouts);
+  host::use_real_clock();
+  return parks >= 100 && timeouts * 2 <= parks;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  uint32_t frames = 0;
+  std::vector<uint8_t> capture;
+  if (argc > 1) {
+    capture = load_capture(argv[1]);
+    // Approximate: one frame per header seen
+    for (size_t i = 0; i + 2 < capture.size(); i++) {
+      if (capture[i] == HEADER_AC_TO_MCU_0 && capture[i + 1] == HEADER_AC_TO_MCU_1 &&
+          capture[i + 2] == HEADER_AC_TO_MCU_2)
+        frames++;
+    }
+  } else {
+    capture = generate_capture(&frames);
+  }
+  if (frames == 0) {
+    fprintf(stderr, "no frames in capture\n");
+    return 1;
+  }
+  printf("capture: %zu bytes, %u frames\n", capture.size(), frames);
+  ShortStatusCheck shorts = check_short_status(capture);
+  printf("short status: %u frames, %u agree with the status before them on power/mode, %u mode changes\n",
+         shorts.frames, shorts.agree, shorts.mode_changes);
+  {
+    ReplayUART uart(capture);
+    TclAcClimate ac;
+    ac.set_uart_parent(&uart);
+    ac.setup();
+    while (!uart.done())
+      ac.loop();
+    printf("short status: %s by the component (%u frames)\n", ac.is_short_status_trusted() ? "used" : "not used",
+           ac.get_short_status_frames());
+    shorts.frames = ac.is_short_status_trusted() ? shorts.frames : 0;
+  }
+  if (argc <= 1 && (shorts.frames == 0 || shorts.agree != shorts.frames || shorts.mode_changes == 0)) {
+    fprintf(stderr, "short status decode does not match the emulator\n");
+    return 1;
+  }
+
+  if (!check_mode_kept()) {
+    fprintf(stderr, "a mode set on the climate did not survive the status frames\n");
+    return 1;
+  }
+  if (!check_set_window()) {
+    fprintf(stderr, "a frame from the unit changed a SET waiting in the coalescing window\n");
+    return 1;
+  }
+  if (!check_idle_wake()) {
+    fprintf(stderr, "every early wake of loop() set a new timeout\n");
+    return 1;
+  }
+
+  // DEBUG output goes to /dev/null; results are printed on stdout
+  if (freopen("/dev/null", "w", stderr) == nullptr)
+    return 1;
+
+  const int REPS = 100;
+  printf("%-8s %-8s %12s %12s\n", "log", "memo", "ns/frame", "memoized");
+  for (int level : {ESPHOME_LOG_LEVEL_WARN, ESPHOME_LOG_LEVEL_DEBUG}) {
+    double base = 0;
+    for (bool memoize : {false, true}) {
+      Result r = run(capture, frames, memoize, level, REPS);
+      if (!memoize)
+        base = r.ns_per_frame;
+      printf("%-8s %-8s %12.1f %11.1f%%", level == ESPHOME_LOG_LEVEL_WARN ? "WARN" : "DEBUG", memoize ? "on" : "off",
+             r.ns_per_frame, 100.0 * r.memoized / (static_cast<double>(frames) * (REPS + 1)));
+      if (memoize)
+        printf("   (%.1fx)", base / r.ns_per_frame);
+      printf("\n");
+    }
+  }
+
+  printf("\n%-8s %-8s %12s\n", "capture", "memo", "ns/frame");
+  for (bool memoize : {false, true}) {
+    double base = 0;
+    for (uint16_t size : {0, 256}) {
+      Result r = run(capture, frames, memoize, ESPHOME_LOG_LEVEL_WARN, REPS, size);
+      if (size == 0)
+        base = r.ns_per_frame;
+      printf("%-8s %-8s %12.1f", size == 0 ? "off" : "256", memoize ? "on" : "off", r.ns_per_frame);
+      if (size != 0)
+        printf("   (+%.1f)", r.ns_per_frame - base);
+      printf("\n");
+    }
+  }
+
+  // Two seconds of a stalled loop() at 9600 baud are about 2 KB; the larger
+  // backlogs stand in for a slower CPU, on which the same bytes take longer
+  printf("\nbacklog: a stall's worth of bytes at once every 1000 loops, 10 bytes per loop otherwise, logging at DEBUG\n");
+  printf("%-8s %-16s %10s %10s %10s\n", "stall", "budget", "max us", "p99 us", "hits");
+  struct {
+    const char *name;
+    size_t bytes;
+    uint32_t us;
+  } const BUDGETS[] = {{"none", 0, 0}, {"256 B / 10 ms", 256, 10000}, {"128 B / 10 ms", 128, 10000},
+                       {"none / 100 us", 0, 100}};
+  for (size_t stall : {2048, 16384, 65536}) {
+    for (const auto &budget : BUDGETS) {
+      Backlog b = run_backlog(capture, stall, 1000, budget.bytes, budget.us, 5);
+      printf("%-8zu %-16s %10.1f %10.1f %10u\n", stall, budget.name, b.max_us, b.p99_us, b.hits);
+    }
+  }
+  return 0;
+}
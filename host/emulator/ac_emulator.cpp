@@ -0,0 +1,240 @@
+#include "ac_emulator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace esphome {
+namespace tcl_ac {
+
+static const uint8_t STATUS_PAYLOAD_SIZE = 55;
+static const uint8_t POWER_PAYLOAD_SIZE = 45;
+static const uint8_t TEMP_PAYLOAD_SIZE = 4;
+
+// Frame bytes as PROTOCOL.md numbers them (header included), to payload offsets
+static constexpr size_t at(size_t frame_byte) { return frame_byte - FRAME_HEADER_SIZE; }
+#ifdef TCL_AC_MODEL_A
+static const size_t FAN_BYTE = 8;
+static const size_t TARGET_BYTE = 31;
+#else
+static const size_t FAN_BYTE = 10;
+static const size_t TARGET_BYTE = 9;
+#endif
+static const uint8_t FAN_HIGH = 7;
+static const uint8_t FAN_MEDIUM = 3;
+
+// Unsolicited traffic: a status echo every interval, followed by one of these
+static const uint8_t UNSOLICITED_ROTATION[] = {CMD_SHORT_STATUS, CMD_TEMP_RESPONSE, CMD_POWER};
+
+AcEmulator::AcEmulator(const EmulatorConfig &config) : config_(config), rng_(config.seed) {
+  // The SET example from PROTOCOL.md: Cool, 22°C, fan low, beeper on, louvres
+  // max down/right, in the layout of the model the component is built for
+  AcSettings settings;
+  settings.mode = climate::CLIMATE_MODE_COOL;
+  settings.target_temperature = 22.0f;
+  settings.fan_mode = climate::CLIMATE_FAN_LOW;
+  settings.vertical_airflow = AirflowVerticalDirection::MAX_DOWN;
+  settings.horizontal_airflow = AirflowHorizontalDirection::MAX_RIGHT;
+  this->remote_control(settings);
+}
+
+void AcEmulator::receive(const uint8_t *data, size_t length, uint64_t now_us) {
+  for (size_t i = 0; i < length; i++) {
+    this->reader_.push(data[i]);
+    Frame frame;
+    while (this->reader_.next(&frame)) {
+      this->handle_frame_(frame, now_us);
+    }
+  }
+}
+
+void AcEmulator::handle_frame_(const Frame &frame, uint64_t now_us) {
+  if (!frame.checksum_ok()) {
+    this->stats_.bad_frames++;
+    return;
+  }
+  uint64_t due = now_us + static_cast<uint64_t>(this->config_.response_latency_ms) * 1000;
+  switch (frame.command) {
+    case CMD_POLL:
+      this->stats_.polls_received++;
+      this->pending_.push_back({due, CMD_POLL});
+      break;
+    case CMD_SET_PARAMS:
+      this->stats_.sets_received++;
+      this->apply_set_(frame.payload, frame.length);
+      this->pending_.push_back({due, CMD_SET_PARAMS});
+      break;
+    default:
+      this->stats_.bad_frames++;
+      break;
+  }
+}
+
+void AcEmulator::apply_set_(const uint8_t *payload, uint8_t length) {
+  if (length < SET_PACKET_SIZE - FRAME_OVERHEAD) {
+    this->stats_.bad_frames++;
+    return;
+  }
+  if ((payload[at(7)] & 0x04) == 0) {
+    // Power-off frame: only the power bit changes, the unit keeps its settings
+    this->unit_.power = false;
+  } else {
+    this->read_set_(payload);
+    if (this->config_.cap_fan && this->unit_.fan == FAN_HIGH)
+      this->unit_.fan = FAN_MEDIUM;
+  }
+  this->state_version_++;
+}
+
+void AcEmulator::read_set_(const uint8_t *payload) {
+  UnitState &unit = this->unit_;
+  unit.power = (payload[at(7)] & 0x04) != 0;
+  unit.flags7 = payload[at(7)] & 0xE0;
+  unit.flags8 = payload[at(8)] & 0xF0;
+#ifndef TCL_AC_MODEL_A
+  unit.mode = payload[at(8)] & 0x0F;
+#endif
+  unit.fan = payload[at(FAN_BYTE)] & 0x07;
+  unit.target = payload[at(TARGET_BYTE)];
+  unit.vertical_swing = payload[at(10)] & 0x38;
+  unit.horizontal_swing = payload[at(11)] & 0x08;
+  unit.sleep = payload[at(19)] & 0x03;
+  unit.vertical_louvre = payload[at(32)];
+  unit.horizontal_louvre = payload[at(33)];
+}
+
+float AcEmulator::get_target_temperature() const {
+#ifdef TCL_AC_MODEL_A
+  return this->unit_.target - 12;
+#else
+  return 111 - this->unit_.target;
+#endif
+}
+
+AcSettings AcEmulator::get_decoded_settings() const {
+  uint8_t payload[STATUS_PAYLOAD_SIZE];
+  this->build_status_(payload);
+  AcSettings settings;
+  decode_settings(payload, sizeof(payload), &settings);
+  return settings;
+}
+
+void AcEmulator::remote_control(const AcSettings &settings) {
+  uint8_t packet[SET_PACKET_SIZE];
+  encode_set_packet(settings, packet);
+  this->read_set_(packet + FRAME_HEADER_SIZE);
+}
+
+void AcEmulator::build_status_(uint8_t *payload) const {
+  const UnitState &unit = this->unit_;
+  memset(payload, 0, STATUS_PAYLOAD_SIZE);
+  payload[at(7)] = unit.flags7 | (unit.power ? 0x04 : 0x00);
+  payload[at(8)] = unit.flags8 | unit.mode;
+  payload[at(FAN_BYTE)] |= unit.fan;
+  payload[at(TARGET_BYTE)] = unit.target;
+  payload[at(10)] |= unit.vertical_swing;
+  payload[at(11)] |= unit.horizontal_swing;
+  payload[at(19)] = unit.sleep;
+  payload[at(32)] = unit.vertical_louvre;
+  payload[at(33)] = unit.horizontal_louvre;
+  // Room temperature, 16-bit at data[12:13]: ((°F) * 374)
+  float fahrenheit = this->config_.room_temperature * 1.8f + 32.0f;
+  uint16_t raw16 = static_cast<uint16_t>(std::lround(fahrenheit * 374.0f));
+  payload[12] = raw16 >> 8;
+  payload[13] = raw16 & 0xFF;
+}
+
+void AcEmulator::send_(uint8_t command) {
+  uint8_t frame[FRAME_OVERHEAD + STATUS_PAYLOAD_SIZE];
+  uint8_t *payload = frame + FRAME_HEADER_SIZE;
+  uint8_t length;
+  switch (command) {
+    case CMD_POLL:
+    case CMD_SET_PARAMS:
+    case CMD_STATUS_ECHO:
+      length = STATUS_PAYLOAD_SIZE;
+      this->build_status_(payload);
+      break;
+    case CMD_SHORT_STATUS:
+      length = SHORT_STATUS_DATA_SIZE;
+      this->build_status_(payload);  // First 45 bytes of the status layout
+      break;
+    case CMD_POWER:
+      length = POWER_PAYLOAD_SIZE;
+      memset(payload, 0, length);
+      payload[0] = 0x04;
+      payload[2] = this->is_power_on() ? 0x0C : 0x04;
+      break;
+    case CMD_TEMP_RESPONSE:
+      length = TEMP_PAYLOAD_SIZE;
+      memset(payload, 0, length);
+      payload[0] = static_cast<uint8_t>(std::lround(this->config_.room_temperature) + 7);
+      payload[2] = static_cast<uint8_t>(std::lround(this->get_target_temperature()) + 12);
+      break;
+    default:
+      return;
+  }
+  frame[0] = HEADER_AC_TO_MCU_0;
+  frame[1] = HEADER_AC_TO_MCU_1;
+  frame[2] = HEADER_AC_TO_MCU_2;
+  frame[3] = command;
+  frame[4] = length;
+  frame[FRAME_HEADER_SIZE + length] = calculate_checksum(frame, FRAME_HEADER_SIZE + length);
+
+  size_t size = FRAME_OVERHEAD + length;
+  this->stats_.frames_sent++;
+  this->stats_.bytes_sent += size;
+  if (this->output_)
+    this->output_(frame, size, this->state_version_);
+}
+
+void AcEmulator::update(uint64_t now_us) {
+  // Replies in due order; pending_ is short (one entry per outstanding request)
+  std::stable_sort(this->pending_.begin(), this->pending_.end(),
+                   [](const PendingReply &a, const PendingReply &b) { return a.due_us < b.due_us; });
+  size_t done = 0;
+  while (done < this->pending_.size() && this->pending_[done].due_us <= now_us) {
+    this->send_(this->pending_[done].command);
+    done++;
+  }
+  this->pending_.erase(this->pending_.begin(), this->pending_.begin() + done);
+
+  if (this->config_.random_frame_interval_ms != 0) {
+    if (this->next_random_us_ == 0)
+      this->schedule_random_frame_(now_us);
+    while (now_us >= this->next_random_us_) {
+      this->send_(this->rng_() % 2 == 0 ? CMD_TEMP_RESPONSE : CMD_POWER);
+      this->stats_.random_frames++;
+      this->schedule_random_frame_(this->next_random_us_);
+    }
+  }
+
+  if (this->config_.unsolicited_interval_ms == 0)
+    return;
+  if (this->next_unsolicited_us_ == 0)
+    this->next_unsolicited_us_ = now_us + static_cast<uint64_t>(this->config_.unsolicited_interval_ms) * 1000;
+  while (now_us >= this->next_unsolicited_us_) {
+    this->send_(CMD_STATUS_ECHO);
+    this->send_(UNSOLICITED_ROTATION[this->unsolicited_index_++ % sizeof(UNSOLICITED_ROTATION)]);
+    this->next_unsolicited_us_ += static_cast<uint64_t>(this->config_.unsolicited_interval_ms) * 1000;
+  }
+}
+
+uint64_t AcEmulator::next_event_us() const {
+  uint64_t next = UINT64_MAX;
+  for (const auto &reply : this->pending_)
+    next = std::min(next, reply.due_us);
+  if (this->config_.unsolicited_interval_ms != 0 && this->next_unsolicited_us_ != 0)
+    next = std::min(next, this->next_unsolicited_us_);
+  if (this->config_.random_frame_interval_ms != 0 && this->next_random_us_ != 0)
+    next = std::min(next, this->next_random_us_);
+  return next;
+}
+
+void AcEmulator::schedule_random_frame_(uint64_t from_us) {
+  std::exponential_distribution<double> gap(1.0 / (this->config_.random_frame_interval_ms * 1000.0));
+  this->next_random_us_ = from_us + std::max<uint64_t>(1, static_cast<uint64_t>(gap(this->rng_)));
+}
+
+}  // namespace tcl_ac
+}  // namespace esphome
@@ -0,0 +1,128 @@
+#pragma once
+
+// Software stand-in for the TCL indoor unit. Speaks the AC side of the
+// protocol: answers POLL (0x04) and SET (0x03) with 55-byte status frames
+// after a configurable latency and emits the unsolicited traffic a real unit
+// sends (status echo, power, temperature, short status) on a fixed cadence,
+// plus temperature and power frames at random times if configured.
+//
+// The unit keeps its state field by field, read from SETs and written into
+// status frames at the frame bytes PROTOCOL.md lists. That table is written
+// out here on its own rather than taken from tcl_ac_schema.h, so the
+// component's decoders are checked against the documented layout, not
+// against its own encoder.
+//
+// The emulator is transport agnostic: bytes from the MCU go in through
+// receive() with their arrival time, frames for the MCU come out through the
+// output callback once they are due. LoopbackUART and the pseudo-terminal
+// runner in main.cpp put it on a (simulated) wire.
+
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "frame_reader.h"
+#include "tcl_ac_codec.h"
+#include "tcl_ac_protocol.h"
+
+namespace esphome {
+namespace tcl_ac {
+
+struct EmulatorConfig {
+  uint32_t response_latency_ms{40};       // SET/POLL → status reply
+  uint32_t unsolicited_interval_ms{1300};  // Cadence of unsolicited frames (0 = off)
+  float room_temperature{24.5f};
+  bool cap_fan{false};  // Run a HIGH fan request at MEDIUM: a SET the unit only partly takes
+  // Mean gap between extra temperature (0x05) and power (0x0A) frames at
+  // random times, e.g. inside a coalescing window (0 = none)
+  uint32_t random_frame_interval_ms{0};
+  uint32_t seed{1};
+};
+
+struct EmulatorStats {
+  uint32_t polls_received{0};
+  uint32_t sets_received{0};
+  uint32_t bad_frames{0};
+  uint32_t frames_sent{0};
+  uint32_t bytes_sent{0};
+  uint32_t random_frames{0};
+};
+
+class AcEmulator {
+ public:
+  // `state_version` is the get_state_version() the frame reflects
+  using OutputCallback = std::function<void(const uint8_t *data, size_t length, uint32_t state_version)>;
+
+  explicit AcEmulator(const EmulatorConfig &config = EmulatorConfig());
+
+  void set_output(OutputCallback &&output) { this->output_ = std::move(output); }
+
+  // Bytes written by the MCU, arriving at `now_us` (end of the last byte)
+  void receive(const uint8_t *data, size_t length, uint64_t now_us);
+  // Emit every frame that is due at `now_us`
+  void update(uint64_t now_us);
+  // Earliest time update() has something to do
+  uint64_t next_event_us() const;
+
+  // Incremented for every SET the unit accepts
+  uint32_t get_state_version() const { return this->state_version_; }
+  bool is_power_on() const { return this->unit_.power; }
+  float get_target_temperature() const;
+  // Settings as the component decodes them, in the layout it is built for
+  AcSettings get_decoded_settings() const;
+  // A change made at the unit itself (IR remote): no SET, only the next
+  // status frame tells the MCU
+  void remote_control(const AcSettings &settings);
+  void set_room_temperature(float celsius) { this->config_.room_temperature = celsius; }
+  // Emit a frame of `command` (status echo, short status, temperature,
+  // power) at once, outside the unsolicited cadence
+  void send_now(uint8_t command) { this->send_(command); }
+
+  const EmulatorStats &get_stats() const { return this->stats_; }
+
+ protected:
+  // Replies are built when due, so they reflect the state at send time
+  struct PendingReply {
+    uint64_t due_us;
+    uint8_t command;
+  };
+
+  // What the unit runs: each field's bits as they sit in their frame byte
+  struct UnitState {
+    bool power{false};
+    uint8_t mode{0};                // Model B only: byte 8 bits 0-3
+    uint8_t fan{0};                 // Bits 0-2 of byte 10 (B) or byte 8 (A)
+    uint8_t target{0};              // Byte 9 as 111 - °C (B) or byte 31 as °C + 12 (A)
+    uint8_t flags7{0};              // Byte 7: eco 0x80, display 0x40, beeper 0x20
+    uint8_t flags8{0};              // Byte 8: quiet 0x80, turbo 0x40, health 0x20, comfort 0x10
+    uint8_t vertical_swing{0};      // Byte 10 bits 3-5
+    uint8_t horizontal_swing{0};    // Byte 11 bit 3
+    uint8_t sleep{0};               // Byte 19 bits 0-1
+    uint8_t vertical_louvre{0};     // Byte 32
+    uint8_t horizontal_louvre{0};   // Byte 33
+  };
+
+  void handle_frame_(const Frame &frame, uint64_t now_us);
+  void apply_set_(const uint8_t *payload, uint8_t length);
+  void read_set_(const uint8_t *payload);
+  void send_(uint8_t command);
+  void build_status_(uint8_t *payload) const;
+  void schedule_random_frame_(uint64_t from_us);
+
+  EmulatorConfig config_;
+  EmulatorStats stats_;
+  OutputCallback output_;
+  FrameReader<RX_BUFFER_SIZE, HEADER_MCU_TO_AC_1, HEADER_MCU_TO_AC_2> reader_;
+
+  UnitState unit_;
+  uint32_t state_version_{0};
+  std::vector<PendingReply> pending_;
+  uint64_t next_unsolicited_us_{0};
+  uint32_t unsolicited_index_{0};
+  std::mt19937 rng_;
+  uint64_t next_random_us_{0};
+};
+
+}  // namespace tcl_ac
+}  // namespace esphome
@@ -0,0 +1,129 @@
+#include "loopback_uart.h"
+
+#include <algorithm>
+
+namespace esphome {
+namespace tcl_ac {
+
+LoopbackUART::LoopbackUART(AcEmulator *emulator) : emulator_(emulator) {
+  this->emulator_->set_output([this](const uint8_t *data, size_t length, uint32_t version) {
+    // Only full status frames tell the MCU what the unit is doing
+    uint8_t cmd = data[3];
+    bool status = cmd == CMD_SET_PARAMS || cmd == CMD_POLL || cmd == CMD_STATUS_ECHO;
+    uint64_t at = std::max(this->cursor_us_, this->rx_line_free_us_);
+    uint32_t corrupted = this->stats_.corrupted_bytes;
+    for (size_t i = 0; i < length; i++) {
+      at += WIRE_BYTE_US;
+      bool last = i + 1 == length;
+      bool intact = corrupted == this->stats_.corrupted_bytes;
+      uint8_t value = this->noisy_(data[i]);
+      this->to_mcu_.push_back({at, value, status && last && intact ? static_cast<int64_t>(version) : -1});
+    }
+    this->rx_line_free_us_ = at;
+    this->stats_.ac_bytes += length;
+  });
+}
+
+uint64_t LoopbackUART::next_event_us() const {
+  uint64_t next = this->emulator_->next_event_us();
+  if (!this->to_ac_.empty())
+    next = std::min(next, this->to_ac_.front().at_us);
+  return next;
+}
+
+void LoopbackUART::step() {
+  uint64_t now = host::now_us();
+  // Process events in time order so replies are stamped with when they were due
+  while (true) {
+    uint64_t next = this->next_event_us();
+    if (next > now)
+      break;
+    this->cursor_us_ = std::max(this->cursor_us_, next);
+    while (!this->to_ac_.empty() && this->to_ac_.front().at_us <= this->cursor_us_) {
+      this->emulator_->receive(&this->to_ac_.front().value, 1, this->to_ac_.front().at_us);
+      this->to_ac_.pop_front();
+    }
+    this->emulator_->update(this->cursor_us_);
+  }
+  this->cursor_us_ = std::max(this->cursor_us_, now);
+}
+
+void LoopbackUART::write_array(const uint8_t *data, size_t len) {
+  uint64_t at = std::max(host::now_us(), this->tx_line_free_us_);
+  uint32_t queued = (at - host::now_us() + WIRE_BYTE_US - 1) / WIRE_BYTE_US + len;
+  this->stats_.tx_fifo_peak = std::max(this->stats_.tx_fifo_peak, queued);
+  for (size_t i = 0; i < len; i++) {
+    at += WIRE_BYTE_US;
+    // What the AC receives, so the frame callback only sees frames it accepts
+    uint8_t value = this->noisy_(data[i]);
+    this->to_ac_.push_back({at, value, -1});
+
+    this->mcu_reader_.push(value);
+    Frame frame;
+    while (this->mcu_reader_.next(&frame)) {
+      if (!frame.checksum_ok())
+        continue;
+      this->stats_.mcu_frames++;
+      if (frame.command == CMD_POLL)
+        this->stats_.mcu_polls++;
+      if (frame.command == CMD_SET_PARAMS)
+        this->stats_.mcu_sets++;
+      if (this->mcu_frame_callback_)
+        this->mcu_frame_callback_(frame);
+    }
+  }
+  this->tx_line_free_us_ = at;
+  this->stats_.mcu_bytes += len;
+}
+
+uint8_t LoopbackUART::noisy_(uint8_t value) {
+  if (this->byte_error_rate_ <= 0 ||
+      std::uniform_real_distribution<double>(0, 1)(this->noise_rng_) >= this->byte_error_rate_)
+    return value;
+  this->stats_.corrupted_bytes++;
+  return value ^ static_cast<uint8_t>(1 << (this->noise_rng_() % 8));
+}
+
+bool LoopbackUART::peek_byte(uint8_t *data) {
+  if (this->available() == 0)
+    return false;
+  *data = this->to_mcu_.front().value;
+  return true;
+}
+
+bool LoopbackUART::read_array(uint8_t *data, size_t len) {
+  if (static_cast<size_t>(this->available()) < len)
+    return false;
+  for (size_t i = 0; i < len; i++) {
+    const WireByte &b = this->to_mcu_.front();
+    data[i] = b.value;
+    if (b.version >= 0)
+      this->delivered_version_ = std::max(this->delivered_version_, static_cast<uint32_t>(b.version));
+    this->to_mcu_.pop_front();
+  }
+  return true;
+}
+
+int LoopbackUART::available() {
+  uint64_t now = host::now_us();
+  int count = 0;
+  for (const auto &b : this->to_mcu_) {
+    if (b.at_us > now)
+      break;
+    count++;
+  }
+  return count;
+}
+
+void LoopbackUART::flush() {
+  uint64_t now = host::now_us();
+  if (this->tx_line_free_us_ <= now)
+    return;
+  uint64_t blocked = this->tx_line_free_us_ - now;
+  this->stats_.flush_blocked_us += blocked;
+  this->stats_.flush_max_us = std::max(this->stats_.flush_max_us, blocked);
+  host::advance_us(blocked);
+}
+
+}  // namespace tcl_ac
+}  // namespace esphome
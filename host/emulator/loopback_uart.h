@@ -0,0 +1,92 @@
+#pragma once
+
+// In-process wire between TclAcClimate (as uart::UARTComponent) and an
+// AcEmulator, timed at 9600 baud 8E1 on the host virtual clock. Bytes only
+// become readable once they have "arrived", and flush() blocks the caller
+// (advances the clock) until the MCU's transmit line is idle, like the
+// Arduino/IDF UART drivers do.
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <random>
+
+#include "ac_emulator.h"
+#include "esphome/components/uart/uart.h"
+
+namespace esphome {
+namespace tcl_ac {
+
+// start + 8 data + parity + stop = 11 bits per byte
+static const uint32_t WIRE_BYTE_US = 11 * 1000000 / 9600;
+
+struct LoopbackStats {
+  uint32_t mcu_frames{0};
+  uint32_t mcu_polls{0};
+  uint32_t mcu_sets{0};
+  uint32_t mcu_bytes{0};
+  uint32_t ac_bytes{0};
+  uint64_t flush_blocked_us{0};
+  uint64_t flush_max_us{0};
+  uint32_t tx_fifo_peak{0};  // Most MCU bytes written but not yet on the wire
+  uint32_t corrupted_bytes{0};
+};
+
+class LoopbackUART : public uart::UARTComponent {
+ public:
+  explicit LoopbackUART(AcEmulator *emulator);
+
+  // Called for every complete frame the MCU puts on the wire
+  void set_mcu_frame_callback(std::function<void(const Frame &)> &&callback) {
+    this->mcu_frame_callback_ = std::move(callback);
+  }
+
+  // Line noise: each byte in either direction has one bit flipped with
+  // this probability
+  void set_noise(double byte_error_rate, uint32_t seed) {
+    this->byte_error_rate_ = byte_error_rate;
+    this->noise_rng_.seed(seed);
+  }
+
+  // Run the emulator and both wire directions up to host::now_us()
+  void step();
+  // When step() next has something to do
+  uint64_t next_event_us() const;
+
+  // Highest emulator state version whose status frame the MCU has fully read
+  uint32_t get_delivered_version() const { return this->delivered_version_; }
+  const LoopbackStats &get_stats() const { return this->stats_; }
+
+  // uart::UARTComponent
+  void write_array(const uint8_t *data, size_t len) override;
+  bool peek_byte(uint8_t *data) override;
+  bool read_array(uint8_t *data, size_t len) override;
+  int available() override;
+  void flush() override;
+
+ protected:
+  struct WireByte {
+    uint64_t at_us;
+    uint8_t value;
+    int64_t version;  // >= 0 on the last byte of an AC status frame
+  };
+
+  AcEmulator *emulator_;
+  std::function<void(const Frame &)> mcu_frame_callback_;
+  FrameReader<RX_BUFFER_SIZE, HEADER_MCU_TO_AC_1, HEADER_MCU_TO_AC_2> mcu_reader_;
+
+  std::deque<WireByte> to_ac_;
+  std::deque<WireByte> to_mcu_;
+  uint64_t tx_line_free_us_{0};
+  uint64_t rx_line_free_us_{0};
+  uint64_t cursor_us_{0};  // Simulation time step() has processed up to
+  uint32_t delivered_version_{0};
+  LoopbackStats stats_;
+  double byte_error_rate_{0};
+  std::mt19937 noise_rng_;
+
+  uint8_t noisy_(uint8_t value);
+};
+
+}  // namespace tcl_ac
+}  // namespace esphome
@@ -0,0 +1,543 @@
+// tcl_ac_emulator: software TCL indoor unit.
+//
+//   tcl_ac_emulator [options]          Drive TclAcClimate against the emulator
+//                                      in-process on virtual time and report
+//                                      command → confirmation latency and
+//                                      poll overhead. Every SET is decoded and
+//                                      checked against the fields the commands
+//                                      before it asked for; the run fails (exit
+//                                      1) if one carries something else.
+//   tcl_ac_emulator --pty [options]    Serve the AC side on a pseudo-terminal
+//                                      in real time (prints the device path).
+//
+// Options:
+//   --latency MS            AC response latency to SET/POLL (default 40)
+//   --unsolicited MS        Unsolicited frame cadence, 0 = off (default 1300)
+//   --random-frames MS      Mean gap between extra temperature (0x05) and power
+//                           (0x0A) frames at random times, 0 = off (default 2000)
+//   --duration S            Simulated run time (default 600)
+//   --loop-interval MS      ESPHome main loop period (default 16)
+//   --idle-check MS         Component idle_check_interval, 0 = loop() on
+//                           every pass (default 100)
+//   --command-interval S    Mean time between commands (default 5)
+//   --burst N               Changes issued back to back per command (default 1)
+//   --coalesce MS           Component coalescing window (default 50)
+//   --apply                 Issue each command's changes through one apply() call
+//   --noise BER             Line noise: probability of a bit error per byte,
+//                           both directions (default 0)
+//   --repeat P              Fraction of commands that re-apply the current
+//                           state, as a scene does (default 0)
+//   --remote S              Mean time between changes made with the IR remote,
+//                           0 = none (default 0); reports how long the
+//                           component takes to follow them
+//   --cap-fan               The unit runs HIGH fan requests at MEDIUM, so those
+//                           SETs are never confirmed and get rolled back
+//   --seed N                Random seed (default 1)
+//   --capture FILE          Write the component's frame capture to FILE at the
+//                           end (binary format of frame_capture.h)
+//   --capture-size N        Frames the capture holds (default 4096)
+//   -v                      Component debug logging to stderr
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <random>
+#include <termios.h>
+#include <unistd.h>
+#include <vector>
+
+#include "ac_emulator.h"
+#include "loopback_uart.h"
+#include "esphome/core/log.h"
+#include "tcl_ac.h"
+#include "tcl_ac_schema.h"
+
+using namespace esphome;
+using namespace esphome::tcl_ac;
+
+namespace {
+
+struct Options {
+  EmulatorConfig emulator{40, 1300, 24.5f, false, 2000};
+  bool pty{false};
+  double duration_s{600};
+  uint32_t loop_interval_ms{16};
+  uint32_t idle_check_ms{100};
+  double command_interval_s{5};
+  int burst{1};
+  uint32_t coalesce_ms{50};
+  bool apply{false};
+  double noise{0};
+  double repeat{0};
+  double remote_interval_s{0};
+  uint32_t seed{1};
+  const char *capture{nullptr};
+  uint32_t capture_size{4096};
+};
+
+struct PendingCommand {
+  uint64_t issued_us;
+  uint32_t set_index;  // 0 until the MCU has written the SET carrying it
+};
+
+// The fields commands asked for since the last SET that carried them
+struct Requested {
+  AcSettings settings;
+  uint16_t fields{0};  // SettingsField mask
+  bool beeper{false};  // Not part of settings_diff()
+};
+
+double percentile(std::vector<double> values, double p) {
+  if (values.empty())
+    return 0;
+  std::sort(values.begin(), values.end());
+  size_t i = static_cast<size_t>(p * (values.size() - 1) + 0.5);
+  return values[i];
+}
+
+// One user-visible change, rotated so consecutive changes differ. With an
+// update it is collected there instead of being sent through the setters.
+// The field and value asked for are recorded in `requested`.
+void issue_change(TclAcClimate &ac, std::mt19937 &rng, int which, AcStateUpdate *update, Requested *requested) {
+  static const climate::ClimateFanMode FANS[] = {climate::CLIMATE_FAN_AUTO, climate::CLIMATE_FAN_LOW,
+                                                 climate::CLIMATE_FAN_MEDIUM, climate::CLIMATE_FAN_HIGH};
+  switch (which % 6) {
+    case 0: {
+      float target = 18 + rng() % 11;
+      requested->settings.mode = ActiveModel::HAS_MODE ? climate::CLIMATE_MODE_COOL : ModelA::ON_MODE;
+      requested->settings.target_temperature = target;
+      requested->fields |= FIELD_MODE | FIELD_TARGET_TEMPERATURE;
+      if (update != nullptr) {
+        update->mode = climate::CLIMATE_MODE_COOL;
+        update->target_temperature = target;
+      } else {
+        ac.make_call().set_mode(climate::CLIMATE_MODE_COOL).set_target_temperature(target).perform();
+      }
+      break;
+    }
+    case 1: {
+      climate::ClimateFanMode fan = FANS[rng() % 4];
+      requested->settings.fan_mode = fan;
+      requested->fields |= FIELD_FAN_MODE;
+      if (update != nullptr) {
+        update->fan_mode = fan;
+      } else {
+        ac.make_call().set_fan_mode(fan).perform();
+      }
+      break;
+    }
+    case 2:
+      if (update != nullptr) {
+        update->display_state = !update->display_state.value_or(ac.get_display_state());
+        requested->settings.display_state = *update->display_state;
+      } else {
+        ac.set_display_state(!ac.get_display_state());
+        requested->settings.display_state = ac.get_display_state();
+      }
+      requested->fields |= FIELD_DISPLAY;
+      break;
+    case 3: {
+      auto direction = static_cast<AirflowVerticalDirection>(1 + rng() % 5);
+      if (update != nullptr) {
+        update->vertical_airflow = direction;
+      } else {
+        ac.set_vertical_airflow(direction);
+      }
+      requested->settings.vertical_airflow = direction;
+      requested->settings.vertical_swing = ac.get_vertical_swing();
+      requested->fields |= FIELD_VERTICAL_LOUVRE;
+      break;
+    }
+    case 4: {
+      auto direction = static_cast<AirflowHorizontalDirection>(1 + rng() % 5);
+      if (update != nullptr) {
+        update->horizontal_airflow = direction;
+      } else {
+        ac.set_horizontal_airflow(direction);
+      }
+      requested->settings.horizontal_airflow = direction;
+      requested->settings.horizontal_swing = ac.get_horizontal_swing();
+      requested->fields |= FIELD_HORIZONTAL_LOUVRE;
+      break;
+    }
+    case 5:
+      if (update != nullptr) {
+        update->beeper_state = !update->beeper_state.value_or(ac.get_beeper_state());
+        requested->settings.beeper_state = *update->beeper_state;
+      } else {
+        ac.set_beeper_state(!ac.get_beeper_state());
+        requested->settings.beeper_state = ac.get_beeper_state();
+      }
+      requested->beeper = true;
+      break;
+  }
+}
+
+// A change made with the IR remote: every climate field the status frame
+// carries, plus display and louvre, moved to a new random value
+AcSettings remote_change(const AcSettings &current, std::mt19937 &rng) {
+  static const climate::ClimateMode MODES[] = {climate::CLIMATE_MODE_COOL, climate::CLIMATE_MODE_HEAT,
+                                               climate::CLIMATE_MODE_DRY, climate::CLIMATE_MODE_FAN_ONLY,
+                                               climate::CLIMATE_MODE_AUTO};
+  static const climate::ClimateFanMode FANS[] = {climate::CLIMATE_FAN_AUTO, climate::CLIMATE_FAN_LOW,
+                                                 climate::CLIMATE_FAN_MEDIUM, climate::CLIMATE_FAN_HIGH};
+  AcSettings settings = current;
+  settings.mode = ActiveModel::HAS_MODE ? MODES[rng() % 5] : ModelA::ON_MODE;
+  settings.target_temperature = 17 + rng() % 14;
+  settings.fan_mode = FANS[rng() % 4];
+  settings.swing_mode = static_cast<climate::ClimateSwingMode>(rng() % 4);
+  settings.display_state = !current.display_state;
+  settings.vertical_airflow = static_cast<AirflowVerticalDirection>(1 + rng() % 5);
+  return settings;
+}
+
+// True if the climate state shows the unit's climate fields, display and vertical louvre
+bool shows_unit_state(const TclAcClimate &ac, const AcSettings &unit) {
+  return ac.mode == unit.mode && ac.target_temperature == unit.target_temperature &&
+         ac.fan_mode == unit.fan_mode && ac.swing_mode == unit.swing_mode &&
+         ac.get_display_state() == unit.display_state && ac.get_vertical_airflow() == unit.vertical_airflow;
+}
+
+int run_loopback(const Options &options) {
+  host::use_virtual_clock(0);
+  std::mt19937 rng(options.seed);
+
+  AcEmulator emulator(options.emulator);
+  LoopbackUART wire(&emulator);
+  wire.set_noise(options.noise, options.seed);
+  TclAcClimate ac;
+  sensor::Sensor rtt_median, rtt_p95, retransmits, failures;
+  ac.set_uart_parent(&wire);
+  ac.set_coalesce_window(options.coalesce_ms);
+  ac.set_idle_check_interval(options.idle_check_ms);
+  if (options.capture != nullptr)
+    ac.set_capture_size(options.capture_size);
+  ac.set_command_rtt_median_sensor(&rtt_median);
+  ac.set_command_rtt_p95_sensor(&rtt_p95);
+  ac.set_command_retransmits_sensor(&retransmits);
+  ac.set_command_failures_sensor(&failures);
+  ac.setup();
+
+  std::vector<PendingCommand> pending;
+  std::vector<double> latencies_ms;
+  uint32_t sets_seen = 0;
+  uint32_t issued = 0;
+  uint32_t repeats = 0;
+  uint32_t sets_suppressed = 0;
+  size_t in_effect = 0;
+  // A command counts as carried by the first SET that has every field asked
+  // for since the last one. A SET with other values fails the run, unless it
+  // repeats the previous frame byte for byte: a retransmit of an earlier SET.
+  Requested requested;
+  std::vector<uint8_t> last_set;
+  uint32_t sets_checked = 0;
+  uint32_t sets_wrong = 0;
+  wire.set_mcu_frame_callback([&](const Frame &frame) {
+    if (frame.command != CMD_SET_PARAMS)
+      return;
+    sets_seen++;
+    bool retransmit = last_set.size() == frame.length && memcmp(last_set.data(), frame.payload, frame.length) == 0;
+    last_set.assign(frame.payload, frame.payload + frame.length);
+    if (requested.fields == 0 && !requested.beeper)
+      return;
+    AcSettings sent;
+    decode_settings(frame.payload, frame.length, &sent);
+    uint16_t diff = settings_diff(requested.settings, sent) & requested.fields;
+    bool beeper = requested.beeper && sent.beeper_state != requested.settings.beeper_state;
+    if (diff != 0 || beeper) {
+      if (retransmit)
+        return;
+      char fields[96];
+      format_settings_diff(diff, fields, sizeof(fields));
+      fprintf(stderr, "%.3f s: SET does not carry the requested %s%s%s\n", host::now_us() / 1e6, fields,
+              diff != 0 && beeper ? ", " : "", beeper ? "beeper" : "");
+      sets_wrong++;
+      pending.erase(std::remove_if(pending.begin(), pending.end(),
+                                   [](const PendingCommand &cmd) { return cmd.set_index == 0; }),
+                    pending.end());
+    } else {
+      sets_checked++;
+      for (auto &cmd : pending) {
+        if (cmd.set_index == 0)
+          cmd.set_index = sets_seen;
+      }
+    }
+    requested = Requested();
+  });
+
+  const uint64_t end_us = static_cast<uint64_t>(options.duration_s * 1e6);
+  const uint64_t loop_us = static_cast<uint64_t>(options.loop_interval_ms) * 1000;
+  std::exponential_distribution<double> gap(1.0 / options.command_interval_s);
+  uint64_t next_command_us = 2000000 + static_cast<uint64_t>(gap(rng) * 1e6);
+  uint64_t next_loop_us = 0;
+  uint64_t loops = 0;
+  uint64_t max_loop_us = 0;
+  int rotation = 0;
+
+  // At most one remote change is followed at a time; a command issued before
+  // the component caught up overrides it
+  std::exponential_distribution<double> remote_gap(options.remote_interval_s > 0 ? 1.0 / options.remote_interval_s
+                                                                                 : 1.0);
+  uint64_t next_remote_us = options.remote_interval_s > 0 ? 3000000 + static_cast<uint64_t>(remote_gap(rng) * 1e6)
+                                                          : UINT64_MAX;
+  bool remote_pending = false;
+  AcSettings remote;
+  uint64_t remote_us = 0;
+  uint32_t remote_publishes = 0;
+  uint32_t remote_made = 0;
+  uint32_t remote_overridden = 0;
+  uint32_t remote_superseded = 0;
+  std::vector<double> remote_ms;
+  
+  // Optimistic state replaced by the unit's after a failed SET: the climate
+  // state must match the unit again, unless a newer command is under way
+  uint32_t rollbacks = 0;
+  uint32_t rollbacks_consistent = 0;
+
+  while (host::now_us() < end_us) {
+    if (host::now_us() < next_loop_us)
+      host::advance_us(next_loop_us - host::now_us());
+    next_loop_us += loop_us;
+    wire.step();
+
+    uint64_t start = host::now_us();
+    if (start >= next_command_us) {
+      pending.push_back({start, 0});  // Before issuing: the SET may be written right away
+      if (std::uniform_real_distribution<double>(0, 1)(rng) < options.repeat) {
+        ac.set_display_state(ac.get_display_state());
+        ac.set_vertical_airflow(ac.get_vertical_airflow());
+        repeats++;
+      } else if (options.apply) {
+        AcStateUpdate update;
+        for (int i = 0; i < options.burst; i++)
+          issue_change(ac, rng, rotation++, &update, &requested);
+        ac.apply(update);
+      } else {
+        for (int i = 0; i < options.burst; i++)
+          issue_change(ac, rng, rotation++, nullptr, &requested);
+      }
+      issued++;
+      next_command_us = start + static_cast<uint64_t>(gap(rng) * 1e6);
+      if (remote_pending) {
+        remote_overridden++;
+        remote_pending = false;
+      }
+    }
+    if (start >= next_remote_us) {
+      if (remote_pending)
+        remote_superseded++;
+      remote = remote_change(emulator.get_decoded_settings(), rng);
+      emulator.remote_control(remote);
+      remote = emulator.get_decoded_settings();
+      remote_pending = true;
+      remote_us = start;
+      remote_publishes = ac.get_publishes();
+      remote_made++;
+      next_remote_us = start + static_cast<uint64_t>(remote_gap(rng) * 1e6);
+    }
+    // As Application::loop(): due timeouts, then the component unless it
+    // has disabled its loop()
+    host::run_scheduler();
+    if (host::call_loop(&ac))
+      loops++;
+    max_loop_us = std::max(max_loop_us, host::now_us() - start);
+
+    uint32_t delivered = wire.get_delivered_version();
+    uint64_t now = host::now_us();
+    // A command that left the state as the AC confirmed it sends nothing
+    if (ac.get_sets_suppressed() != sets_suppressed) {
+      sets_suppressed = ac.get_sets_suppressed();
+      requested = Requested();
+      size_t before = pending.size();
+      pending.erase(std::remove_if(pending.begin(), pending.end(),
+                                   [](const PendingCommand &cmd) { return cmd.set_index == 0; }),
+                    pending.end());
+      in_effect += before - pending.size();
+    }
+    pending.erase(std::remove_if(pending.begin(), pending.end(),
+                                 [&](const PendingCommand &cmd) {
+                                   if (cmd.set_index == 0 || delivered < cmd.set_index)
+                                     return false;
+                                   latencies_ms.push_back((now - cmd.issued_us) / 1000.0);
+                                   return true;
+                                 }),
+                  pending.end());
+    if (ac.get_rollbacks() != rollbacks) {
+      rollbacks = ac.get_rollbacks();
+      if (shows_unit_state(ac, emulator.get_decoded_settings()))
+        rollbacks_consistent++;
+    }
+    // Followed once the component holds the remote's state and has published it
+    if (remote_pending && ac.get_publishes() != remote_publishes && shows_unit_state(ac, remote)) {
+      remote_ms.push_back((now - remote_us) / 1000.0);
+      remote_pending = false;
+    }
+  }
+
+  const LoopbackStats &ws = wire.get_stats();
+  const EmulatorStats &es = emulator.get_stats();
+  double seconds = host::now_us() / 1e6;
+  printf("emulator: latency %u ms, unsolicited every %u ms; loop every %u ms; %.0f s simulated\n",
+         options.emulator.response_latency_ms, options.emulator.unsolicited_interval_ms, options.loop_interval_ms,
+         seconds);
+  printf("commands:        %u issued (%d change(s) each%s, %u repeating the state), %zu confirmed, %zu already "
+         "in effect\n", issued, options.burst, options.apply ? ", apply()" : "", repeats, latencies_ms.size(),
+         in_effect);
+  printf("confirm latency: min %.1f  p50 %.1f  p95 %.1f  max %.1f ms\n", percentile(latencies_ms, 0),
+         percentile(latencies_ms, 0.5), percentile(latencies_ms, 0.95), percentile(latencies_ms, 1));
+  printf("MCU -> AC:       %u frames (%u POLL, %u SET), %u bytes, line busy %.2f %%\n", ws.mcu_frames, ws.mcu_polls,
+         ws.mcu_sets, ws.mcu_bytes, 100.0 * ws.mcu_bytes * WIRE_BYTE_US / (seconds * 1e6));
+  printf("poll overhead:   %.1f polls/min, %.1f B/s (%u sent, %u suppressed)\n", ws.mcu_polls * 60.0 / seconds,
+         ws.mcu_polls * POLL_PACKET_SIZE / seconds, ac.get_polls_sent(), ac.get_polls_suppressed());
+  printf("AC -> MCU:       %u frames (%u 0x05/0x0A at random times), %u bytes, %u bad frames from MCU\n",
+         es.frames_sent, es.random_frames, ws.ac_bytes, es.bad_frames);
+  printf("SET contents:    %u checked against the requested fields, %u wrong\n", sets_checked, sets_wrong);
+  if (options.noise > 0)
+    printf("line noise:      %.1e per byte, %u bytes corrupted\n", options.noise, ws.corrupted_bytes);
+  const CommandTracker &tracker = ac.get_command_tracker();
+  printf("SET tracking:    %u confirmed, %u retransmitted, %u failed\n", tracker.get_confirmed(),
+         tracker.get_retransmits(), tracker.get_failures());
+  printf("SET RTT:         ");
+  for (size_t i = 0; i < RttHistogram::BUCKETS; i++) {
+    if (i + 1 < RttHistogram::BUCKETS) {
+      printf("<=%u:%u ", RttHistogram::BUCKET_MS[i], tracker.get_rtt().get_count(i));
+    } else {
+      printf(">%u:%u\n", RttHistogram::BUCKET_MS[i - 1], tracker.get_rtt().get_count(i));
+    }
+  }
+  printf("rollbacks:       %u, %u leaving the state equal to the unit's\n", rollbacks, rollbacks_consistent);
+  printf("sensors:         rtt median %.0f ms, p95 %.0f ms, retransmits %.0f, failures %.0f\n", rtt_median.state,
+         rtt_p95.state, retransmits.state, failures.state);
+  printf("main loop:       %llu loop() calls (%.1f/s, parked %u times, %u timeouts set), max %.1f ms, blocked in "
+         "flush() %.1f ms total (max %.1f ms)\n", static_cast<unsigned long long>(loops), loops / seconds,
+         ac.get_loop_parks(), host::timeouts_set(), max_loop_us / 1000.0, ws.flush_blocked_us / 1000.0,
+         ws.flush_max_us / 1000.0);
+  printf("UART TX FIFO:    peak %u bytes\n", ws.tx_fifo_peak);
+  printf("coalescing:      %u ms window, %u SET bursts, %u writes saved, %u unchanged SETs not sent\n",
+         options.coalesce_ms, ac.get_coalesce_bursts(), ac.get_coalesce_saved(), ac.get_sets_suppressed());
+  printf("publish_state:   %u calls (%u AC reports without change suppressed)\n", ac.get_publish_count(),
+         ac.get_publishes_suppressed());
+  if (options.remote_interval_s > 0) {
+    printf("remote changes:  %u made, %zu followed, %u overridden by a command, %u by the next change\n",
+           remote_made, remote_ms.size(), remote_overridden, remote_superseded);
+    printf("follow latency:  p50 %.1f  p95 %.1f  max %.1f ms\n", percentile(remote_ms, 0.5),
+           percentile(remote_ms, 0.95), percentile(remote_ms, 1));
+  }
+  if (options.capture != nullptr) {
+    FILE *file = fopen(options.capture, "wb");
+    if (file == nullptr) {
+      fprintf(stderr, "%s: %s\n", options.capture, strerror(errno));
+      return 1;
+    }
+    ac.get_capture().export_to([file](const uint8_t *data, size_t length) { fwrite(data, 1, length, file); });
+    fclose(file);
+    printf("capture:         %zu frames (%u overwritten) written to %s\n", ac.get_capture().size(),
+           ac.get_capture().get_overwritten(), options.capture);
+  }
+  if (sets_wrong > 0) {
+    fprintf(stderr, "%u SET(s) did not carry the requested change\n", sets_wrong);
+    return 1;
+  }
+  return 0;
+}
+
+volatile sig_atomic_t running = 1;
+
+int run_pty(const Options &options) {
+  int master = posix_openpt(O_RDWR | O_NOCTTY);
+  if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+    perror("posix_openpt");
+    return 1;
+  }
+  struct termios tio;
+  tcgetattr(master, &tio);
+  cfmakeraw(&tio);
+  tcsetattr(master, TCSANOW, &tio);
+  printf("%s\n", ptsname(master));
+  fflush(stdout);
+
+  signal(SIGINT, [](int) { running = 0; });
+  signal(SIGTERM, [](int) { running = 0; });
+
+  AcEmulator emulator(options.emulator);
+  emulator.set_output([master](const uint8_t *data, size_t length, uint32_t) {
+    if (write(master, data, length) < 0 && errno != EIO)
+      perror("write");
+  });
+
+  uint8_t buf[256];
+  while (running) {
+    struct pollfd pfd = {master, POLLIN, 0};
+    int r = poll(&pfd, 1, 5);
+    if (r > 0 && (pfd.revents & POLLIN)) {
+      ssize_t n = read(master, buf, sizeof(buf));
+      if (n > 0)
+        emulator.receive(buf, n, host::now_us());
+    }
+    emulator.update(host::now_us());
+  }
+
+  const EmulatorStats &es = emulator.get_stats();
+  fprintf(stderr, "polls %u, sets %u, bad %u, frames sent %u\n", es.polls_received, es.sets_received, es.bad_frames,
+          es.frames_sent);
+  close(master);
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    auto arg = [&](const char *name) { return strcmp(argv[i], name) == 0 && i + 1 < argc; };
+    if (strcmp(argv[i], "--pty") == 0) {
+      options.pty = true;
+    } else if (strcmp(argv[i], "--apply") == 0) {
+      options.apply = true;
+    } else if (strcmp(argv[i], "-v") == 0) {
+      host::log_level = ESPHOME_LOG_LEVEL_DEBUG;
+    } else if (arg("--latency")) {
+      options.emulator.response_latency_ms = atoi(argv[++i]);
+    } else if (arg("--unsolicited")) {
+      options.emulator.unsolicited_interval_ms = atoi(argv[++i]);
+    } else if (arg("--random-frames")) {
+      options.emulator.random_frame_interval_ms = atoi(argv[++i]);
+    } else if (arg("--duration")) {
+      options.duration_s = atof(argv[++i]);
+    } else if (arg("--loop-interval")) {
+      options.loop_interval_ms = atoi(argv[++i]);
+    } else if (arg("--idle-check")) {
+      options.idle_check_ms = atoi(argv[++i]);
+    } else if (arg("--command-interval")) {
+      options.command_interval_s = atof(argv[++i]);
+    } else if (arg("--burst")) {
+      options.burst = std::max(1, atoi(argv[++i]));
+    } else if (arg("--coalesce")) {
+      options.coalesce_ms = atoi(argv[++i]);
+    } else if (arg("--noise")) {
+      options.noise = atof(argv[++i]);
+    } else if (arg("--repeat")) {
+      options.repeat = atof(argv[++i]);
+    } else if (arg("--remote")) {
+      options.remote_interval_s = atof(argv[++i]);
+    } else if (strcmp(argv[i], "--cap-fan") == 0) {
+      options.emulator.cap_fan = true;
+    } else if (arg("--seed")) {
+      options.seed = atoi(argv[++i]);
+      options.emulator.seed = options.seed;
+    } else if (arg("--capture")) {
+      options.capture = argv[++i];
+    } else if (arg("--capture-size")) {
+      options.capture_size = atoi(argv[++i]);
+    } else {
+      fprintf(stderr, "unknown option: %s\n", argv[i]);
+      return 2;
+    }
+  }
+  return options.pty ? run_pty(options) : run_loopback(options);
+}
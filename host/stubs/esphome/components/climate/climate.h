@@ -0,0 +1,180 @@
+#pragma once
+
+// Host stand-in for esphome/components/climate/climate.h. Keeps the public
+// state fields, ClimateCall and ClimateTraits that tcl_ac uses; publish_state()
+// counts publishes and runs the registered state callbacks.
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <set>
+#include <vector>
+
+#include "esphome/core/optional.h"
+
+namespace esphome {
+namespace climate {
+
+enum ClimateMode : uint8_t {
+  CLIMATE_MODE_OFF = 0,
+  CLIMATE_MODE_HEAT_COOL = 1,
+  CLIMATE_MODE_COOL = 2,
+  CLIMATE_MODE_HEAT = 3,
+  CLIMATE_MODE_FAN_ONLY = 4,
+  CLIMATE_MODE_DRY = 5,
+  CLIMATE_MODE_AUTO = 6,
+};
+
+enum ClimateAction : uint8_t {
+  CLIMATE_ACTION_OFF = 0,
+  CLIMATE_ACTION_COOLING = 2,
+  CLIMATE_ACTION_HEATING = 3,
+  CLIMATE_ACTION_IDLE = 4,
+  CLIMATE_ACTION_DRYING = 5,
+  CLIMATE_ACTION_FAN = 6,
+};
+
+enum ClimateFanMode : uint8_t {
+  CLIMATE_FAN_ON = 0,
+  CLIMATE_FAN_OFF = 1,
+  CLIMATE_FAN_AUTO = 2,
+  CLIMATE_FAN_LOW = 3,
+  CLIMATE_FAN_MEDIUM = 4,
+  CLIMATE_FAN_HIGH = 5,
+  CLIMATE_FAN_MIDDLE = 6,
+  CLIMATE_FAN_FOCUS = 7,
+  CLIMATE_FAN_DIFFUSE = 8,
+  CLIMATE_FAN_QUIET = 9,
+};
+
+enum ClimateSwingMode : uint8_t {
+  CLIMATE_SWING_OFF = 0,
+  CLIMATE_SWING_BOTH = 1,
+  CLIMATE_SWING_VERTICAL = 2,
+  CLIMATE_SWING_HORIZONTAL = 3,
+};
+
+enum ClimatePreset : uint8_t {
+  CLIMATE_PRESET_NONE = 0,
+  CLIMATE_PRESET_HOME = 1,
+  CLIMATE_PRESET_AWAY = 2,
+  CLIMATE_PRESET_BOOST = 3,
+  CLIMATE_PRESET_COMFORT = 4,
+  CLIMATE_PRESET_ECO = 5,
+  CLIMATE_PRESET_SLEEP = 6,
+  CLIMATE_PRESET_ACTIVITY = 7,
+};
+
+class ClimateTraits {
+ public:
+  void set_supported_modes(std::set<ClimateMode> modes) { this->supported_modes_ = std::move(modes); }
+  void set_supported_fan_modes(std::set<ClimateFanMode> modes) { this->supported_fan_modes_ = std::move(modes); }
+  void set_supported_presets(std::set<ClimatePreset> presets) { this->supported_presets_ = std::move(presets); }
+  void set_supported_swing_modes(std::set<ClimateSwingMode> modes) { this->supported_swing_modes_ = std::move(modes); }
+  void set_visual_min_temperature(float t) { this->visual_min_temperature_ = t; }
+  void set_visual_max_temperature(float t) { this->visual_max_temperature_ = t; }
+  void set_visual_temperature_step(float s) { this->visual_temperature_step_ = s; }
+  void set_supports_current_temperature(bool s) { this->supports_current_temperature_ = s; }
+
+  const std::set<ClimateMode> &get_supported_modes() const { return this->supported_modes_; }
+  const std::set<ClimateFanMode> &get_supported_fan_modes() const { return this->supported_fan_modes_; }
+  const std::set<ClimatePreset> &get_supported_presets() const { return this->supported_presets_; }
+  const std::set<ClimateSwingMode> &get_supported_swing_modes() const { return this->supported_swing_modes_; }
+
+ protected:
+  std::set<ClimateMode> supported_modes_;
+  std::set<ClimateFanMode> supported_fan_modes_;
+  std::set<ClimatePreset> supported_presets_;
+  std::set<ClimateSwingMode> supported_swing_modes_;
+  float visual_min_temperature_{10.0f};
+  float visual_max_temperature_{30.0f};
+  float visual_temperature_step_{0.1f};
+  bool supports_current_temperature_{false};
+};
+
+class Climate;
+
+class ClimateCall {
+ public:
+  explicit ClimateCall(Climate *parent) : parent_(parent) {}
+
+  ClimateCall &set_mode(ClimateMode mode) {
+    this->mode_ = mode;
+    return *this;
+  }
+  ClimateCall &set_target_temperature(float target_temperature) {
+    this->target_temperature_ = target_temperature;
+    return *this;
+  }
+  ClimateCall &set_fan_mode(ClimateFanMode fan_mode) {
+    this->fan_mode_ = fan_mode;
+    return *this;
+  }
+  ClimateCall &set_preset(ClimatePreset preset) {
+    this->preset_ = preset;
+    return *this;
+  }
+  ClimateCall &set_swing_mode(ClimateSwingMode swing_mode) {
+    this->swing_mode_ = swing_mode;
+    return *this;
+  }
+  void perform();
+
+  const optional<ClimateMode> &get_mode() const { return this->mode_; }
+  const optional<float> &get_target_temperature() const { return this->target_temperature_; }
+  const optional<ClimateFanMode> &get_fan_mode() const { return this->fan_mode_; }
+  const optional<ClimatePreset> &get_preset() const { return this->preset_; }
+  const optional<ClimateSwingMode> &get_swing_mode() const { return this->swing_mode_; }
+
+ protected:
+  Climate *parent_;
+  optional<ClimateMode> mode_;
+  optional<float> target_temperature_;
+  optional<ClimateFanMode> fan_mode_;
+  optional<ClimatePreset> preset_;
+  optional<ClimateSwingMode> swing_mode_;
+};
+
+class Climate {
+ public:
+  virtual ~Climate() = default;
+
+  ClimateMode mode{CLIMATE_MODE_OFF};
+  ClimateAction action{CLIMATE_ACTION_OFF};
+  float current_temperature{NAN};
+  float target_temperature{NAN};
+  optional<ClimateFanMode> fan_mode;
+  optional<ClimatePreset> preset;
+  ClimateSwingMode swing_mode{CLIMATE_SWING_OFF};
+
+  ClimateCall make_call() { return ClimateCall(this); }
+
+  void add_on_state_callback(std::function<void(Climate &)> &&callback) {
+    this->state_callbacks_.push_back(std::move(callback));
+  }
+  void publish_state() {
+    this->publish_count_++;
+    for (auto &callback : this->state_callbacks_)
+      callback(*this);
+  }
+  uint32_t get_publish_count() const { return this->publish_count_; }
+
+  virtual ClimateTraits traits() = 0;
+
+ protected:
+  friend ClimateCall;
+  virtual void control(const ClimateCall &call) = 0;
+
+  std::vector<std::function<void(Climate &)>> state_callbacks_;
+  uint32_t publish_count_{0};
+};
+
+// Like ESPHome's ClimateCall::validate_(), a mode the traits do not list is dropped
+inline void ClimateCall::perform() {
+  if (this->mode_.has_value() && this->parent_->traits().get_supported_modes().count(*this->mode_) == 0)
+    this->mode_.reset();
+  this->parent_->control(*this);
+}
+
+}  // namespace climate
+}  // namespace esphome
@@ -0,0 +1,27 @@
+#pragma once
+
+// Host stand-in for esphome/components/sensor/sensor.h: keeps the last
+// published value and counts publishes.
+
+#include <cmath>
+#include <cstdint>
+
+namespace esphome {
+namespace sensor {
+
+class Sensor {
+ public:
+  void publish_state(float state) {
+    this->state = state;
+    this->publish_count_++;
+  }
+  uint32_t get_publish_count() const { return this->publish_count_; }
+
+  float state{NAN};
+
+ protected:
+  uint32_t publish_count_{0};
+};
+
+}  // namespace sensor
+}  // namespace esphome
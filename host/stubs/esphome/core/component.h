@@ -0,0 +1,76 @@
+#pragma once
+
+// Host stand-in for esphome/core/component.h: lifecycle hooks, loop
+// enable/disable and named timeouts. Host tools drive a component the way
+// Application::loop() does: host::run_scheduler(), then host::call_loop().
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "esphome/core/hal.h"
+#include "esphome/core/optional.h"
+
+namespace esphome {
+
+namespace setup_priority {
+static const float DATA = 600.0f;
+static const float HARDWARE = 800.0f;
+static const float LATE = -100.0f;
+}  // namespace setup_priority
+
+class Component {
+ public:
+  virtual ~Component();
+  virtual void setup() {}
+  virtual void loop() {}
+  virtual void dump_config() {}
+  virtual float get_setup_priority() const { return setup_priority::DATA; }
+
+  // loop() is skipped while disabled
+  void disable_loop() { this->loop_enabled_ = false; }
+  void enable_loop() { this->loop_enabled_ = true; }
+  // From another task (or an ISR): enabled on the next main loop pass
+  void enable_loop_soon_any_context() { this->enable_requested_.store(true, std::memory_order_release); }
+  bool is_loop_enabled() const { return this->loop_enabled_; }
+
+ protected:
+  friend bool host_call_loop(Component *component);
+
+  // Replaces a pending timeout of the same name
+  void set_timeout(const std::string &name, uint32_t timeout_ms, std::function<void()> &&f);
+  bool cancel_timeout(const std::string &name);
+  // Numeric ids are kept apart from names, as in ESPHome's scheduler
+  void set_timeout(uint32_t id, uint32_t timeout_ms, std::function<void()> &&f);
+  bool cancel_timeout(uint32_t id);
+
+  bool loop_enabled_{true};
+  std::atomic<bool> enable_requested_{false};
+};
+
+namespace host {
+
+// Runs the timeouts that are due, in deadline order
+void run_scheduler();
+// When the next timeout is due (UINT64_MAX if none)
+uint64_t next_timeout_us();
+// Timeouts set since start, by any component
+uint32_t timeouts_set();
+// loop() if enabled; false if skipped
+inline bool call_loop(Component *component);
+
+}  // namespace host
+
+inline bool host_call_loop(Component *component) {
+  if (component->enable_requested_.exchange(false, std::memory_order_acquire))
+    component->loop_enabled_ = true;
+  if (!component->loop_enabled_)
+    return false;
+  component->loop();
+  return true;
+}
+
+inline bool host::call_loop(Component *component) { return host_call_loop(component); }
+
+}  // namespace esphome
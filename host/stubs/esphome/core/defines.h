@@ -0,0 +1,6 @@
+#pragma once
+
+// Host stand-in for the generated esphome/core/defines.h: the host build
+// compiles every optional platform the component supports.
+
+#define USE_SENSOR
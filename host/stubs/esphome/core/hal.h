@@ -0,0 +1,25 @@
+#pragma once
+
+// Host stand-in for esphome/core/hal.h. Time comes from a process-wide clock
+// that runs in real time by default and can be switched to virtual time so
+// emulator runs and replays are deterministic.
+
+#include <cstdint>
+
+namespace esphome {
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+
+namespace host {
+
+void use_virtual_clock(uint64_t start_us = 0);
+void use_real_clock();
+bool is_virtual_clock();
+uint64_t now_us();
+void advance_us(uint64_t us);
+inline void advance_ms(uint32_t ms) { advance_us(static_cast<uint64_t>(ms) * 1000); }
+
+}  // namespace host
+}  // namespace esphome
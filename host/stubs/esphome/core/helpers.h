@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "esphome/core/hal.h"
+#include "esphome/core/optional.h"
+
+namespace esphome {
+
+// As ESPHome formats bytes for logs: "BB.01.00 (3)"
+inline std::string format_hex_pretty(const uint8_t *data, size_t length) {
+  static const char *const DIGITS = "0123456789ABCDEF";
+  if (length == 0)
+    return "";
+  std::string out;
+  for (size_t i = 0; i < length; i++) {
+    if (i > 0)
+      out += '.';
+    out += DIGITS[data[i] >> 4];
+    out += DIGITS[data[i] & 0x0F];
+  }
+  return out + " (" + std::to_string(length) + ")";
+}
+
+}  // namespace esphome
@@ -0,0 +1,130 @@
+// Host implementations behind the esphome/core stubs: clock, logging and
+// the scheduler behind Component::set_timeout().
+
+#include "esphome/core/component.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace esphome {
+namespace host {
+
+int log_level = ESPHOME_LOG_LEVEL_WARN;
+
+static bool virtual_clock = false;
+static uint64_t virtual_now_us = 0;
+static const auto REAL_START = std::chrono::steady_clock::now();
+
+void use_virtual_clock(uint64_t start_us) {
+  virtual_clock = true;
+  virtual_now_us = start_us;
+}
+
+void use_real_clock() { virtual_clock = false; }
+
+bool is_virtual_clock() { return virtual_clock; }
+
+uint64_t now_us() {
+  if (virtual_clock)
+    return virtual_now_us;
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - REAL_START).count();
+}
+
+void advance_us(uint64_t us) {
+  if (virtual_clock) {
+    virtual_now_us += us;
+  } else {
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+  }
+}
+
+void log_printf(int level, const char *tag, int line, const char *format, ...) {
+  static const char LEVELS[] = "?EWICDVV";
+  fprintf(stderr, "[%10.3f][%c][%s:%d]: ", now_us() / 1000.0, LEVELS[level & 7], tag, line);
+  va_list args;
+  va_start(args, format);
+  vfprintf(stderr, format, args);
+  va_end(args);
+  fputc('\n', stderr);
+}
+
+struct Timeout {
+  uint64_t due_us;
+  Component *component;
+  bool named;
+  std::string name;
+  uint32_t id;
+  std::function<void()> f;
+};
+static std::vector<Timeout> timeouts;
+static uint32_t set_count = 0;
+
+static bool cancel(Component *component, bool named, const std::string &name, uint32_t id) {
+  auto it = std::remove_if(timeouts.begin(), timeouts.end(), [&](const Timeout &t) {
+    return t.component == component && t.named == named && (named ? t.name == name : t.id == id);
+  });
+  bool found = it != timeouts.end();
+  timeouts.erase(it, timeouts.end());
+  return found;
+}
+
+static void add(Component *component, bool named, const std::string &name, uint32_t id, uint32_t timeout_ms,
+                std::function<void()> &&f) {
+  cancel(component, named, name, id);
+  timeouts.push_back({now_us() + static_cast<uint64_t>(timeout_ms) * 1000, component, named, name, id, std::move(f)});
+  set_count++;
+}
+
+void run_scheduler() {
+  uint64_t now = now_us();
+  while (true) {
+    auto due = std::min_element(timeouts.begin(), timeouts.end(),
+                                [](const Timeout &a, const Timeout &b) { return a.due_us < b.due_us; });
+    if (due == timeouts.end() || due->due_us > now)
+      return;
+    std::function<void()> f = std::move(due->f);
+    timeouts.erase(due);
+    f();
+  }
+}
+
+uint64_t next_timeout_us() {
+  uint64_t next = UINT64_MAX;
+  for (const Timeout &t : timeouts)
+    next = std::min(next, t.due_us);
+  return next;
+}
+
+uint32_t timeouts_set() { return set_count; }
+
+}  // namespace host
+
+Component::~Component() {
+  host::timeouts.erase(std::remove_if(host::timeouts.begin(), host::timeouts.end(),
+                                      [this](const host::Timeout &t) { return t.component == this; }),
+                       host::timeouts.end());
+}
+
+void Component::set_timeout(const std::string &name, uint32_t timeout_ms, std::function<void()> &&f) {
+  host::add(this, true, name, 0, timeout_ms, std::move(f));
+}
+
+bool Component::cancel_timeout(const std::string &name) { return host::cancel(this, true, name, 0); }
+
+void Component::set_timeout(uint32_t id, uint32_t timeout_ms, std::function<void()> &&f) {
+  host::add(this, false, "", id, timeout_ms, std::move(f));
+}
+
+bool Component::cancel_timeout(uint32_t id) { return host::cancel(this, false, "", id); }
+
+uint32_t millis() { return static_cast<uint32_t>(host::now_us() / 1000); }
+uint32_t micros() { return static_cast<uint32_t>(host::now_us()); }
+void delay(uint32_t ms) { host::advance_ms(ms); }
+
+}  // namespace esphome
@@ -0,0 +1,344 @@
+#include "capture_reader.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include "frame_capture.h"
+#include "tcl_ac_protocol.h"
+
+namespace esphome {
+namespace tcl_ac {
+
+static const uint64_t DAY_US = 24ULL * 3600 * 1000000;
+static const size_t RAW_CHUNK_SIZE = 4096;
+
+const char *capture_format_name(CaptureFormat format) {
+  switch (format) {
+    case CaptureFormat::BINARY:
+      return "binary";
+    case CaptureFormat::TEXT:
+      return "text";
+    case CaptureFormat::RAW:
+      return "raw";
+    default:
+      return "auto";
+  }
+}
+
+bool parse_capture_format(const char *name, CaptureFormat *format) {
+  for (CaptureFormat f : {CaptureFormat::AUTO, CaptureFormat::BINARY, CaptureFormat::TEXT, CaptureFormat::RAW}) {
+    if (strcmp(name, capture_format_name(f)) == 0) {
+      *format = f;
+      return true;
+    }
+  }
+  return false;
+}
+
+CaptureReader::~CaptureReader() {
+  this->close();
+  free(this->line_);
+}
+
+void CaptureReader::close() {
+  if (this->owns_file_ && this->file_ != nullptr)
+    fclose(this->file_);
+  this->file_ = nullptr;
+  this->owns_file_ = false;
+}
+
+bool CaptureReader::open(const char *path, CaptureFormat format) {
+  this->close();
+  // Start over, keeping the line buffer
+  char *line = this->line_;
+  size_t capacity = this->line_capacity_;
+  this->line_ = nullptr;
+  *this = CaptureReader();
+  this->line_ = line;
+  this->line_capacity_ = capacity;
+  if (strcmp(path, "-") == 0) {
+    this->file_ = stdin;
+  } else {
+    this->file_ = fopen(path, "rb");
+    if (this->file_ == nullptr) {
+      this->error_ = std::string(path) + ": " + strerror(errno);
+      return false;
+    }
+    this->owns_file_ = true;
+  }
+
+  // The capture header, if there is one
+  CaptureHeader header;
+  size_t n = fread(&header, 1, sizeof(header), this->file_);
+  bool binary = n == sizeof(header) && memcmp(header.magic, "TCLC", 4) == 0;
+  if (format == CaptureFormat::AUTO)
+    format = binary ? CaptureFormat::BINARY : CaptureFormat::TEXT;
+  this->format_ = format;
+  if (format == CaptureFormat::BINARY) {
+    if (!binary) {
+      this->error_ = std::string(path) + ": not a frame capture";
+      return false;
+    }
+    if (header.version != CAPTURE_VERSION || header.record_size < 6) {
+      this->error_ = std::string(path) + ": unsupported capture version " + std::to_string(header.version);
+      return false;
+    }
+    this->record_size_ = header.record_size;
+    this->record_.resize(header.record_size);
+    this->overwritten_ = header.overwritten;
+    return true;
+  }
+  // Text and raw start over
+  if (this->file_ == stdin) {
+    if (n > 0 && binary) {
+      this->error_ = "binary captures cannot be read from stdin";
+      return false;
+    }
+    for (size_t i = n; i > 0; i--)
+      ungetc(reinterpret_cast<uint8_t *>(&header)[i - 1], stdin);
+  } else {
+    rewind(this->file_);
+  }
+  return true;
+}
+
+bool CaptureReader::next(CaptureChunk *chunk) {
+  if (this->file_ == nullptr)
+    return false;
+  chunk->data.clear();
+  chunk->has_time = false;
+  chunk->time_us = 0;
+  chunk->checksum_ok = -1;
+  chunk->truncated = false;
+  switch (this->format_) {
+    case CaptureFormat::BINARY:
+      return this->next_binary_(chunk);
+    case CaptureFormat::RAW:
+      return this->next_raw_(chunk);
+    default:
+      return this->next_text_(chunk);
+  }
+}
+
+uint64_t CaptureReader::unwrap_(uint32_t time_us) {
+  if (!this->has_raw_time_) {
+    this->has_raw_time_ = true;
+    this->raw_time_us_ = time_us;
+  } else {
+    int64_t step = static_cast<int32_t>(time_us - this->last_raw_us_);
+    this->raw_time_us_ = step < 0 && static_cast<uint64_t>(-step) > this->raw_time_us_ ? 0 : this->raw_time_us_ + step;
+  }
+  this->last_raw_us_ = time_us;
+  return this->raw_time_us_;
+}
+
+void CaptureReader::set_time_(CaptureChunk *chunk, uint64_t time_us) {
+  if (!this->has_base_) {
+    this->has_base_ = true;
+    this->base_us_ = time_us;
+  }
+  chunk->has_time = true;
+  chunk->time_us = time_us > this->base_us_ ? time_us - this->base_us_ : 0;
+}
+
+bool CaptureReader::next_binary_(CaptureChunk *chunk) {
+  if (fread(this->record_.data(), 1, this->record_size_, this->file_) != this->record_size_)
+    return false;
+  const uint8_t *r = this->record_.data();
+  uint32_t time_us = r[0] | (r[1] << 8) | (r[2] << 16) | (static_cast<uint32_t>(r[3]) << 24);
+  uint8_t flags = r[4];
+  size_t size = std::min<size_t>(r[5], this->record_size_ - 6);
+  chunk->tx = (flags & CAPTURE_TX) != 0;
+  chunk->checksum_ok = (flags & CAPTURE_CHECKSUM_OK) ? 1 : 0;
+  chunk->truncated = (flags & CAPTURE_TRUNCATED) != 0;
+  chunk->data.assign(r + 6, r + 6 + size);
+  this->set_time_(chunk, this->unwrap_(time_us));
+  this->bytes_ += size;
+  return true;
+}
+
+bool CaptureReader::next_raw_(CaptureChunk *chunk) {
+  chunk->tx = false;
+  chunk->data.resize(RAW_CHUNK_SIZE);
+  size_t n = fread(chunk->data.data(), 1, RAW_CHUNK_SIZE, this->file_);
+  chunk->data.resize(n);
+  this->bytes_ += n;
+  return n > 0;
+}
+
+bool CaptureReader::next_text_(CaptureChunk *chunk) {
+  ssize_t n;
+  while ((n = getline(&this->line_, &this->line_capacity_, this->file_)) >= 0) {
+    this->lines_++;
+    if (this->parse_line_(this->line_, chunk)) {
+      this->bytes_ += chunk->data.size();
+      return true;
+    }
+    this->skipped_lines_++;
+  }
+  return false;
+}
+
+static int hex_digit(char c) {
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+  return c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1;
+}
+
+// Appends the bytes in `text` to `out`; false if anything but hex bytes and
+// a "(length)" suffix is in it
+static bool parse_hex(char *text, std::vector<uint8_t> *out) {
+  static const char *const SEPARATORS = " \t:.,;";
+  for (char *token = strtok(text, SEPARATORS); token != nullptr; token = strtok(nullptr, SEPARATORS)) {
+    if (token[0] == '(')
+      continue;
+    if (token[0] == '0' && (token[1] == 'x' || token[1] == 'X'))
+      token += 2;
+    size_t length = strlen(token);
+    if (length == 0 || length % 2 != 0)
+      return false;
+    for (size_t i = 0; i < length; i += 2) {
+      int high = hex_digit(token[i]);
+      int low = hex_digit(token[i + 1]);
+      if (high < 0 || low < 0)
+        return false;
+      out->push_back(static_cast<uint8_t>(high << 4 | low));
+    }
+  }
+  return !out->empty();
+}
+
+// "HH:MM:SS" or "HH:MM:SS.mmm" as microseconds since midnight
+static bool parse_clock(const char *text, size_t length, uint64_t *time_us) {
+  unsigned h, m, s, ms = 0;
+  int used = 0;
+  if (sscanf(text, "%2u:%2u:%2u%n", &h, &m, &s, &used) != 3)
+    return false;
+  if (static_cast<size_t>(used) < length) {
+    int more = 0;
+    if (text[used] != '.' || sscanf(text + used, ".%3u%n", &ms, &more) != 1 ||
+        static_cast<size_t>(used + more) != length)
+      return false;
+  } else if (static_cast<size_t>(used) != length) {
+    return false;
+  }
+  *time_us = ((h * 3600ULL + m * 60 + s) * 1000 + ms) * 1000;
+  return true;
+}
+
+bool CaptureReader::parse_line_(char *line, CaptureChunk *chunk) {
+  // Drop ANSI colour codes and the line end
+  char *out = line;
+  for (char *in = line; *in != '\0'; in++) {
+    if (*in == '\x1b' && in[1] == '[') {
+      in += 2;
+      while (*in != '\0' && !isalpha(static_cast<unsigned char>(*in)))
+        in++;
+      if (*in == '\0')
+        break;
+      continue;
+    }
+    if (*in != '\r' && *in != '\n')
+      *out++ = *in;
+  }
+  *out = '\0';
+
+  // Log prefix: "[12:34:56.789][D][uart_debug:114]: "
+  char *rest = line;
+  while (*rest == ' ')
+    rest++;
+  bool has_log_time = false;
+  uint64_t log_time = 0;
+  while (*rest == '[') {
+    char *end = strchr(rest, ']');
+    if (end == nullptr)
+      break;
+    if (!has_log_time && parse_clock(rest + 1, end - rest - 1, &log_time))
+      has_log_time = true;
+    rest = end + 1;
+  }
+  while (*rest == ':' || *rest == ' ')
+    rest++;
+
+  char *payload = rest;
+  bool has_direction = false;
+  bool tx = false;
+  bool has_capture_time = false;
+  uint32_t capture_time = 0;
+  char *marker;
+  if ((marker = strstr(rest, "<<<")) != nullptr || (marker = strstr(rest, ">>>")) != nullptr) {
+    // uart debug: seen from the ESP, so <<< is what the AC sent
+    has_direction = true;
+    tx = marker[0] == '>';
+    payload = marker + 3;
+  } else {
+    // dump_capture(): "<time us> RX|TX ok|bad <bytes>"
+    char *end;
+    unsigned long time = strtoul(rest, &end, 10);
+    if (end != rest && end[0] == ' ') {
+      while (*end == ' ')
+        end++;
+      if ((strncmp(end, "RX ", 3) == 0 || strncmp(end, "TX ", 3) == 0)) {
+        char *status = end + 3;
+        while (*status == ' ')
+          status++;
+        bool ok = strncmp(status, "ok ", 3) == 0;
+        if (ok || strncmp(status, "bad ", 4) == 0) {
+          has_direction = true;
+          tx = end[0] == 'T';
+          has_capture_time = true;
+          capture_time = static_cast<uint32_t>(time);
+          chunk->checksum_ok = ok ? 1 : 0;
+          payload = status + (ok ? 3 : 4);
+        }
+      }
+    }
+    // Bytes after a message: "Queueing packet: BB.00.01..."
+    if (!has_direction) {
+      char *colon = strstr(payload, ": ");
+      while (colon != nullptr) {
+        payload = colon + 2;
+        colon = strstr(payload, ": ");
+      }
+    }
+  }
+
+  // Other log lines may end in a number or two; data without a marker is a
+  // header's worth at least
+  if (!parse_hex(payload, &chunk->data) || (!has_direction && chunk->data.size() < 3)) {
+    chunk->data.clear();
+    chunk->checksum_ok = -1;
+    return false;
+  }
+  if (!has_direction) {
+    const std::vector<uint8_t> &d = chunk->data;
+    if (d.size() >= 3 && d[0] == HEADER_MCU_TO_AC_0 && d[1] == HEADER_MCU_TO_AC_1 && d[2] == HEADER_MCU_TO_AC_2) {
+      tx = true;
+    } else if (d.size() >= 3 && d[0] == HEADER_AC_TO_MCU_0 && d[1] == HEADER_AC_TO_MCU_1 &&
+               d[2] == HEADER_AC_TO_MCU_2) {
+      tx = false;
+    } else {
+      tx = this->last_tx_;
+    }
+  }
+  chunk->tx = tx;
+  this->last_tx_ = tx;
+
+  if (has_capture_time) {
+    this->set_time_(chunk, this->unwrap_(capture_time));
+  } else if (has_log_time) {
+    // Past midnight when the clock goes back by more than half a day
+    if (log_time + this->log_days_us_ + DAY_US / 2 < this->last_log_us_)
+      this->log_days_us_ += DAY_US;
+    this->last_log_us_ = log_time + this->log_days_us_;
+    this->set_time_(chunk, this->last_log_us_);
+  }
+  return true;
+}
+
+}  // namespace tcl_ac
+}  // namespace esphome
@@ -0,0 +1,107 @@
+#pragma once
+
+// Reads line traffic from a capture file, one chunk at a time, for the host
+// tools that replay or analyse it. Memory use does not grow with the file.
+//
+// Formats:
+//   binary      The component's frame capture (frame_capture.h): one chunk
+//               per record, with its time, direction and checksum status.
+//   text        Log lines, classified one by one:
+//                 - ESPHome `uart: debug` output: "<<< BB:01:00:..." is
+//                   received from the AC, ">>> ..." sent to it
+//                 - dump_capture() lines: "<time us> RX|TX ok|bad BB.01.00..."
+//                 - any other line that is nothing but hex bytes (three at
+//                   least) after its log prefix or message ("BB 01 00",
+//                   "0xBB,0x01,0x00", "Queueing packet: BB.00.01...");
+//                   frames starting with BB 00 01 are taken as sent to the
+//                   AC, others as continuing the previous direction
+//               Lines with a "[HH:MM:SS]" or "[HH:MM:SS.mmm]" prefix (esphome
+//               logs) carry that time. ANSI colour codes are ignored.
+//   raw         AC → MCU bytes as read from the UART, no time.
+//
+// `auto` picks binary for files starting with the capture magic, text
+// otherwise.
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace esphome {
+namespace tcl_ac {
+
+enum class CaptureFormat : uint8_t {
+  AUTO,
+  BINARY,
+  TEXT,
+  RAW,
+};
+
+const char *capture_format_name(CaptureFormat format);
+// False for an unknown name
+bool parse_capture_format(const char *name, CaptureFormat *format);
+
+// Bytes seen on the line in one direction
+struct CaptureChunk {
+  bool tx;                   // MCU → AC; AC → MCU otherwise
+  bool has_time;
+  uint64_t time_us;          // Capture clock, unwrapped; 0 = first timed chunk
+  int8_t checksum_ok;        // Binary and dump_capture(): 1 or 0; -1 = not recorded
+  bool truncated;            // Binary: the record holds only the start of the frame
+  std::vector<uint8_t> data;
+};
+
+class CaptureReader {
+ public:
+  ~CaptureReader();
+
+  // "-" reads stdin (text or raw only: binary is detected, but not seekable)
+  bool open(const char *path, CaptureFormat format = CaptureFormat::AUTO);
+  void close();
+  // The next chunk; false at the end of the file
+  bool next(CaptureChunk *chunk);
+
+  CaptureFormat get_format() const { return this->format_; }
+  const std::string &get_error() const { return this->error_; }
+  uint64_t get_lines() const { return this->lines_; }
+  // Text lines that held no line traffic
+  uint64_t get_skipped_lines() const { return this->skipped_lines_; }
+  uint64_t get_bytes() const { return this->bytes_; }
+  // Binary: records the device had already overwritten when it exported
+  uint32_t get_overwritten() const { return this->overwritten_; }
+
+ protected:
+  bool next_binary_(CaptureChunk *chunk);
+  bool next_text_(CaptureChunk *chunk);
+  bool next_raw_(CaptureChunk *chunk);
+  bool parse_line_(char *line, CaptureChunk *chunk);
+  // 32-bit capture clock to 64 bits: records may step back slightly, as a
+  // sent frame is stamped with the time its last byte leaves the wire
+  uint64_t unwrap_(uint32_t time_us);
+  void set_time_(CaptureChunk *chunk, uint64_t time_us);
+
+  FILE *file_{nullptr};
+  bool owns_file_{false};
+  CaptureFormat format_{CaptureFormat::AUTO};
+  std::string error_;
+  char *line_{nullptr};
+  size_t line_capacity_{0};
+  uint64_t lines_{0};
+  uint64_t skipped_lines_{0};
+  uint64_t bytes_{0};
+  uint32_t overwritten_{0};
+  size_t record_size_{0};
+  std::vector<uint8_t> record_;
+  bool last_tx_{false};
+
+  bool has_raw_time_{false};
+  uint32_t last_raw_us_{0};
+  uint64_t raw_time_us_{0};
+  bool has_base_{false};
+  uint64_t base_us_{0};
+  uint64_t last_log_us_{0};  // Log prefix time, for midnight wraps
+  uint64_t log_days_us_{0};
+};
+
+}  // namespace tcl_ac
+}  // namespace esphome
@@ -0,0 +1,437 @@
+// tcl_ac_mine: protocol statistics from a capture, in one pass. Frames are cut
+// out of the byte stream by the component's own framer (one per direction)
+// and counted per direction, command and length ("variant"):
+//
+//   - value histogram per frame offset: every value and how often it was seen
+//   - changes against the previous frame of the same variant: per offset, the
+//     bits that flipped and how often; per pair of payload offsets, how often
+//     they changed together (Jaccard index: both / either)
+//   - frame lengths per command, and what the framer dropped
+//
+// Memory depends on the variants seen, not on the file size. Exits with
+// status 1 if no frame was counted: the wrong --format, or filters that
+// match nothing.
+//
+//   tcl_ac_mine [options] FILE        FILE: capture file, "-" = stdin
+//
+// Options:
+//   --format F              auto, binary, text or raw (capture_reader.h;
+//                           default auto)
+//   --dir rx|tx|both        rx: AC → MCU, tx: MCU → AC (default both)
+//   --command N             Only this command, e.g. 0x03 (default all)
+//   --any-length            Accept any length for known commands too, so
+//                           frames with an unexpected length byte are not
+//                           dropped at their header
+//   --include-bad           Count frames with a bad checksum too
+//   --top N                 Values listed per offset (default 8; all in CSV)
+//   --min-corr J            Pairs listed from this Jaccard index on
+//                           (default 0.5)
+//   --min-count N           ... and changing together this often (default 3)
+//   --csv FILE              Every count as
+//                           kind,direction,command,length,offset,value,count:
+//                             value     offset, value: times seen
+//                             bitflip   offset, bit: times flipped
+//                             cochange  offset, other offset: times changed together
+//                             frames    -, -: frames of the variant
+//                           (offset = position in the frame, 5 = first
+//                           payload byte)
+//
+// Example: which bytes of the SET follow the target temperature (offset 31)
+//   tcl_ac_mine --dir tx --command 0x03 capture.log
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "capture_reader.h"
+#include "frame_reader.h"
+
+using namespace esphome::tcl_ac;
+
+namespace {
+
+// The largest buffer FrameReader takes: frames up to 255 bytes (payload up to
+// 249), longer ones are counted as overlong
+static const size_t MINE_BUFFER_SIZE = 256;
+
+struct Options {
+  const char *path{nullptr};
+  CaptureFormat format{CaptureFormat::AUTO};
+  bool rx{true};
+  bool tx{true};
+  int command{-1};
+  bool check_lengths{true};
+  bool include_bad{false};
+  size_t top{8};
+  double min_corr{0.5};
+  uint64_t min_count{3};
+  const char *csv{nullptr};
+};
+
+// Counts for one direction, command and length
+struct Variant {
+  explicit Variant(size_t size)
+      : size(size), values(size), flips(size), changes(size), co_changes(size * size), co_bits(size * size),
+        last(size) {}
+
+  size_t size;  // Frame size, header to checksum
+  uint64_t frames{0};
+  uint64_t compared{0};  // Frames with a previous one to compare against
+  std::vector<std::array<uint64_t, 256>> values;  // [offset][value]
+  std::vector<std::array<uint64_t, 8>> flips;     // [offset][bit]
+  std::vector<uint64_t> changes;                  // [offset]
+  std::vector<uint64_t> co_changes;               // [i * size + j], i < j
+  std::vector<uint8_t> co_bits;                   // [i * size + j]: bits of i that flipped while j changed too
+  std::vector<uint8_t> last;
+  std::vector<size_t> changed;  // Scratch: offsets that changed in this frame
+
+  void add(const uint8_t *raw) {
+    for (size_t i = 0; i < this->size; i++)
+      this->values[i][raw[i]]++;
+    if (this->frames++ > 0) {
+      this->compared++;
+      this->changed.clear();
+      for (size_t i = FRAME_HEADER_SIZE; i < this->size; i++) {
+        uint8_t flipped = raw[i] ^ this->last[i];
+        if (flipped == 0)
+          continue;
+        this->changes[i]++;
+        for (int bit = 0; bit < 8; bit++) {
+          if (flipped & (1 << bit))
+            this->flips[i][bit]++;
+        }
+        // The checksum changes with everything; it is left out of the pairs
+        if (i + 1 < this->size)
+          this->changed.push_back(i);
+      }
+      for (size_t a = 0; a < this->changed.size(); a++) {
+        size_t i = this->changed[a];
+        for (size_t b = a + 1; b < this->changed.size(); b++) {
+          size_t j = this->changed[b];
+          this->co_changes[i * this->size + j]++;
+          this->co_bits[i * this->size + j] |= raw[i] ^ this->last[i];
+          this->co_bits[j * this->size + i] |= raw[j] ^ this->last[j];
+        }
+      }
+    }
+    memcpy(this->last.data(), raw, this->size);
+  }
+};
+
+// Direction bit, command, length: sorts by direction, then command
+uint32_t variant_key(bool tx, uint8_t command, uint8_t length) {
+  return (tx ? 0x10000 : 0) | command << 8 | length;
+}
+
+const char *direction_name(bool tx) { return tx ? "MCU -> AC" : "AC -> MCU"; }
+
+class Miner {
+ public:
+  explicit Miner(const Options &options) : options_(options) {
+    this->rx_reader_.set_check_lengths(options.check_lengths);
+    this->tx_reader_.set_check_lengths(options.check_lengths);
+  }
+
+  void add(const CaptureChunk &chunk) {
+    if (chunk.truncated) {
+      this->truncated_++;
+      return;
+    }
+    if (chunk.tx) {
+      if (this->options_.tx)
+        this->feed_(&this->tx_reader_, true, chunk.data.data(), chunk.data.size());
+    } else if (this->options_.rx) {
+      this->feed_(&this->rx_reader_, false, chunk.data.data(), chunk.data.size());
+    }
+  }
+
+  void report(FILE *out) const {
+    // Frames and lengths per command
+    fprintf(out, "frames:\n");
+    uint32_t last_command = 0xFFFFFFFF;
+    for (auto &entry : this->variants_) {
+      uint32_t command = entry.first >> 8;
+      if (command != last_command) {
+        if (last_command != 0xFFFFFFFF)
+          fprintf(out, "\n");
+        uint64_t frames = 0;
+        for (auto &other : this->variants_) {
+          if (other.first >> 8 == command)
+            frames += other.second->frames;
+        }
+        fprintf(out, "  %s 0x%02X  %8llu frames  %5llu bad checksum  lengths:", direction_name(command >> 8),
+                command & 0xFF, static_cast<unsigned long long>(frames),
+                static_cast<unsigned long long>(this->bad_[command >> 8][command & 0xFF]));
+        last_command = command;
+      }
+      fprintf(out, " %u x%llu", entry.first & 0xFF, static_cast<unsigned long long>(entry.second->frames));
+    }
+    if (last_command != 0xFFFFFFFF)
+      fprintf(out, "\n");
+    // Bad frames of commands with no good frame are listed too
+    for (int tx = 0; tx < 2; tx++) {
+      for (int c = 0; c < 256; c++) {
+        if (this->bad_[tx][c] == 0)
+          continue;
+        auto it = this->variants_.lower_bound(variant_key(tx, c, 0));
+        if (it == this->variants_.end() || (it->first >> 8) != static_cast<uint32_t>(tx << 8 | c))
+          fprintf(out, "  %s 0x%02X  %8u frames  %5llu bad checksum\n", direction_name(tx), c, 0,
+                  static_cast<unsigned long long>(this->bad_[tx][c]));
+      }
+    }
+    this->report_framer_(out, "AC -> MCU", this->rx_reader_);
+    this->report_framer_(out, "MCU -> AC", this->tx_reader_);
+    if (this->truncated_ > 0)
+      fprintf(out, "  %llu truncated records skipped\n", static_cast<unsigned long long>(this->truncated_));
+
+    for (auto &entry : this->variants_)
+      this->report_variant_(out, entry.first, *entry.second);
+  }
+
+  bool write_csv(const char *path) const {
+    FILE *out = fopen(path, "w");
+    if (out == nullptr)
+      return false;
+    fprintf(out, "kind,direction,command,length,offset,value,count\n");
+    for (auto &entry : this->variants_) {
+      const Variant &v = *entry.second;
+      const char *dir = entry.first & 0x10000 ? "tx" : "rx";
+      unsigned command = (entry.first >> 8) & 0xFF;
+      unsigned length = entry.first & 0xFF;
+      fprintf(out, "frames,%s,0x%02X,%u,,,%llu\n", dir, command, length, static_cast<unsigned long long>(v.frames));
+      for (size_t i = 0; i < v.size; i++) {
+        for (int value = 0; value < 256; value++) {
+          if (v.values[i][value] != 0)
+            fprintf(out, "value,%s,0x%02X,%u,%zu,0x%02X,%llu\n", dir, command, length, i, value,
+                    static_cast<unsigned long long>(v.values[i][value]));
+        }
+      }
+      for (size_t i = 0; i < v.size; i++) {
+        for (int bit = 0; bit < 8; bit++) {
+          if (v.flips[i][bit] != 0)
+            fprintf(out, "bitflip,%s,0x%02X,%u,%zu,%d,%llu\n", dir, command, length, i, bit,
+                    static_cast<unsigned long long>(v.flips[i][bit]));
+        }
+      }
+      for (size_t i = 0; i < v.size; i++) {
+        for (size_t j = i + 1; j < v.size; j++) {
+          if (v.co_changes[i * v.size + j] != 0)
+            fprintf(out, "cochange,%s,0x%02X,%u,%zu,%zu,%llu\n", dir, command, length, i, j,
+                    static_cast<unsigned long long>(v.co_changes[i * v.size + j]));
+        }
+      }
+    }
+    return fclose(out) == 0;
+  }
+
+  uint64_t get_frames() const { return this->frames_; }
+
+ protected:
+  template<typename Reader> void feed_(Reader *reader, bool tx, const uint8_t *data, size_t length) {
+    // In pieces that fit, taking the frames out in between: push() would
+    // drop pending bytes once the buffer is full
+    while (length > 0) {
+      uint8_t *window;
+      size_t n = std::min(length, reader->write_window(&window));
+      memcpy(window, data, n);
+      reader->commit(n);
+      data += n;
+      length -= n;
+      Frame frame;
+      while (reader->next(&frame)) {
+        if (this->options_.command >= 0 && frame.command != this->options_.command)
+          continue;
+        if (!frame.checksum_ok()) {
+          this->bad_[tx][frame.command]++;
+          if (!this->options_.include_bad)
+            continue;
+        }
+        this->frames_++;
+        std::unique_ptr<Variant> &variant = this->variants_[variant_key(tx, frame.command, frame.length)];
+        if (!variant)
+          variant.reset(new Variant(frame.size()));
+        variant->add(frame.raw);
+      }
+      if (n == 0)
+        reader->abandon();  // Unreachable: a full buffer always holds a complete frame
+    }
+  }
+
+  template<typename Reader> void report_framer_(FILE *out, const char *direction, const Reader &reader) const {
+    if (reader.get_dropped_bytes() == 0 && reader.get_length_errors() == 0 && reader.get_overlong_frames() == 0)
+      return;
+    fprintf(out, "  %s framer: %u bytes skipped, %u headers with an unexpected length byte, %u overlong\n",
+            direction, reader.get_dropped_bytes(), reader.get_length_errors(), reader.get_overlong_frames());
+  }
+
+  void report_variant_(FILE *out, uint32_t key, const Variant &v) const {
+    bool tx = key & 0x10000;
+    fprintf(out, "\n== %s 0x%02X, %u-byte payload: %llu frames, %llu compared with the one before\n",
+            direction_name(tx), (key >> 8) & 0xFF, key & 0xFF, static_cast<unsigned long long>(v.frames),
+            static_cast<unsigned long long>(v.compared));
+    fprintf(out, " offset   data  changes  flips  distinct  values (times seen)\n");
+    std::vector<std::pair<uint64_t, int>> seen;
+    for (size_t i = FRAME_HEADER_SIZE; i < v.size; i++) {
+      seen.clear();
+      for (int value = 0; value < 256; value++) {
+        if (v.values[i][value] != 0)
+          seen.emplace_back(v.values[i][value], value);
+      }
+      // Most frequent first, then by value
+      std::sort(seen.begin(), seen.end(), [](const std::pair<uint64_t, int> &a, const std::pair<uint64_t, int> &b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+      });
+      uint8_t flipped = 0;
+      for (int bit = 0; bit < 8; bit++) {
+        if (v.flips[i][bit] != 0)
+          flipped |= 1 << bit;
+      }
+      // A run of payload bytes holding the same constant is one row
+      size_t last = i;
+      if (seen.size() == 1) {
+        while (last + 2 < v.size && v.values[last + 1][seen[0].second] == v.frames)
+          last++;
+      }
+      char offset[48];
+      char data[48];
+      if (i + 1 == v.size) {
+        snprintf(offset, sizeof(offset), "%zu", i);
+        snprintf(data, sizeof(data), "cs");
+      } else if (last > i) {
+        snprintf(offset, sizeof(offset), "%zu-%zu", i, last);
+        snprintf(data, sizeof(data), "%zu-%zu", i - FRAME_HEADER_SIZE, last - FRAME_HEADER_SIZE);
+      } else {
+        snprintf(offset, sizeof(offset), "%zu", i);
+        snprintf(data, sizeof(data), "%zu", i - FRAME_HEADER_SIZE);
+      }
+      fprintf(out, "%7s  %5s  %7llu   0x%02X  %8zu ", offset, data, static_cast<unsigned long long>(v.changes[i]),
+              flipped, seen.size());
+      for (size_t k = 0; k < seen.size() && k < this->options_.top; k++)
+        fprintf(out, " 0x%02X %llu", seen[k].second, static_cast<unsigned long long>(seen[k].first));
+      if (seen.size() > this->options_.top)
+        fprintf(out, "  +%zu more", seen.size() - this->options_.top);
+      fprintf(out, "\n");
+      i = last;
+    }
+
+    // Offsets changing together, strongest first
+    struct Pair {
+      size_t i, j;
+      uint64_t both;
+      double jaccard;
+    };
+    std::vector<Pair> pairs;
+    for (size_t i = FRAME_HEADER_SIZE; i + 1 < v.size; i++) {
+      for (size_t j = i + 1; j + 1 < v.size; j++) {
+        uint64_t both = v.co_changes[i * v.size + j];
+        if (both == 0 || both < this->options_.min_count)
+          continue;
+        double jaccard = static_cast<double>(both) / (v.changes[i] + v.changes[j] - both);
+        if (jaccard >= this->options_.min_corr)
+          pairs.push_back({i, j, both, jaccard});
+      }
+    }
+    if (pairs.empty())
+      return;
+    std::sort(pairs.begin(), pairs.end(), [](const Pair &a, const Pair &b) {
+      return a.jaccard != b.jaccard ? a.jaccard > b.jaccard : a.both > b.both;
+    });
+    fprintf(out, "changing together (jaccard >= %.2f, %llu times at least; bits = those flipped in the pair):\n",
+            this->options_.min_corr, static_cast<unsigned long long>(this->options_.min_count));
+    for (const Pair &p : pairs) {
+      fprintf(out, "  %3zu (bits 0x%02X) + %3zu (bits 0x%02X)  %6llu of %llu / %llu  %.2f\n", p.i,
+              v.co_bits[p.i * v.size + p.j], p.j, v.co_bits[p.j * v.size + p.i],
+              static_cast<unsigned long long>(p.both), static_cast<unsigned long long>(v.changes[p.i]),
+              static_cast<unsigned long long>(v.changes[p.j]), p.jaccard);
+    }
+  }
+
+  const Options &options_;
+  FrameReader<MINE_BUFFER_SIZE> rx_reader_;
+  FrameReader<MINE_BUFFER_SIZE, HEADER_MCU_TO_AC_1, HEADER_MCU_TO_AC_2> tx_reader_;
+  std::map<uint32_t, std::unique_ptr<Variant>> variants_;
+  uint64_t bad_[2][256]{};
+  uint64_t frames_{0};
+  uint64_t truncated_{0};
+};
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    auto arg = [&](const char *name) { return strcmp(argv[i], name) == 0 && i + 1 < argc; };
+    if (arg("--format")) {
+      if (!parse_capture_format(argv[++i], &options.format)) {
+        fprintf(stderr, "unknown format: %s\n", argv[i]);
+        return 2;
+      }
+    } else if (arg("--dir")) {
+      i++;
+      options.rx = strcmp(argv[i], "tx") != 0;
+      options.tx = strcmp(argv[i], "rx") != 0;
+      if (strcmp(argv[i], "rx") != 0 && strcmp(argv[i], "tx") != 0 && strcmp(argv[i], "both") != 0) {
+        fprintf(stderr, "unknown direction: %s\n", argv[i]);
+        return 2;
+      }
+    } else if (arg("--command")) {
+      options.command = static_cast<int>(strtoul(argv[++i], nullptr, 0) & 0xFF);
+    } else if (strcmp(argv[i], "--any-length") == 0) {
+      options.check_lengths = false;
+    } else if (strcmp(argv[i], "--include-bad") == 0) {
+      options.include_bad = true;
+    } else if (arg("--top")) {
+      options.top = static_cast<size_t>(std::max(0, atoi(argv[++i])));
+    } else if (arg("--min-corr")) {
+      options.min_corr = atof(argv[++i]);
+    } else if (arg("--min-count")) {
+      options.min_count = std::max(1, atoi(argv[++i]));
+    } else if (arg("--csv")) {
+      options.csv = argv[++i];
+    } else if (argv[i][0] == '-' && argv[i][1] != '\0') {
+      fprintf(stderr, "unknown option: %s\n", argv[i]);
+      return 2;
+    } else {
+      options.path = argv[i];
+    }
+  }
+  if (options.path == nullptr) {
+    fprintf(stderr, "usage: %s [--format auto|binary|text|raw] [--dir rx|tx|both] [--command N] [--any-length] "
+            "[--include-bad] [--top N] [--min-corr J] [--min-count N] [--csv FILE] FILE\n", argv[0]);
+    return 2;
+  }
+
+  CaptureReader reader;
+  if (!reader.open(options.path, options.format)) {
+    fprintf(stderr, "%s\n", reader.get_error().c_str());
+    return 1;
+  }
+  Miner miner(options);
+  auto start = std::chrono::steady_clock::now();
+  CaptureChunk chunk;
+  while (reader.next(&chunk))
+    miner.add(chunk);
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  printf("input: %s, %s, %llu bytes of line traffic", options.path, capture_format_name(reader.get_format()),
+         static_cast<unsigned long long>(reader.get_bytes()));
+  if (reader.get_format() == CaptureFormat::TEXT)
+    printf(" in %llu lines", static_cast<unsigned long long>(reader.get_lines()));
+  printf("; %llu frames counted in %.3f s\n", static_cast<unsigned long long>(miner.get_frames()), seconds);
+  miner.report(stdout);
+  if (options.csv != nullptr && !miner.write_csv(options.csv)) {
+    fprintf(stderr, "%s: cannot write\n", options.csv);
+    return 1;
+  }
+  if (miner.get_frames() == 0) {
+    fprintf(stderr, "no frames counted\n");
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,574 @@
+// tcl_ac_replay: feeds a recorded capture through TclAcClimate (framer,
+// decoders, state handling) and reports frame rate, decode errors and the
+// state timeline the component publishes.
+//
+//   tcl_ac_replay [options] FILE     FILE: capture file, "-" = stdin
+//
+// Options:
+//   --format F              auto, binary, text or raw (capture_reader.h;
+//                           default auto)
+//   --time virtual|fast     virtual: bytes arrive at their recorded times and
+//                           loop() runs every --loop-interval on virtual time,
+//                           so timeouts and rate limits behave as on the
+//                           device (default). fast: bytes are handed over as
+//                           fast as loop() takes them, on the real clock
+//   --loop-interval MS      ESPHome main loop period, virtual time (default 16)
+//   --repeat N              Replay the file N times (fast; default 1), for a
+//                           stable frames/s
+//   -q                      No timeline, summary only
+//   -v                      Component debug logging to stderr
+//   --strict                Exit with status 1 on any decode error: bad
+//                           checksum, unknown command, frame dropped by the
+//                           framer or truncated in the capture
+//   --save-timeline FILE    Write the timeline to FILE
+//   --expect FILE           Exit with status 1 unless the timeline matches
+//                           FILE (from --save-timeline) line for line
+//
+// The timeline lists every state the component publishes and every SET the
+// MCU sent in the capture, with the capture time in seconds. Frames the
+// component sends itself (polls) go nowhere: the capture already holds what
+// the MCU sent. With --time fast the publish rate limit runs on the real
+// clock, so changes in quick succession are published as one.
+//
+// --save-timeline and --expect turn a capture into a regression check: a
+// change to the decoders or the state handling that publishes something
+// else, or at another time, shows up as the first line that differs.
+
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "capture_reader.h"
+#include "esphome/core/log.h"
+#include "tcl_ac.h"
+
+using namespace esphome;
+using namespace esphome::tcl_ac;
+
+namespace {
+
+enum class TimeMode {
+  VIRTUAL,
+  FAST,
+};
+
+struct Options {
+  const char *path{nullptr};
+  CaptureFormat format{CaptureFormat::AUTO};
+  TimeMode time{TimeMode::VIRTUAL};
+  uint32_t loop_interval_ms{16};
+  int repeat{1};
+  bool timeline{true};
+  bool strict{false};
+  const char *save_timeline{nullptr};
+  const char *expect{nullptr};
+};
+
+// UART input fed chunk by chunk from the capture; the component's own writes
+// are counted and dropped
+class ReplayUART : public uart::UARTComponent {
+ public:
+  void feed(const uint8_t *data, size_t length) {
+    if (this->pos_ > 0 && this->pos_ == this->buffer_.size()) {
+      this->buffer_.clear();
+      this->pos_ = 0;
+    }
+    this->buffer_.insert(this->buffer_.end(), data, data + length);
+  }
+  size_t pending() const { return this->buffer_.size() - this->pos_; }
+  uint64_t get_written() const { return this->written_; }
+
+  void write_array(const uint8_t *, size_t len) override { this->written_ += len; }
+  bool peek_byte(uint8_t *data) override {
+    if (this->pending() == 0)
+      return false;
+    *data = this->buffer_[this->pos_];
+    return true;
+  }
+  bool read_array(uint8_t *data, size_t len) override {
+    if (this->pending() < len)
+      return false;
+    memcpy(data, this->buffer_.data() + this->pos_, len);
+    this->pos_ += len;
+    return true;
+  }
+  int available() override { return static_cast<int>(this->pending()); }
+  void flush() override {}
+
+ protected:
+  std::vector<uint8_t> buffer_;
+  size_t pos_{0};
+  uint64_t written_{0};
+};
+
+// TclAcClimate with every frame loop() hands it seen first
+class ReplayClimate : public TclAcClimate {
+ public:
+  // Call after setup()
+  void observe_frames(std::function<void(const Frame &)> &&observer) {
+    this->observer_ = std::move(observer);
+    this->link_.set_frame_callback([this](const Frame &frame) {
+      this->observer_(frame);
+      this->handle_frame_(frame);
+    });
+  }
+  const FrameReader<RX_BUFFER_SIZE> &get_reader() const { return this->link_.get_reader(); }
+  uint32_t get_rx_gap_timeouts() const { return this->link_.get_rx_gap_timeouts(); }
+
+ protected:
+  std::function<void(const Frame &)> observer_;
+};
+
+struct Stats {
+  uint32_t rx_chunks{0};
+  uint32_t tx_chunks{0};
+  uint64_t rx_bytes{0};
+  uint64_t tx_bytes{0};
+  uint32_t truncated{0};  // Binary records skipped: only the start of the frame was kept
+  uint32_t rx_frames[256]{};
+  uint32_t rx_total{0};
+  uint32_t checksum_errors{0};
+  uint32_t unknown_commands{0};
+  uint32_t tx_frames[256]{};
+  uint32_t tx_total{0};
+  uint32_t tx_checksum_errors{0};
+  uint32_t publishes{0};
+  uint64_t loops{0};
+  double loop_ns{0};      // Time spent in loop()
+  uint64_t capture_us{0};  // Capture time covered
+};
+
+bool known_command(uint8_t command) {
+  switch (command) {
+    case CMD_SET_PARAMS:
+    case CMD_POLL:
+    case CMD_TEMP_RESPONSE:
+    case CMD_STATUS_ECHO:
+    case CMD_SHORT_STATUS:
+    case CMD_POWER:
+      return true;
+    default:
+      return false;
+  }
+}
+
+const char *mode_name(climate::ClimateMode mode) {
+  switch (mode) {
+    case climate::CLIMATE_MODE_OFF:
+      return "off";
+    case climate::CLIMATE_MODE_HEAT_COOL:
+      return "heat_cool";
+    case climate::CLIMATE_MODE_COOL:
+      return "cool";
+    case climate::CLIMATE_MODE_HEAT:
+      return "heat";
+    case climate::CLIMATE_MODE_FAN_ONLY:
+      return "fan_only";
+    case climate::CLIMATE_MODE_DRY:
+      return "dry";
+    case climate::CLIMATE_MODE_AUTO:
+      return "auto";
+  }
+  return "?";
+}
+
+const char *fan_name(climate::ClimateFanMode fan) {
+  switch (fan) {
+    case climate::CLIMATE_FAN_AUTO:
+      return "auto";
+    case climate::CLIMATE_FAN_LOW:
+      return "low";
+    case climate::CLIMATE_FAN_MEDIUM:
+      return "medium";
+    case climate::CLIMATE_FAN_HIGH:
+      return "high";
+    case climate::CLIMATE_FAN_MIDDLE:
+      return "middle";
+    case climate::CLIMATE_FAN_FOCUS:
+      return "focus";
+    case climate::CLIMATE_FAN_DIFFUSE:
+      return "diffuse";
+    case climate::CLIMATE_FAN_QUIET:
+      return "quiet";
+    default:
+      return "?";
+  }
+}
+
+const char *swing_name(climate::ClimateSwingMode swing) {
+  switch (swing) {
+    case climate::CLIMATE_SWING_OFF:
+      return "off";
+    case climate::CLIMATE_SWING_BOTH:
+      return "both";
+    case climate::CLIMATE_SWING_VERTICAL:
+      return "vertical";
+    case climate::CLIMATE_SWING_HORIZONTAL:
+      return "horizontal";
+  }
+  return "?";
+}
+
+const char *preset_name(climate::ClimatePreset preset) {
+  switch (preset) {
+    case climate::CLIMATE_PRESET_NONE:
+      return "none";
+    case climate::CLIMATE_PRESET_ECO:
+      return "eco";
+    case climate::CLIMATE_PRESET_BOOST:
+      return "boost";
+    case climate::CLIMATE_PRESET_SLEEP:
+      return "sleep";
+    case climate::CLIMATE_PRESET_COMFORT:
+      return "comfort";
+    default:
+      return "?";
+  }
+}
+
+// Timeline lines, without the newline
+std::string format_state(double seconds, const TclAcClimate &ac) {
+  char room[16] = "  --  ";
+  if (!std::isnan(ac.current_temperature))
+    snprintf(room, sizeof(room), "%4.1f°C", ac.current_temperature);
+  char line[160];
+  snprintf(line, sizeof(line), "%12.3f  state  %-8s %4.1f°C  room %s  fan %-6s swing %-10s preset %-5s display %s",
+           seconds, mode_name(ac.mode), ac.target_temperature, room,
+           fan_name(ac.fan_mode.value_or(climate::CLIMATE_FAN_AUTO)), swing_name(ac.swing_mode),
+           preset_name(ac.preset.value_or(climate::CLIMATE_PRESET_NONE)), ac.get_display_state() ? "on" : "off");
+  return line;
+}
+
+std::string format_set(double seconds, const Frame &frame) {
+  char line[160];
+  AcSettings s;
+  if (!decode_settings(frame.payload, frame.length, &s)) {
+    snprintf(line, sizeof(line), "%12.3f  SET    (%u-byte payload, not decoded)", seconds, frame.length);
+    return line;
+  }
+  snprintf(line, sizeof(line),
+           "%12.3f  SET    %-8s %4.1f°C                fan %-6s swing %-10s preset %-5s display %s%s%s%s%s", seconds,
+           mode_name(s.mode), s.target_temperature, fan_name(s.fan_mode), swing_name(s.swing_mode),
+           preset_name(s.preset), s.display_state ? "on" : "off", s.eco_mode ? " eco" : "",
+           s.turbo_mode ? " turbo" : "", s.quiet_mode ? " quiet" : "", s.health_mode ? " health" : "");
+  return line;
+}
+
+class Replay {
+ public:
+  explicit Replay(const Options &options) : options_(options) {}
+
+  // One pass over the file
+  bool run(bool first) {
+    CaptureReader reader;
+    if (!reader.open(this->options_.path, this->options_.format)) {
+      fprintf(stderr, "%s\n", reader.get_error().c_str());
+      return false;
+    }
+    if (first) {
+      this->setup_();
+      if (this->options_.timeline)
+        printf("timeline (s):\n");
+    }
+    CaptureChunk chunk;
+    uint64_t rx_free_us = 0;  // When the previous chunk in each direction is through at the line rate
+    uint64_t tx_free_us = 0;
+    while (reader.next(&chunk)) {
+      uint64_t &free_us = chunk.tx ? tx_free_us : rx_free_us;
+      uint64_t at = std::max(chunk.has_time ? chunk.time_us : 0, free_us);
+      free_us = at + chunk.data.size() * UART_BYTE_TIME_US;
+      if (this->options_.time == TimeMode::VIRTUAL)
+        this->run_until_(at);
+      this->capture_us_ = at;
+      this->deliver_(chunk);
+    }
+    // Whatever the last bytes started: confirmations, publishes held back
+    if (this->options_.time == TimeMode::VIRTUAL)
+      this->run_until_(this->capture_us_ + 2000000);
+    this->stats_.capture_us = this->capture_us_;
+    this->reader_lines_ += reader.get_lines();
+    this->reader_skipped_ += reader.get_skipped_lines();
+    this->reader_bytes_ += reader.get_bytes();
+    this->overwritten_ = reader.get_overwritten();
+    this->format_ = reader.get_format();
+    return true;
+  }
+
+  void report(double wall_seconds) const {
+    const Stats &s = this->stats_;
+    printf("input:     %s, %s: %u RX / %u TX chunks, %llu bytes", this->options_.path,
+           capture_format_name(this->format_), s.rx_chunks, s.tx_chunks,
+           static_cast<unsigned long long>(this->reader_bytes_));
+    if (this->format_ == CaptureFormat::TEXT)
+      printf(", %llu lines (%llu without line traffic)", static_cast<unsigned long long>(this->reader_lines_),
+             static_cast<unsigned long long>(this->reader_skipped_));
+    if (this->format_ == CaptureFormat::BINARY)
+      printf(", %u records overwritten on the device, %u truncated", this->overwritten_, s.truncated);
+    printf("\n");
+    if (this->options_.time == TimeMode::VIRTUAL) {
+      printf("time:      virtual, %.1f s of capture in %.3f s (loop() every %u ms, %llu calls)\n",
+             s.capture_us / 1e6, wall_seconds, this->options_.loop_interval_ms,
+             static_cast<unsigned long long>(s.loops));
+    } else {
+      printf("time:      fast, %d pass(es) in %.3f s, %.1f MB/s of input\n", this->options_.repeat, wall_seconds,
+             this->reader_bytes_ / 1e6 / wall_seconds);
+    }
+    printf("RX frames: %u handled:", s.rx_total);
+    for (int c = 0; c < 256; c++) {
+      if (s.rx_frames[c] != 0)
+        printf(" 0x%02X %u", c, s.rx_frames[c]);
+    }
+    printf("\n");
+    const FrameReader<RX_BUFFER_SIZE> &framer = this->ac_.get_reader();
+    printf("errors:    %u bad checksum, %u unknown command; framer: %u wrong length, %u overlong, %u incomplete "
+           "after a gap, %u bytes skipped\n",
+           s.checksum_errors, s.unknown_commands, framer.get_length_errors(), framer.get_overlong_frames(),
+           this->ac_.get_rx_gap_timeouts(), framer.get_dropped_bytes());
+    printf("TX frames: %u in the capture:", s.tx_total);
+    for (int c = 0; c < 256; c++) {
+      if (s.tx_frames[c] != 0)
+        printf(" 0x%02X %u", c, s.tx_frames[c]);
+    }
+    printf(", %u bad checksum\n", s.tx_checksum_errors);
+    printf("decode:    %.0f frames/s in loop() (%.0f ns/frame over %llu calls), %.0f frames/s end to end\n",
+           s.rx_total / (s.loop_ns / 1e9), s.loop_ns / std::max<uint32_t>(s.rx_total, 1),
+           static_cast<unsigned long long>(s.loops), s.rx_total / wall_seconds);
+    printf("state:     %u publishes, %u frames memoized, short status %s\n", s.publishes,
+           this->ac_.get_frames_memoized(), this->ac_.is_short_status_trusted() ? "trusted" : "not trusted");
+  }
+
+  // What --strict fails on
+  uint32_t decode_errors() const {
+    const Stats &s = this->stats_;
+    const FrameReader<RX_BUFFER_SIZE> &framer = this->ac_.get_reader();
+    return s.checksum_errors + s.unknown_commands + s.tx_checksum_errors + s.truncated + framer.get_length_errors() +
+           framer.get_overlong_frames() + this->ac_.get_rx_gap_timeouts();
+  }
+  const std::vector<std::string> &get_timeline() const { return this->timeline_; }
+
+ protected:
+  void setup_() {
+    this->ac_.set_uart_parent(&this->uart_);
+    this->ac_.setup();
+    this->ac_.observe_frames([this](const Frame &frame) {
+      this->stats_.rx_total++;
+      this->stats_.rx_frames[frame.command]++;
+      if (!frame.checksum_ok()) {
+        this->stats_.checksum_errors++;
+      } else if (!known_command(frame.command)) {
+        this->stats_.unknown_commands++;
+      }
+    });
+    this->ac_.add_on_state_callback([this](climate::Climate &) {
+      this->stats_.publishes++;
+      this->add_timeline_(format_state(this->capture_us_ / 1e6, this->ac_));
+    });
+  }
+
+  void add_timeline_(std::string &&line) {
+    if (this->options_.timeline)
+      printf("%s\n", line.c_str());
+    this->timeline_.push_back(std::move(line));
+  }
+
+  void deliver_(const CaptureChunk &chunk) {
+    if (chunk.truncated) {
+      this->stats_.truncated++;
+      return;
+    }
+    if (chunk.tx) {
+      this->stats_.tx_chunks++;
+      this->stats_.tx_bytes += chunk.data.size();
+      this->tx_reader_.push(chunk.data.data(), chunk.data.size());
+      Frame frame;
+      while (this->tx_reader_.next(&frame)) {
+        this->stats_.tx_total++;
+        this->stats_.tx_frames[frame.command]++;
+        if (!frame.checksum_ok()) {
+          this->stats_.tx_checksum_errors++;
+        } else if (frame.command == CMD_SET_PARAMS) {
+          this->add_timeline_(format_set(this->capture_us_ / 1e6, frame));
+        }
+      }
+      return;
+    }
+    this->stats_.rx_chunks++;
+    this->stats_.rx_bytes += chunk.data.size();
+    this->uart_.feed(chunk.data.data(), chunk.data.size());
+    // Fast: everything fed is taken up now (over several calls past the
+    // receive budget); virtual: by the loop() calls due
+    if (this->options_.time == TimeMode::FAST) {
+      while (this->uart_.pending() > 0)
+        this->loop_();
+      this->loop_();
+    }
+  }
+
+  void loop_() {
+    auto start = std::chrono::steady_clock::now();
+    this->ac_.loop();
+    this->stats_.loop_ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    this->stats_.loops++;
+  }
+
+  // Main loop passes on virtual time up to `until_us`, as Application::loop()
+  // runs them: scheduler, then loop() unless it is parked
+  void run_until_(uint64_t until_us) {
+    const uint64_t interval = this->options_.loop_interval_ms * 1000ULL;
+    while (this->next_loop_us_ <= until_us) {
+      // Parked: nothing happens before the next timeout or the next chunk
+      if (!this->ac_.is_loop_enabled()) {
+        uint64_t wake = std::min(host::next_timeout_us(), until_us);
+        if (wake > this->next_loop_us_)
+          this->next_loop_us_ += (wake - this->next_loop_us_) / interval * interval;
+      }
+      if (host::now_us() < this->next_loop_us_)
+        host::advance_us(this->next_loop_us_ - host::now_us());
+      this->capture_us_ = host::now_us();
+      host::run_scheduler();
+      if (this->ac_.is_loop_enabled())
+        this->loop_();
+      else
+        host::call_loop(&this->ac_);  // Takes up a pending enable_loop_soon_any_context()
+      this->next_loop_us_ += interval;
+    }
+    if (host::now_us() < until_us)
+      host::advance_us(until_us - host::now_us());
+  }
+
+  const Options &options_;
+  ReplayUART uart_;
+  ReplayClimate ac_;
+  FrameReader<RX_BUFFER_SIZE, HEADER_MCU_TO_AC_1, HEADER_MCU_TO_AC_2> tx_reader_;
+  Stats stats_;
+  std::vector<std::string> timeline_;
+  uint64_t capture_us_{0};
+  uint64_t next_loop_us_{0};
+  uint64_t reader_lines_{0};
+  uint64_t reader_skipped_{0};
+  uint64_t reader_bytes_{0};
+  uint32_t overwritten_{0};
+  CaptureFormat format_{CaptureFormat::AUTO};
+};
+
+// Status 1 with the first difference on stderr unless `timeline` is what
+// `path` holds
+bool check_timeline(const std::vector<std::string> &timeline, const char *path) {
+  std::ifstream file(path);
+  if (!file) {
+    fprintf(stderr, "%s: %s\n", path, strerror(errno));
+    return false;
+  }
+  std::string expected;
+  size_t line = 0;
+  for (; std::getline(file, expected); line++) {
+    if (line == timeline.size()) {
+      fprintf(stderr, "timeline ends at line %zu, %s continues:\n  expected: %s\n", line + 1, path,
+              expected.c_str());
+      return false;
+    }
+    if (timeline[line] != expected) {
+      fprintf(stderr, "timeline differs from %s at line %zu:\n  expected: %s\n  replayed: %s\n", path, line + 1,
+              expected.c_str(), timeline[line].c_str());
+      return false;
+    }
+  }
+  if (line < timeline.size()) {
+    fprintf(stderr, "timeline goes on past the end of %s, at line %zu:\n  replayed: %s\n", path, line + 1,
+            timeline[line].c_str());
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    auto arg = [&](const char *name) { return strcmp(argv[i], name) == 0 && i + 1 < argc; };
+    if (arg("--format")) {
+      if (!parse_capture_format(argv[++i], &options.format)) {
+        fprintf(stderr, "unknown format: %s\n", argv[i]);
+        return 2;
+      }
+    } else if (arg("--time")) {
+      i++;
+      if (strcmp(argv[i], "virtual") == 0) {
+        options.time = TimeMode::VIRTUAL;
+      } else if (strcmp(argv[i], "fast") == 0) {
+        options.time = TimeMode::FAST;
+      } else {
+        fprintf(stderr, "unknown time mode: %s\n", argv[i]);
+        return 2;
+      }
+    } else if (arg("--loop-interval")) {
+      options.loop_interval_ms = std::max(1, atoi(argv[++i]));
+    } else if (arg("--repeat")) {
+      options.repeat = std::max(1, atoi(argv[++i]));
+    } else if (strcmp(argv[i], "-q") == 0) {
+      options.timeline = false;
+    } else if (strcmp(argv[i], "-v") == 0) {
+      host::log_level = ESPHOME_LOG_LEVEL_DEBUG;
+    } else if (strcmp(argv[i], "--strict") == 0) {
+      options.strict = true;
+    } else if (arg("--save-timeline")) {
+      options.save_timeline = argv[++i];
+    } else if (arg("--expect")) {
+      options.expect = argv[++i];
+    } else if (argv[i][0] == '-' && argv[i][1] != '\0') {
+      fprintf(stderr, "unknown option: %s\n", argv[i]);
+      return 2;
+    } else {
+      options.path = argv[i];
+    }
+  }
+  if (options.path == nullptr) {
+    fprintf(stderr, "usage: %s [--format auto|binary|text|raw] [--time virtual|fast] [--loop-interval MS] "
+            "[--repeat N] [-q] [-v] [--strict] [--save-timeline FILE] [--expect FILE] FILE\n", argv[0]);
+    return 2;
+  }
+  if (options.time == TimeMode::VIRTUAL) {
+    host::use_virtual_clock(0);
+    options.repeat = 1;  // A second pass would start the capture clock over
+  } else {
+    host::use_real_clock();
+  }
+
+  Replay replay(options);
+  auto start = std::chrono::steady_clock::now();
+  for (int pass = 0; pass < options.repeat; pass++) {
+    if (!replay.run(pass == 0))
+      return 1;
+  }
+  double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  if (options.timeline)
+    printf("\n");
+  replay.report(wall);
+  
+  if (options.save_timeline != nullptr) {
+    FILE *file = fopen(options.save_timeline, "w");
+    if (file == nullptr) {
+      fprintf(stderr, "%s: %s\n", options.save_timeline, strerror(errno));
+      return 1;
+    }
+    for (const std::string &line : replay.get_timeline())
+      fprintf(file, "%s\n", line.c_str());
+    fclose(file);
+  }
+  bool ok = true;
+  if (options.strict && replay.decode_errors() != 0) {
+    fprintf(stderr, "%u decode error(s)\n", replay.decode_errors());
+    ok = false;
+  }
+  if (options.expect != nullptr && !check_timeline(replay.get_timeline(), options.expect))
+    ok = false;
+  return ok ? 0 : 1;
+}